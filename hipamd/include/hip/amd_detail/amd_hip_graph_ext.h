@@ -0,0 +1,99 @@
+/*
+Copyright (c) 2026 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef HIP_INCLUDE_HIP_AMD_DETAIL_AMD_HIP_GRAPH_EXT_H
+#define HIP_INCLUDE_HIP_AMD_DETAIL_AMD_HIP_GRAPH_EXT_H
+
+/**
+ *
+ * @addtogroup GlobalDefs
+ * @{
+ *
+ */
+
+/**
+ * AMD extensions of the graph instantiate flags. The extensions are accepted by
+ * hipGraphInstantiateWithFlags and hipGraphInstantiateWithParams and can be combined with any
+ * value of hipGraphInstantiateFlags.
+ */
+
+/**
+ * Assigns the graph nodes to the parallel streams with the critical path scheduler instead of
+ * the round robin one. The scheduler estimates the cost of every node and starts the longest
+ * path first on the stream with the earliest start. The same is enabled for all graphs with
+ * DEBUG_HIP_GRAPH_CRITICAL_PATH_SCHEDULE=1.
+ */
+#define hipExtGraphInstantiateFlagCriticalPath 0x100000000ull
+
+/**
+ * Tracks the graph launches by the last command of the launch instead of a host callback and
+ * a blocking marker, which saves two commands and a callback per hipGraphLaunch.
+ * hipGraphExecDestroy doesn't wait for the launches in progress, the runtime releases the
+ * executable graph after they are done. The same is enabled for all graphs with
+ * DEBUG_HIP_GRAPH_LAUNCH_FAST_PATH=1.
+ */
+#define hipExtGraphInstantiateFlagLaunchFastPath 0x200000000ull
+
+/**
+ * @}
+ */
+
+/**
+ *
+ * @addtogroup Graph
+ * @{
+ *
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Launches an executable graph several times with one call.
+ *
+ * Before the launch i, the parameters nodeParams[i * numNodes + j] are applied to the kernel
+ * node nodes[j] with the semantics of hipGraphExecKernelNodeSetParams. The launches of the
+ * captured single stream graphs are submitted together and ring the queue doorbell once.
+ * Other graphs are updated and launched one by one.
+ *
+ * @param [in] graphExec - Executable graph to launch.
+ * @param [in] stream - Stream of the launches.
+ * @param [in] numLaunches - Number of the launches.
+ * @param [in] nodes - Kernel nodes of the original graph, which are updated before every launch.
+ * @param [in] nodeParams - Parameters of the nodes, numNodes per launch.
+ * @param [in] numNodes - Number of the updated nodes, can be 0.
+ * @returns #hipSuccess, #hipErrorInvalidValue, #hipErrorContextIsDestroyed
+ */
+hipError_t hipExtGraphLaunchBatch(hipGraphExec_t graphExec, hipStream_t stream,
+                                  unsigned int numLaunches, const hipGraphNode_t* nodes,
+                                  const hipKernelNodeParams* nodeParams, unsigned int numNodes);
+
+#ifdef __cplusplus
+} /* extern "c" */
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* HIP_INCLUDE_HIP_AMD_DETAIL_AMD_HIP_GRAPH_EXT_H */
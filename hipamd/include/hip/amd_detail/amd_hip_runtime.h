@@ -245,6 +245,7 @@ void hipLaunchKernelGGL(F kernel, const dim3& numBlocks, const dim3& dimBlocks,
 #endif
 
 #include <hip/hip_runtime_api.h>
+#include <hip/amd_detail/amd_hip_graph_ext.h>
 #endif // !defined(__HIPCC_RTC__)
 
 #if defined(__HIPCC_RTC__)
@@ -61,7 +61,7 @@
 // - Reset any of the *_STEP_VERSION defines to zero if the corresponding *_MAJOR_VERSION increases
 #define HIP_API_TABLE_STEP_VERSION 0
 #define HIP_COMPILER_API_TABLE_STEP_VERSION 0
-#define HIP_RUNTIME_API_TABLE_STEP_VERSION 6
+#define HIP_RUNTIME_API_TABLE_STEP_VERSION 7
 
 // HIP API interface
 typedef hipError_t (*t___hipPopCallConfiguration)(dim3* gridDim, dim3* blockDim, size_t* sharedMem,
@@ -1004,6 +1004,12 @@ typedef hipError_t (*t_hipExtHostAlloc)(void **ptr, size_t size,
 typedef hipError_t (*t_hipDeviceGetTexture1DLinearMaxWidth)(size_t *maxWidthInElements,
                                                             const hipChannelFormatDesc *fmtDesc,
                                                             int device);
+
+typedef hipError_t (*t_hipExtGraphLaunchBatch)(hipGraphExec_t graphExec, hipStream_t stream,
+                                               unsigned int numLaunches,
+                                               const hipGraphNode_t* nodes,
+                                               const hipKernelNodeParams* nodeParams,
+                                               unsigned int numNodes);
 // HIP Compiler dispatch table
 struct HipCompilerDispatchTable {
   // HIP_COMPILER_API_TABLE_STEP_VERSION == 0
@@ -1519,8 +1525,11 @@ struct HipDispatchTable {
   // HIP_RUNTIME_API_TABLE_STEP_VERSION == 6
   t_hipDeviceGetTexture1DLinearMaxWidth hipDeviceGetTexture1DLinearMaxWidth_fn;
 
-  // DO NOT EDIT ABOVE!
   // HIP_RUNTIME_API_TABLE_STEP_VERSION == 7
+  t_hipExtGraphLaunchBatch hipExtGraphLaunchBatch_fn;
+
+  // DO NOT EDIT ABOVE!
+  // HIP_RUNTIME_API_TABLE_STEP_VERSION == 8
 
   // ******************************************************************************************* //
   //
@@ -625,6 +625,25 @@ hipError_t CodeObject::ExtractCodeObjectFromMemory(
   return extractCodeObjectFromFatBinary(data, device_names, code_objs);
 }
 
+hipError_t CodeObject::ExtractCodeObjectInPlace(
+    const void* data, const std::vector<std::string>& device_names,
+    std::vector<std::pair<const void*, size_t>>& code_objs) {
+  hipError_t status = extractCodeObjectFromFatBinary(data, device_names, code_objs);
+  if ((status != hipSuccess) && (status != hipErrorNoBinaryForGpu)) {
+    return status;
+  }
+
+  // Only the selected code objects are read, so don't fault in the whole bundle
+  for (const auto& code_obj : code_objs) {
+    if ((code_obj.first != nullptr) &&
+        !amd::Os::MemoryPrefetchFile(code_obj.first, code_obj.second)) {
+      LogPrintfInfo("Cannot prefetch code object %p of size %zu", code_obj.first,
+                    code_obj.second);
+    }
+  }
+  return status;
+}
+
 // This will be moved to COMGR eventually
 hipError_t CodeObject::extractCodeObjectFromFatBinary(
     const void* data, const std::vector<std::string>& agent_triple_target_ids,
@@ -1243,11 +1262,33 @@ hipError_t DynCO::populateDynGlobalFuncs() {
   return hipSuccess;
 }
 
+namespace {
+// Thread local cache of the resolved static functions. The launches of the cached kernels
+// don't take the global lock of the static code object
+struct StatFuncCacheEntry {
+  const void* hostFunction_ = nullptr;  // Host stub of the kernel
+  int deviceId_ = -1;                   // Device of the resolved function
+  uint64_t generation_ = 0;             // Generation of the function table
+  hipFunction_t hfunc_ = nullptr;       // Resolved function
+};
+
+constexpr size_t kStatFuncCacheSize = 64;  // Must be a power of two
+thread_local StatFuncCacheEntry statFuncCache[kStatFuncCacheSize];
+
+inline StatFuncCacheEntry& StatFuncCacheSlot(const void* hostFunction, int deviceId) {
+  const uintptr_t key = reinterpret_cast<uintptr_t>(hostFunction);
+  // The host stubs are aligned, hence skip the low bits
+  const size_t index = (key >> 4) ^ (key >> 10) ^ static_cast<size_t>(deviceId);
+  return statFuncCache[index & (kStatFuncCacheSize - 1)];
+}
+}  // namespace
+
 // Static Code Object
 StatCO::StatCO() {}
 
 StatCO::~StatCO() {
   amd::ScopedLock lock(sclock_);
+  funcGeneration_.fetch_add(1, std::memory_order_acq_rel);
 
   for (auto& elem : functions_) {
     delete elem.second;
@@ -1268,16 +1309,77 @@ hipError_t StatCO::digestFatBinary(const void* data, FatBinaryInfo*& programs) {
   }
 
   // Create a new fat binary object and extract the fat binary for all devices.
+  const uint64_t start = amd::Os::timeNanos();
   programs = new FatBinaryInfo(nullptr, data);
   IHIP_RETURN_ONFAIL(programs->ExtractFatBinary(g_devices));
+  ClPrint(amd::LOG_INFO, amd::LOG_CODE, "Extracted fat binary %p for %zu devices in %llu us",
+          data, g_devices.size(), (amd::Os::timeNanos() - start) / 1000);
 
   return hipSuccess;
 }
 
+void StatCO::digestFatBinaries() {
+  std::vector<std::pair<const void*, FatBinaryInfo**>> pending;
+  {
+    amd::ScopedLock lock(sclock_);
+    for (auto& it : modules_) {
+      if (it.second == nullptr) {
+        pending.push_back(std::make_pair(it.first, &it.second));
+      }
+    }
+  }
+  if (pending.empty()) {
+    return;
+  }
+
+  // The extraction doesn't need the lock, so the symbol lookups of other threads don't wait
+  std::vector<FatBinaryInfo*> programs(pending.size(), nullptr);
+  std::vector<hipError_t> status(pending.size(), hipSuccess);
+  const uint64_t start = amd::Os::timeNanos();
+  const size_t num_threads = RunCodeObjectWorkers(pending.size(), [&](size_t idx) {
+    programs[idx] = new FatBinaryInfo(nullptr, pending[idx].first);
+    status[idx] = programs[idx]->ExtractFatBinary(g_devices);
+  });
+  ClPrint(amd::LOG_INFO, amd::LOG_CODE, "Extracted %zu fat binaries for %zu devices with %zu "
+          "threads in %llu us", pending.size(), g_devices.size(), num_threads,
+          (amd::Os::timeNanos() - start) / 1000);
+
+  amd::ScopedLock lock(sclock_);
+  for (size_t idx = 0; idx < pending.size(); ++idx) {
+    if (status[idx] != hipSuccess) {
+      HIP_ERROR_PRINT(status[idx], "continue parsing remaining modules");
+    }
+    // A symbol lookup could digest the module in the meantime, so keep the first result
+    auto it = modules_.find(pending[idx].first);
+    if ((it != modules_.end()) && (&it->second == pending[idx].second) &&
+        (it->second == nullptr)) {
+      it->second = programs[idx];
+    } else {
+      delete programs[idx];
+    }
+  }
+}
+
+hipError_t StatCO::buildFatBinary(FatBinaryInfo** module) {
+  FatBinaryInfo* programs = nullptr;
+  {
+    amd::ScopedLock lock(sclock_);
+    if (module == nullptr) {
+      return hipErrorInvalidValue;
+    }
+    IHIP_RETURN_ONFAIL(digestLazyFatBinary(module));
+    programs = *module;
+  }
+  // The module is built once. The build doesn't hold the lock, so the lookups of the symbols
+  // in other modules don't wait for it
+  return programs->BuildPrograms();
+}
+
 FatBinaryInfo** StatCO::addFatBinary(const void* data, bool initialized, bool& success) {
   amd::ScopedLock lock(sclock_);
 
-  if (initialized == false) {
+  // With the lazy loading the code objects are extracted on the first use of the module
+  if ((initialized == false) || DEBUG_HIP_LAZY_CODE_OBJECT_LOADING) {
     success = true;
     return &modules_[data];
   }
@@ -1287,8 +1389,26 @@ FatBinaryInfo** StatCO::addFatBinary(const void* data, bool initialized, bool& s
   return &modules_[data];
 }
 
+hipError_t StatCO::digestLazyFatBinary(FatBinaryInfo** module) {
+  amd::ScopedLock lock(sclock_);
+
+  if ((module == nullptr) || (*module != nullptr)) {
+    return hipSuccess;
+  }
+
+  // The module slot is a value of modules_, so find the fat binary it was registered with
+  for (auto& it : modules_) {
+    if (&it.second == module) {
+      return digestFatBinary(it.first, it.second);
+    }
+  }
+  return hipErrorNoBinaryForGpu;
+}
+
 hipError_t StatCO::removeFatBinary(FatBinaryInfo** module) {
   amd::ScopedLock lock(sclock_);
+  // Invalidate the cached functions before they are destroyed
+  funcGeneration_.fetch_add(1, std::memory_order_acq_rel);
 
   auto vit = vars_.begin();
   while (vit != vars_.end()) {
@@ -1369,6 +1489,16 @@ const char* StatCO::getStatFuncName(const void* hostFunction) {
 }
 
 hipError_t StatCO::getStatFunc(hipFunction_t* hfunc, const void* hostFunction, int deviceId) {
+  // The resolved function stays valid until a fat binary is removed, hence the cached entry
+  // is used if the function table didn't change
+  const uint64_t generation = funcGeneration_.load(std::memory_order_acquire);
+  StatFuncCacheEntry& entry = StatFuncCacheSlot(hostFunction, deviceId);
+  if ((entry.hostFunction_ == hostFunction) && (entry.deviceId_ == deviceId) &&
+      (entry.generation_ == generation)) {
+    *hfunc = entry.hfunc_;
+    return hipSuccess;
+  }
+
   amd::ScopedLock lock(sclock_);
 
   const auto it = functions_.find(hostFunction);
@@ -1376,7 +1506,16 @@ hipError_t StatCO::getStatFunc(hipFunction_t* hfunc, const void* hostFunction, i
     return hipErrorInvalidSymbol;
   }
 
-  return it->second->getStatFunc(hfunc, deviceId);
+  IHIP_RETURN_ONFAIL(digestLazyFatBinary(it->second->moduleInfo()));
+  hipError_t status = it->second->getStatFunc(hfunc, deviceId);
+  if (status == hipSuccess) {
+    // The generation was read before the lock, so a concurrent removal leaves a stale entry
+    entry.hostFunction_ = hostFunction;
+    entry.deviceId_ = deviceId;
+    entry.generation_ = generation;
+    entry.hfunc_ = *hfunc;
+  }
+  return status;
 }
 
 hipError_t StatCO::getStatFuncAttr(hipFuncAttributes* func_attr, const void* hostFunction,
@@ -1388,6 +1527,7 @@ hipError_t StatCO::getStatFuncAttr(hipFuncAttributes* func_attr, const void* hos
     return hipErrorInvalidSymbol;
   }
 
+  IHIP_RETURN_ONFAIL(digestLazyFatBinary(it->second->moduleInfo()));
   return it->second->getStatFuncAttr(func_attr, deviceId);
 }
 
@@ -1412,6 +1552,7 @@ hipError_t StatCO::getStatGlobalVar(const void* hostVar, int deviceId, hipDevice
     return hipErrorInvalidSymbol;
   }
 
+  IHIP_RETURN_ONFAIL(digestLazyFatBinary(it->second->moduleInfo()));
   DeviceVar* dvar = nullptr;
   IHIP_RETURN_ONFAIL(it->second->getStatDeviceVar(&dvar, deviceId));
 
@@ -1431,6 +1572,7 @@ hipError_t StatCO::initStatManagedVarDevicePtr(int deviceId) {
   if (managedVarsDevicePtrInitalized_.find(deviceId) == managedVarsDevicePtrInitalized_.end() ||
       !managedVarsDevicePtrInitalized_[deviceId]) {
     for (auto var : managedVars_) {
+      IHIP_RETURN_ONFAIL(digestLazyFatBinary(var->moduleInfo()));
       DeviceVar* dvar = nullptr;
       IHIP_RETURN_ONFAIL(var->getStatDeviceVar(&dvar, deviceId));
 
@@ -25,6 +25,7 @@ THE SOFTWARE.
 
 #include "hip_global.hpp"
 
+#include <atomic>
 #include <cstring>
 #include <unordered_map>
 
@@ -61,6 +62,12 @@ class CodeObject {
                     std::vector<std::pair<const void*, size_t>>& code_objs,
                     std::string& uri);
 
+  // Given an uncompressed bundle in memory, returns code_objs{binary_ptr, binary_size} pointing
+  // into the bundle without copies and prefetches the pages of the selected code objects
+  static hipError_t ExtractCodeObjectInPlace(const void* data,
+                    const std::vector<std::string>& device_names,
+                    std::vector<std::pair<const void*, size_t>>& code_objs);
+
   static uint64_t ElfSize(const void* emi);
 
   static bool IsClangOffloadMagicBundle(const void* data, bool& isCompressed);
@@ -110,7 +117,7 @@ private:
 //Dynamic Code Object
 class DynCO : public CodeObject {
   // Guards Dynamic Code object
-  amd::Monitor dclock_{true};
+  amd::Monitor dclock_{"DynCO::dclock", true};
 
 public:
   DynCO() : device_id_(ihipGetDevice()), fb_info_(nullptr) {}
@@ -160,7 +167,7 @@ private:
 //Static Code Object
 class StatCO: public CodeObject {
   // Guards Static Code object
-  amd::Monitor sclock_{true};
+  amd::Monitor sclock_{"StatCO::sclock", true};
 public:
   StatCO();
   virtual ~StatCO();
@@ -169,6 +176,10 @@ public:
   FatBinaryInfo** addFatBinary(const void* data, bool initialized, bool& success);
   hipError_t removeFatBinary(FatBinaryInfo** module);
   hipError_t digestFatBinary(const void* data, FatBinaryInfo*& programs);
+  //Extracts the code objects of all fat binaries, which weren't digested yet, in parallel
+  void digestFatBinaries();
+  //Builds the programs of a fat binary for all devices once, without holding the lock
+  hipError_t buildFatBinary(FatBinaryInfo** module);
 
   //Register vars/funcs given to use from __hipRegister[Var/Func/ManagedVar]
   hipError_t registerStatFunction(const void* hostFunction, Function* func);
@@ -187,10 +198,15 @@ public:
   hipError_t initStatManagedVarDevicePtr(int deviceId);
 private:
   friend class hip::PlatformState;
+  //Digests the fat binary of the given module slot, if it was deferred to the first use
+  hipError_t digestLazyFatBinary(FatBinaryInfo** module);
+
   //Populated during __hipRegisterFatBinary
   std::unordered_map<const void*, FatBinaryInfo*> modules_;
   //Populated during __hipRegisterFuncs
   std::unordered_map<const void*, Function*> functions_;
+  //Generation of functions_, which invalidates the thread local caches of getStatFunc
+  std::atomic<uint64_t> funcGeneration_{1};
   //Populated during __hipRegisterVars
   std::unordered_map<const void*, Var*> vars_;
   //Populated during __hipRegisterManagedVar
@@ -76,6 +76,15 @@ bool Device::Create() {
 
   // Current is default pool after device creation
   current_mem_pool_ = default_mem_pool_;
+
+  if ((HIP_MEM_POOL_TRIM_MODE == 1) && (trim_worker_ == nullptr)) {
+    trim_worker_ = new TrimWorker();
+    if ((trim_worker_ == nullptr) || !trim_worker_->Create()) {
+      delete trim_worker_;
+      trim_worker_ = nullptr;
+      LogError("Couldn't create the memory pool trim worker, fallback to inline release");
+    }
+  }
   return true;
 }
 
@@ -323,6 +332,9 @@ Device::~Device() {
     graph_mem_pool_->release();
   }
 
+  // The pools cancel the pending trims on destruction, hence the worker must be deleted last
+  delete trim_worker_;
+
   if (null_stream_ != nullptr) {
     hip::Stream::Destroy(null_stream_);
   }
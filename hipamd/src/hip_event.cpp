@@ -28,7 +28,7 @@
 namespace hip {
 
 // Guards global event set
-static amd::Monitor eventSetLock{};
+static amd::Monitor eventSetLock{"eventSetLock", false};
 static std::unordered_set<hipEvent_t> eventSet;
 
 bool Event::ready() {
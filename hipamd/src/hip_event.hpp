@@ -115,6 +115,11 @@ class Event {
       event_->release();
     }
   }
+
+  /// Events share the memory pool with the runtime commands
+  void* operator new(size_t size) { return amd::SysmemPool::Allocate(size); }
+  void operator delete(void* ptr) { amd::SysmemPool::Release(ptr); }
+
   uint32_t flags_; //!< flags associated with the event
 
   virtual hipError_t query();
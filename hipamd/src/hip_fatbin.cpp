@@ -22,6 +22,9 @@ THE SOFTWARE.
 
 #include "hip_fatbin.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <unordered_map>
 #include "hip_code_object.hpp"
 #include "hip_platform.hpp"
@@ -29,6 +32,36 @@ THE SOFTWARE.
 
 namespace hip {
 
+size_t RunCodeObjectWorkers(size_t count, const std::function<void(size_t)>& work) {
+  size_t num_threads = DEBUG_HIP_CODE_OBJECT_LOAD_THREADS;
+  if (num_threads == 0) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  num_threads = std::max<size_t>(std::min(num_threads, count), 1);
+
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t idx = next++; idx < count; idx = next++) {
+      work(idx);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back([&worker]() {
+      // amd::Monitor requires a runtime thread object for the calling thread
+      amd::Thread* thread = new amd::HostThread();
+      worker();
+      delete thread;
+    });
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return num_threads;
+}
+
 FatBinaryDeviceInfo::~FatBinaryDeviceInfo() {
   if (program_ != nullptr) {
     program_->unload();
@@ -56,7 +89,8 @@ FatBinaryInfo::~FatBinaryInfo() {
   // Release per device fat bin info.
   for (auto* fbd: fatbin_dev_info_) {
     if (fbd != nullptr) {
-      if (fbd->binary_image_ && fbd->binary_offset_ == 0 && fbd->binary_image_ != image_) {
+      if (fbd->binary_image_ && !fbd->in_place_ && fbd->binary_offset_ == 0 &&
+          fbd->binary_image_ != image_) {
         toDelete.insert(fbd->binary_image_);
       }
       delete fbd;
@@ -188,6 +222,37 @@ hipError_t FatBinaryInfo::ExtractFatBinaryUsingCOMGR(const std::vector<hip::Devi
       }
       break;
     }
+    // Reference the code objects of an uncompressed bundle in place, without the COMGR lookup
+    if (!isCompressed && DEBUG_HIP_ZERO_COPY_UNBUNDLING) {
+      std::vector<std::string> device_names;
+      device_names.reserve(devices.size());
+      for (auto device : devices) {
+        device_names.push_back(device->devices()[0]->isa().isaName());
+      }
+      std::vector<std::pair<const void*, size_t>> code_objs;
+      hip_status = CodeObject::ExtractCodeObjectInPlace(image_, device_names, code_objs);
+      if (hip_status != hipSuccess && hip_status != hipErrorNoBinaryForGpu) {
+        break;
+      }
+      for (size_t dev_idx = 0; dev_idx < devices.size(); ++dev_idx) {
+        // The devices without a code object were reported by the extraction
+        if (code_objs[dev_idx].first == nullptr) {
+          continue;
+        }
+        size_t offset = reinterpret_cast<address>(const_cast<void*>(code_objs[dev_idx].first))
+                        - reinterpret_cast<address>(const_cast<void*>(image_));
+        fatbin_dev_info_[devices[dev_idx]->deviceId()]
+          = new FatBinaryDeviceInfo(code_objs[dev_idx].first, code_objs[dev_idx].second, offset,
+                                    true);
+        fatbin_dev_info_[devices[dev_idx]->deviceId()]->program_
+          = new amd::Program(*devices[dev_idx]->asContext());
+        if (fatbin_dev_info_[devices[dev_idx]->deviceId()]->program_ == nullptr) {
+          hip_status = hipErrorOutOfMemory;
+          break;
+        }
+      }
+      break;
+    }
     if (!isCompressed) {
        if (CodeObject::containGenericTarget(image_)) {
          LogInfo("offload bundle contains generic target code object");
@@ -451,10 +516,17 @@ hipError_t FatBinaryInfo::AddDevProgram(const int device_id) {
 }
 
 hipError_t FatBinaryInfo::BuildProgram(const int device_id) {
+  amd::ScopedLock lock(build_lock_);
+  return BuildProgram(device_id, nullptr);
+}
+
+hipError_t FatBinaryInfo::BuildProgram(const int device_id, BuildTimes* times) {
+  const uint64_t start = (times != nullptr) ? amd::Os::timeNanos() : 0;
 
   // Device Id Check and Add DeviceProgram if not added so far
   DeviceIdCheck(device_id);
   IHIP_RETURN_ONFAIL(AddDevProgram(device_id));
+  const uint64_t added = (times != nullptr) ? amd::Os::timeNanos() : 0;
 
   // If Program was already built skip this step and return success
   FatBinaryDeviceInfo* fbd_info = fatbin_dev_info_[device_id];
@@ -466,13 +538,74 @@ hipError_t FatBinaryInfo::BuildProgram(const int device_id) {
     }
     fbd_info->prog_built_ = true;
   }
+  const uint64_t built = (times != nullptr) ? amd::Os::timeNanos() : 0;
 
   if (!fbd_info->program_->load()) {
     return hipErrorNoBinaryForGpu;
   }
+
+  if (times != nullptr) {
+    times->add_ = added - start;
+    times->build_ = built - added;
+    times->load_ = amd::Os::timeNanos() - built;
+  }
   return hipSuccess;
 }
 
+hipError_t FatBinaryInfo::BuildPrograms() {
+  if (programs_built_.load(std::memory_order_acquire)) {
+    return hipSuccess;
+  }
+  amd::ScopedLock lock(build_lock_);
+  if (programs_built_.load(std::memory_order_relaxed)) {
+    return hipSuccess;
+  }
+
+  // Skip the devices with the programs built already
+  std::vector<int> pending;
+  pending.reserve(g_devices.size());
+  for (auto device : g_devices) {
+    const int device_id = device->deviceId();
+    DeviceIdCheck(device_id);
+    FatBinaryDeviceInfo* fbd_info = fatbin_dev_info_[device_id];
+    if ((fbd_info == nullptr) || !fbd_info->prog_built_) {
+      pending.push_back(device_id);
+    }
+  }
+
+  // Each device owns its FatBinaryDeviceInfo, so the workers don't share any state
+  std::vector<hipError_t> status(pending.size(), hipSuccess);
+  std::vector<BuildTimes> times(pending.size());
+  const uint64_t start = amd::Os::timeNanos();
+  const size_t num_threads = RunCodeObjectWorkers(pending.size(), [&](size_t idx) {
+    status[idx] = BuildProgram(pending[idx], &times[idx]);
+  });
+  programs_built_.store(true, std::memory_order_release);
+  if (pending.empty()) {
+    return hipSuccess;
+  }
+
+  ClPrint(amd::LOG_INFO, amd::LOG_CODE, "Built fat binary %p for %zu devices with %zu threads "
+          "in %llu us", image_, pending.size(), num_threads,
+          (amd::Os::timeNanos() - start) / 1000);
+  // Report the first failure in the device order, as the serial build would
+  hipError_t result = hipSuccess;
+  for (size_t idx = 0; idx < pending.size(); ++idx) {
+    if (status[idx] != hipSuccess) {
+      LogPrintfError("Cannot build the program for device %d, error: %d", pending[idx],
+                     status[idx]);
+      if (result == hipSuccess) {
+        result = status[idx];
+      }
+      continue;
+    }
+    ClPrint(amd::LOG_INFO, amd::LOG_CODE, "Device %d: add %llu us, build %llu us, load %llu us",
+            pending[idx], times[idx].add_ / 1000, times[idx].build_ / 1000,
+            times[idx].load_ / 1000);
+  }
+  return result;
+}
+
 // ================================================================================================
 hipError_t FatBinaryInfo::ExtractFatBinaryUsingCOMGR(const void *data,
     const std::vector<hip::Device*>& devices) {
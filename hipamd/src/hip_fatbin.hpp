@@ -28,6 +28,9 @@ THE SOFTWARE.
 #include "hip_internal.hpp"
 #include "platform/program.hpp"
 
+#include <atomic>
+#include <functional>
+
 // Forward declaration for Unique FD
 struct UniqueFD;
 
@@ -36,9 +39,10 @@ namespace hip {
 //Fat Binary Per Device info
 class FatBinaryDeviceInfo {
 public:
-  FatBinaryDeviceInfo (const void* binary_image, size_t binary_size, size_t binary_offset)
+  FatBinaryDeviceInfo (const void* binary_image, size_t binary_size, size_t binary_offset,
+                       bool in_place = false)
                       : binary_image_(binary_image), binary_size_(binary_size),
-                        binary_offset_(binary_offset), program_(nullptr),
+                        binary_offset_(binary_offset), in_place_(in_place), program_(nullptr),
                         add_dev_prog_(false), prog_built_(false) {}
 
   ~FatBinaryDeviceInfo();
@@ -47,6 +51,7 @@ private:
   const void* binary_image_; // binary image ptr
   size_t binary_size_;       // binary image size
   size_t binary_offset_;     // image offset from original
+  bool in_place_;            // binary image points into the bundle and isn't owned
 
   amd::Program* program_;    // reinterpreted as hipModule_t
   friend class FatBinaryInfo;
@@ -57,6 +62,10 @@ private:
 };
 
 
+// Runs work(0) .. work(count - 1) on up to DEBUG_HIP_CODE_OBJECT_LOAD_THREADS threads, including
+// the calling one. Returns the number of threads
+size_t RunCodeObjectWorkers(size_t count, const std::function<void(size_t)>& work);
+
 // Fat Binary Info
 class FatBinaryInfo {
 public:
@@ -85,6 +94,8 @@ public:
   hipError_t ExtractFatBinary(const std::vector<hip::Device*>& devices);
   hipError_t AddDevProgram(const int device_id);
   hipError_t BuildProgram(const int device_id);
+  // Builds and loads the programs of all devices once with a bounded pool of threads
+  hipError_t BuildPrograms();
 
   // Device Id bounds check
   inline void DeviceIdCheck(const int device_id) const {
@@ -110,6 +121,14 @@ public:
   }
 
 private:
+  // Durations of the program build phases for a device in nanoseconds
+  struct BuildTimes {
+    uint64_t add_ = 0;       //!< ELF validation and the device program creation
+    uint64_t build_ = 0;     //!< Program build
+    uint64_t load_ = 0;      //!< Program load on the device
+  };
+  hipError_t BuildProgram(const int device_id, BuildTimes* times);
+
   std::string fname_;        //!< File name
   amd::Os::FileDesc fdesc_;  //!< File descriptor
   size_t fsize_;             //!< Total file size
@@ -126,6 +145,9 @@ private:
   std::vector<FatBinaryDeviceInfo*> fatbin_dev_info_;
 
   std::shared_ptr<UniqueFD> ufd_; //!< Unique file descriptor
+
+  amd::Monitor build_lock_{"FatBinaryInfo::build_lock", true};  //!< Serializes the builds
+  std::atomic<bool> programs_built_{false};  //!< The programs of all devices were built once
 };
 
 }; // namespace hip
@@ -109,7 +109,7 @@ DeviceVar::~DeviceVar() {
 }
 
 //Device Functions
-DeviceFunc::DeviceFunc(std::string name, hipModule_t hmod) : dflock_("function lock"),
+DeviceFunc::DeviceFunc(std::string name, hipModule_t hmod) : dflock_("function lock", true),
                        name_(name), kernel_(nullptr) {
   amd::Program* program = as_amd(reinterpret_cast<cl_program>(hmod));
 
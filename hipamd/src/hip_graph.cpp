@@ -30,9 +30,9 @@ namespace hip {
 
 std::vector<hip::Stream*> g_captureStreams;
 // StreamCaptureGlobalList lock
-amd::Monitor g_captureStreamsLock{};
+amd::Monitor g_captureStreamsLock{"g_captureStreamsLock", false};
 // StreamCaptureset lock
-amd::Monitor g_streamSetLock{};
+amd::Monitor g_streamSetLock{"g_streamSetLock", false};
 std::unordered_set<hip::Stream*> g_allCapturingStreams;
 hipError_t ihipGraphDebugDotPrint(hipGraph_t graph, const char* path, unsigned int flags);
 hipError_t ihipStreamUpdateCaptureDependencies(hipStream_t stream, hipGraphNode_t* dependencies,
@@ -1271,6 +1271,10 @@ hipError_t hipGraphExecMemcpyNodeSetParams1D(hipGraphExec_t hGraphExec, hipGraph
   if (clonedNode == nullptr) {
     HIP_RETURN(hipErrorInvalidValue);
   }
+  if (clonedNode->IsCoalesced()) {
+    // The optimizer merged the node with other nodes, which can't take a separate update
+    HIP_RETURN(hipErrorNotSupported);
+  }
   hipMemcpyKind oldkind =  reinterpret_cast<hip::GraphMemcpyNode1D*>(clonedNode)->GetMemcpyKind();
   if (oldkind != kind) {
     HIP_RETURN(hipErrorInvalidValue);
@@ -1380,13 +1384,36 @@ hipError_t ihipGraphInstantiate(hip::GraphExec** pGraphExec, hip::Graph* graph,
   if (clonedGraph == nullptr) {
     return hipErrorInvalidValue;
   }
+  if (DEBUG_HIP_GRAPH_OPT_PASSES != 0) {
+    clonedGraph->Optimize(DEBUG_HIP_GRAPH_OPT_PASSES, clonedNodes);
+  }
   std::vector<hip::GraphNode*> graphNodes;
   if (false == clonedGraph->TopologicalOrder(graphNodes)) {
     return hipErrorInvalidValue;
   }
+  clonedGraph->SetCriticalPathSchedule(DEBUG_HIP_GRAPH_CRITICAL_PATH_SCHEDULE ||
+                                       (flags & hip::kGraphInstantiateFlagCriticalPath));
+  const bool launch_fast_path = DEBUG_HIP_GRAPH_LAUNCH_FAST_PATH ||
+      ((flags & hip::kGraphInstantiateFlagLaunchFastPath) != 0);
+  flags &= ~hip::kGraphInstantiateFlagsExt;
   clonedGraph->ScheduleNodes();
-  *pGraphExec = new hip::GraphExec(graphNodes, clonedGraph, clonedNodes, flags);
+  if ((AMD_LOG_LEVEL >= amd::LOG_INFO) && (AMD_LOG_MASK & amd::LOG_CODE)) {
+    // Report the estimated quality of the schedule
+    uint64_t makespan = 0;
+    uint32_t waits = 0;
+    clonedGraph->SimulateSchedule(&makespan, &waits);
+    ClPrint(amd::LOG_INFO, amd::LOG_CODE,
+            "[hipGraph] %s schedule: nodes %zu, streams %d, critical path %llu, makespan %llu, "
+            "cross stream waits %u",
+            clonedGraph->critical_path_schedule_ ? "Critical path" : "Round robin",
+            clonedGraph->GetNodeCount(), clonedGraph->max_streams_,
+            static_cast<unsigned long long>(clonedGraph->critical_path_cost_),
+            static_cast<unsigned long long>(makespan), waits);
+  }
+  *pGraphExec = new hip::GraphExec(std::move(graphNodes), clonedGraph, std::move(clonedNodes),
+                                   flags);
   if (*pGraphExec != nullptr) {
+    (*pGraphExec)->SetLaunchFastPath(launch_fast_path);
     graph->SetGraphInstantiated(true);
     if (DEBUG_HIP_GRAPH_DOT_PRINT) {
       static int i = 1;
@@ -1428,9 +1455,10 @@ hipError_t hipGraphInstantiateWithFlags(hipGraphExec_t* pGraphExec, hipGraph_t g
     HIP_RETURN(hipErrorInvalidValue);
   }
 
-  // invalid flag check
-  if (flags != 0 && flags != hipGraphInstantiateFlagAutoFreeOnLaunch &&
-      flags != hipGraphInstantiateFlagUseNodePriority) {
+  // invalid flag check, the flag extensions can be combined with any other flag
+  unsigned long long api_flags = flags & ~hip::kGraphInstantiateFlagsExt;
+  if (api_flags != 0 && api_flags != hipGraphInstantiateFlagAutoFreeOnLaunch &&
+      api_flags != hipGraphInstantiateFlagUseNodePriority) {
     HIP_RETURN(hipErrorInvalidValue);
   }
 
@@ -1449,10 +1477,13 @@ hipError_t hipGraphInstantiateWithParams(hipGraphExec_t* pGraphExec, hipGraph_t
   }
 
   unsigned long long flags = instantiateParams->flags;
+  // The flag extensions can be combined with any other flag
+  unsigned long long api_flags = flags & ~hip::kGraphInstantiateFlagsExt;
 
-  if (flags != 0 && flags != hipGraphInstantiateFlagAutoFreeOnLaunch &&
-    flags != hipGraphInstantiateFlagUpload && flags != hipGraphInstantiateFlagDeviceLaunch &&
-    flags != hipGraphInstantiateFlagUseNodePriority) {
+  if (api_flags != 0 && api_flags != hipGraphInstantiateFlagAutoFreeOnLaunch &&
+    api_flags != hipGraphInstantiateFlagUpload &&
+    api_flags != hipGraphInstantiateFlagDeviceLaunch &&
+    api_flags != hipGraphInstantiateFlagUseNodePriority) {
     instantiateParams->result_out = hipGraphInstantiateError;
     HIP_RETURN(hipErrorInvalidValue);
   }
@@ -1468,7 +1499,7 @@ hipError_t hipGraphInstantiateWithParams(hipGraphExec_t* pGraphExec, hipGraph_t
   instantiateParams->result_out = hipGraphInstantiateSuccess;
   instantiateParams->errNode_out = nullptr;
 
-  if(flags == hipGraphInstantiateFlagUpload) {
+  if(api_flags == hipGraphInstantiateFlagUpload) {
     hipError_t status = ihipGraphUpload(*pGraphExec, instantiateParams->uploadStream);
     HIP_RETURN(status);
   }
@@ -1482,7 +1513,7 @@ hipError_t hipGraphExecDestroy(hipGraphExec_t pGraphExec) {
     HIP_RETURN(hipErrorInvalidValue);
   }
   hip::GraphExec* ge = reinterpret_cast<hip::GraphExec*>(pGraphExec);
-  ge->release();
+  hip::GraphExec::Destroy(ge);
   HIP_RETURN(hipSuccess);
 }
 
@@ -1514,6 +1545,39 @@ hipError_t hipGraphLaunch_spt(hipGraphExec_t graphExec, hipStream_t stream) {
   HIP_RETURN_DURATION(hipGraphLaunch_common(reinterpret_cast<hip::GraphExec*>(graphExec), stream));
 }
 
+hipError_t hipExtGraphLaunchBatch(hipGraphExec_t graphExec, hipStream_t stream,
+                                  unsigned int numLaunches, const hipGraphNode_t* nodes,
+                                  const hipKernelNodeParams* nodeParams, unsigned int numNodes) {
+  HIP_INIT_API(hipExtGraphLaunchBatch, graphExec, stream, numLaunches, nodes, nodeParams,
+               numNodes);
+  hip::GraphExec* ge = reinterpret_cast<hip::GraphExec*>(graphExec);
+  if (ge == nullptr || !hip::GraphExec::isGraphExecValid(ge) ||
+      ((numNodes != 0) && ((nodes == nullptr) || (nodeParams == nullptr)))) {
+    HIP_RETURN(hipErrorInvalidValue);
+  }
+  if (!hip::isValid(stream)) {
+    HIP_RETURN(hipErrorContextIsDestroyed);
+  }
+  std::vector<hip::GraphKernelNode*> kernelNodes(numNodes);
+  for (unsigned int i = 0; i < numNodes; ++i) {
+    hip::GraphNode* n = reinterpret_cast<hip::GraphNode*>(nodes[i]);
+    if (!hip::GraphNode::isNodeValid(n) || n->GetType() != hipGraphNodeTypeKernel) {
+      HIP_RETURN(hipErrorInvalidValue);
+    }
+    hip::GraphNode* clonedNode = ge->GetClonedNode(n);
+    if (clonedNode == nullptr) {
+      HIP_RETURN(hipErrorInvalidValue);
+    }
+    kernelNodes[i] = reinterpret_cast<hip::GraphKernelNode*>(clonedNode);
+  }
+  for (size_t i = 0; i < static_cast<size_t>(numLaunches) * numNodes; ++i) {
+    if (nodeParams[i].func == nullptr) {
+      HIP_RETURN(hipErrorInvalidValue);
+    }
+  }
+  HIP_RETURN_DURATION(ge->RunBatch(stream, numLaunches, kernelNodes, nodeParams));
+}
+
 hipError_t hipGraphGetNodes(hipGraph_t graph, hipGraphNode_t* nodes, size_t* numNodes) {
   HIP_INIT_API(hipGraphGetNodes, graph, nodes, numNodes);
   if (graph == nullptr || numNodes == nullptr) {
@@ -1673,6 +1737,9 @@ hipError_t hipGraphExecMemcpyNodeSetParams(hipGraphExec_t hGraphExec, hipGraphNo
   if (clonedNode == nullptr) {
     HIP_RETURN(hipErrorInvalidValue);
   }
+  if (clonedNode->IsCoalesced()) {
+    HIP_RETURN(hipErrorNotSupported);
+  }
 
   hipMemcpyKind oldkind =  reinterpret_cast<hip::GraphMemcpyNode*>(clonedNode)->GetMemcpyKind();
   hipMemcpyKind newkind =  pNodeParams->kind;
@@ -1729,6 +1796,9 @@ hipError_t hipGraphExecMemsetNodeSetParams(hipGraphExec_t hGraphExec, hipGraphNo
   if (clonedNode == nullptr) {
     HIP_RETURN(hipErrorInvalidValue);
   }
+  if (clonedNode->IsCoalesced()) {
+    HIP_RETURN(hipErrorNotSupported);
+  }
   hipError_t status = reinterpret_cast<hip::GraphMemsetNode*>(clonedNode)
                  ->SetParams(pNodeParams, true);
   if(status != hipSuccess) {
@@ -1791,14 +1861,10 @@ hipError_t hipGraphExecKernelNodeSetParams(hipGraphExec_t hGraphExec, hipGraphNo
   if (clonedNode == nullptr) {
     HIP_RETURN(hipErrorInvalidValue);
   }
-  hipError_t status = reinterpret_cast<hip::GraphKernelNode*>(clonedNode)->SetParams(pNodeParams);
-  if(status != hipSuccess) {
-    HIP_RETURN(status);
-  }
-  if (DEBUG_CLR_GRAPH_PACKET_CAPTURE) {
-    status = reinterpret_cast<hip::GraphExec*>(hGraphExec)
-        ->UpdateAQLPacket(reinterpret_cast<hip::GraphKernelNode*>(clonedNode));
-  }
+  hip::GraphExec* graphExec = reinterpret_cast<hip::GraphExec*>(hGraphExec);
+  hipError_t status = graphExec->UpdateKernelNode(
+      reinterpret_cast<hip::GraphKernelNode*>(clonedNode), pNodeParams);
+  graphExec->FlushKernelArgs();
   HIP_RETURN(status);
 }
 
@@ -2523,8 +2589,8 @@ hipError_t hipGraphExecUpdate(hipGraphExec_t hGraphExec, hipGraph_t hGraph,
 
   std::vector<hip::GraphNode*> newGraphNodes;
   reinterpret_cast<hip::Graph*>(hGraph)->TopologicalOrder(newGraphNodes);
-  std::vector<hip::GraphNode*>& oldGraphExecNodes =
-      reinterpret_cast<hip::GraphExec*>(hGraphExec)->GetNodes();
+  hip::GraphExec* graphExec = reinterpret_cast<hip::GraphExec*>(hGraphExec);
+  std::vector<hip::GraphNode*>& oldGraphExecNodes = graphExec->GetNodes();
   if (newGraphNodes.size() != oldGraphExecNodes.size()) {
     *updateResult_out = hipGraphExecUpdateErrorTopologyChanged;
     *hErrorNode_out = nullptr;
@@ -2532,6 +2598,11 @@ hipError_t hipGraphExecUpdate(hipGraphExec_t hGraphExec, hipGraph_t hGraph,
   }
 
   for (std::vector<hip::GraphNode*>::size_type i = 0; i != newGraphNodes.size(); i++) {
+    if (oldGraphExecNodes[i]->IsCoalesced()) {
+      *hErrorNode_out = reinterpret_cast<hipGraphNode_t>(newGraphNodes[i]);
+      *updateResult_out = hipGraphExecUpdateErrorNotSupported;
+      HIP_RETURN(hipErrorGraphExecUpdateFailure);
+    }
     // Checks if all the node types are same before updating
     if (newGraphNodes[i]->GetType() == oldGraphExecNodes[i]->GetType()) {
       if (newGraphNodes[i]->GetType() != hipGraphNodeTypeHost &&
@@ -2570,8 +2641,22 @@ hipError_t hipGraphExecUpdate(hipGraphExec_t hGraphExec, hipGraph_t hGraph,
         HIP_RETURN(hipErrorGraphExecUpdateFailure);
       }
 
-      hipError_t status = oldGraphExecNodes[i]->SetParams(newGraphNodes[i]);
+      hipError_t status = hipSuccess;
+      if (newGraphNodes[i]->GetType() == hipGraphNodeTypeKernel) {
+        // Kernel nodes update only the changed parts of the captured packets
+        hipKernelNodeParams params;
+        static_cast<hip::GraphKernelNode*>(newGraphNodes[i])->GetParams(&params);
+        status = graphExec->UpdateKernelNode(
+            static_cast<hip::GraphKernelNode*>(oldGraphExecNodes[i]), &params);
+      } else {
+        status = oldGraphExecNodes[i]->SetParams(newGraphNodes[i]);
+        if ((status == hipSuccess) && DEBUG_CLR_GRAPH_PACKET_CAPTURE &&
+            newGraphNodes[i]->GraphCaptureEnabled()) {
+          status = graphExec->UpdateAQLPacket(oldGraphExecNodes[i]);
+        }
+      }
       if (status != hipSuccess) {
+        graphExec->FlushKernelArgs();
         *hErrorNode_out = reinterpret_cast<hipGraphNode_t>(newGraphNodes[i]);
         if (status == hipErrorInvalidDeviceFunction) {
           *updateResult_out = hipGraphExecUpdateErrorUnsupportedFunctionChange;
@@ -2581,10 +2666,6 @@ hipError_t hipGraphExecUpdate(hipGraphExec_t hGraphExec, hipGraph_t hGraph,
           *updateResult_out = hipGraphExecUpdateErrorNotSupported;
         }
         HIP_RETURN(hipErrorGraphExecUpdateFailure);
-      } else if (DEBUG_CLR_GRAPH_PACKET_CAPTURE && newGraphNodes[i]->GraphCaptureEnabled()) {
-        status =
-            reinterpret_cast<hip::GraphExec*>(hGraphExec)
-                ->UpdateAQLPacket(reinterpret_cast<hip::GraphKernelNode*>(oldGraphExecNodes[i]));
       }
     } else {
       *hErrorNode_out = reinterpret_cast<hipGraphNode_t>(newGraphNodes[i]);
@@ -2592,6 +2673,7 @@ hipError_t hipGraphExecUpdate(hipGraphExec_t hGraphExec, hipGraph_t hGraph,
       HIP_RETURN(hipErrorGraphExecUpdateFailure);
     }
   }
+  graphExec->FlushKernelArgs();
   *updateResult_out = hipGraphExecUpdateSuccess;
   HIP_RETURN(hipSuccess);
 }
@@ -2933,6 +3015,9 @@ hipError_t hipGraphNodeSetEnabled(hipGraphExec_t hGraphExec, hipGraphNode_t hNod
   if (clonedNode == nullptr) {
     HIP_RETURN(hipErrorInvalidValue);
   }
+  if (clonedNode->IsCoalesced()) {
+    HIP_RETURN(hipErrorNotSupported);
+  }
   if (!(node->GetType() == hipGraphNodeTypeKernel || node->GetType() == hipGraphNodeTypeMemcpy ||
         node->GetType() == hipGraphNodeTypeMemset)) {
     HIP_RETURN(hipErrorInvalidValue);
@@ -3392,6 +3477,9 @@ hipError_t hipGraphExecNodeSetParams(hipGraphExec_t graphExec, hipGraphNode_t no
   if (clonedNode == nullptr) {
     HIP_RETURN(hipErrorInvalidValue);
   }
+  if (clonedNode->IsCoalesced()) {
+    HIP_RETURN(hipErrorNotSupported);
+  }
 
   hipError_t status = ihipGraphNodeSetParams(clonedNode, nodeParams);
   if (status != hipSuccess) {
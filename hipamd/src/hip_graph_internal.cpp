@@ -20,6 +20,7 @@
 
 #include "hip_graph_internal.hpp"
 #include <queue>
+#include <limits>
 
 #define CASE_STRING(X, C)                                                                          \
   case X:                                                                                          \
@@ -52,22 +53,24 @@ const char* GetGraphNodeTypeString(uint32_t op) {
 
 namespace hip {
 
+hipError_t ihipFree(void* ptr);
+
 int GraphNode::nextID = 0;
 int Graph::nextID = 0;
 std::unordered_set<GraphNode*> GraphNode::nodeSet_;
 // Guards global node set
-amd::Monitor GraphNode::nodeSetLock_{};
+amd::Monitor GraphNode::nodeSetLock_{"GraphNode::nodeSetLock", false};
 std::unordered_set<Graph*> Graph::graphSet_;
 // Guards global graph set
-amd::Monitor Graph::graphSetLock_{};
+amd::Monitor Graph::graphSetLock_{"Graph::graphSetLock", false};
 std::unordered_set<GraphExec*> GraphExec::graphExecSet_;
 // Guards global exec graph set
-amd::Monitor GraphExec::graphExecSetLock_{};
+amd::Monitor GraphExec::graphExecSetLock_{"GraphExec::graphExecSetLock", false};
 std::unordered_set<UserObject*> UserObject::ObjectSet_;
 // Guards global user object
-amd::Monitor UserObject::UserObjectLock_{};
+amd::Monitor UserObject::UserObjectLock_{"UserObject::UserObjectLock", false};
 // Guards mem map add/remove against work thread
-amd::Monitor GraphNode::WorkerThreadLock_{};
+amd::Monitor GraphNode::WorkerThreadLock_{"GraphNode::WorkerThreadLock", false};
 
 hipError_t GraphMemcpyNode1D::ValidateParams(void* dst, const void* src, size_t count,
                                                 hipMemcpyKind kind) {
@@ -117,6 +120,7 @@ bool Graph::isGraphValid(Graph* pGraph) {
 }
 
 void Graph::AddNode(const Node& node) {
+  node->index_ = vertices_.size();
   vertices_.emplace_back(node);
   ClPrint(amd::LOG_INFO, amd::LOG_CODE, "[hipGraph] Add %s(%p)",
           GetGraphNodeTypeString(node->GetType()), node);
@@ -124,7 +128,12 @@ void Graph::AddNode(const Node& node) {
 }
 
 void Graph::RemoveNode(const Node& node) {
-  vertices_.erase(std::remove(vertices_.begin(), vertices_.end(), node), vertices_.end());
+  auto it = std::find(vertices_.begin(), vertices_.end(), node);
+  if (it != vertices_.end()) {
+    size_t first = it - vertices_.begin();
+    vertices_.erase(it);
+    IndexNodes(first);
+  }
   delete node;
 }
 
@@ -173,8 +182,18 @@ std::vector<std::pair<Node, Node>> Graph::GetEdges() const {
 }
 
 // ================================================================================================
-void Graph::ScheduleOneNode(Node node, int stream_id) {
-  if (node->stream_id_ == -1) {
+void Graph::IndexNodes(size_t first) {
+  for (size_t i = first; i < vertices_.size(); ++i) {
+    vertices_[i]->index_ = i;
+  }
+}
+
+// ================================================================================================
+void Graph::ScheduleOneNode(Node node, int stream_id, std::vector<ScheduleFrame>& stack) {
+  auto schedule = [this](Node node, int stream_id) {
+    if (node->stream_id_ != -1) {
+      return false;
+    }
     // Assign active stream to the current node
     node->stream_id_ = stream_id;
     max_streams_ = std::max(max_streams_, (stream_id + 1));
@@ -195,11 +214,30 @@ void Graph::ScheduleOneNode(Node node, int stream_id) {
         reinterpret_cast<hip::ChildGraphNode*>(node)->TopologicalOrder();
       }
     }
-    for (auto edge: node->GetEdges()) {
-      ScheduleOneNode(edge, stream_id);
-      // 1. Each extra edge will get a new stream from the pool
-      // 2. Streams will be reused if the number of edges > streams
-      stream_id = (stream_id + 1) % DEBUG_HIP_FORCE_GRAPH_QUEUES;
+    return true;
+  };
+
+  // Depth first walk over the edges. Long chains of captured nodes would overflow
+  // the thread stack with recursion, hence the pending edges are kept on the heap
+  if (!schedule(node, stream_id)) {
+    return;
+  }
+  stack.clear();
+  stack.push_back({node, 0, stream_id});
+  while (!stack.empty()) {
+    ScheduleFrame& frame = stack.back();
+    const std::vector<Node>& edges = frame.node_->GetEdges();
+    if (frame.edge_ == edges.size()) {
+      stack.pop_back();
+      continue;
+    }
+    Node edge = edges[frame.edge_++];
+    int edge_stream_id = frame.stream_id_;
+    // 1. Each extra edge will get a new stream from the pool
+    // 2. Streams will be reused if the number of edges > streams
+    frame.stream_id_ = (frame.stream_id_ + 1) % DEBUG_HIP_FORCE_GRAPH_QUEUES;
+    if (schedule(edge, edge_stream_id)) {
+      stack.push_back({edge, 0, edge_stream_id});
     }
   }
 }
@@ -212,11 +250,16 @@ void Graph::ScheduleNodes() {
   }
   memset(&roots_[0], 0, sizeof(Node) * roots_.size());
   max_streams_ = 0;
+  if (critical_path_schedule_) {
+    ScheduleCriticalPath();
+    return;
+  }
   // Start processing all nodes in the graph to find async executions.
   int stream_id = 0;
+  std::vector<ScheduleFrame> stack;
   for (auto node : vertices_) {
     if (node->stream_id_ == -1) {
-      ScheduleOneNode(node, stream_id);
+      ScheduleOneNode(node, stream_id, stack);
       // Find the root nodes
       if ((node->GetDependencies().size() == 0) && (node->stream_id_ != 0)) {
         // Fill in only the first in the sequence
@@ -231,29 +274,427 @@ void Graph::ScheduleNodes() {
   }
 }
 
+// ================================================================================================
+uint64_t Graph::EstimateCriticalPath(const std::vector<Node>& order) {
+  critical_path_cost_ = 0;
+  // Walk in reverse order, so the levels of all edges are ready before the node
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    Node node = *it;
+    if (node->GetType() == hipGraphNodeTypeGraph) {
+      // The cost of a child graph is the cost of its own critical path
+      auto child = reinterpret_cast<hip::ChildGraphNode*>(node)->childGraph_;
+      std::vector<Node> child_order;
+      child->TopologicalOrder(child_order);
+      node->sched_cost_ = child->EstimateCriticalPath(child_order);
+    } else {
+      node->sched_cost_ = node->EstimateCost();
+    }
+    uint64_t level = 0;
+    for (auto edge : node->GetEdges()) {
+      level = std::max(level, edge->sched_level_);
+    }
+    node->sched_level_ = level + node->sched_cost_;
+    critical_path_cost_ = std::max(critical_path_cost_, node->sched_level_);
+  }
+  return critical_path_cost_;
+}
+
+// ================================================================================================
+void Graph::ScheduleCriticalPath() {
+  std::vector<Node> order;
+  TopologicalOrder(order);
+  // Child graphs are scheduled on their own, the same way as in the round robin mode
+  for (auto node : order) {
+    if (node->GetType() == hipGraphNodeTypeGraph) {
+      auto child = reinterpret_cast<hip::ChildGraphNode*>(node)->childGraph_;
+      child->SetCriticalPathSchedule(true);
+      child->ScheduleNodes();
+      max_streams_ = std::max(max_streams_, child->max_streams_);
+      if (child->max_streams_ == 1) {
+        reinterpret_cast<hip::ChildGraphNode*>(node)->TopologicalOrder();
+      }
+    }
+  }
+  EstimateCriticalPath(order);
+
+  // The ready node with the longest path to a leaf is scheduled first
+  auto lower_priority = [](Node lhs, Node rhs) {
+    return (lhs->sched_level_ != rhs->sched_level_) ? (lhs->sched_level_ < rhs->sched_level_)
+                                                   : (lhs->id_ > rhs->id_);
+  };
+  std::priority_queue<Node, std::vector<Node>, decltype(lower_priority)> ready(lower_priority);
+  std::vector<size_t> pending(order.size());
+  for (auto node : order) {
+    pending[node->index_] = node->GetDependencies().size();
+    if (pending[node->index_] == 0) {
+      ready.push(node);
+    }
+  }
+
+  const int32_t num_streams = DEBUG_HIP_FORCE_GRAPH_QUEUES;
+  std::vector<uint64_t> stream_time(num_streams, 0);
+  int32_t used_streams = 0;
+  while (!ready.empty()) {
+    Node node = ready.top();
+    ready.pop();
+    // Find the stream with the earliest start of the node. A dependency on another stream
+    // delays the start by a signal and costs another one for the signal itself, hence a branch
+    // stays on the stream of its parent, unless another stream can start it noticeably earlier.
+    // All unused streams are equal, so probe only the first one of them.
+    int32_t best_stream = 0;
+    uint64_t best_start = 0;
+    uint64_t best_score = std::numeric_limits<uint64_t>::max();
+    size_t best_local = 0;
+    for (int32_t stream = 0; stream < std::min(used_streams + 1, num_streams); ++stream) {
+      uint64_t start = stream_time[stream];
+      size_t local = 0;
+      for (auto dep : node->GetDependencies()) {
+        if (dep->stream_id_ == stream) {
+          start = std::max(start, dep->sched_finish_);
+          local++;
+        } else {
+          start = std::max(start, dep->sched_finish_ + kGraphSignalCost);
+        }
+      }
+      uint64_t score = start + kGraphSignalCost * (node->GetDependencies().size() - local);
+      if ((score < best_score) || ((score == best_score) && (local > best_local))) {
+        best_stream = stream;
+        best_start = start;
+        best_score = score;
+        best_local = local;
+      }
+    }
+    node->stream_id_ = best_stream;
+    node->sched_finish_ = best_start + node->sched_cost_;
+    stream_time[best_stream] = node->sched_finish_;
+    used_streams = std::max(used_streams, best_stream + 1);
+
+    // Update the dependencies if a signal is required
+    for (auto dep : node->GetDependencies()) {
+      if (dep->stream_id_ != best_stream) {
+        dep->signal_is_required_ = true;
+      }
+    }
+    // Fill in only the first root in the sequence
+    if ((node->GetDependencies().size() == 0) && (best_stream != 0) &&
+        (roots_[best_stream] == nullptr)) {
+      roots_[best_stream] = node;
+    }
+    for (auto edge : node->GetEdges()) {
+      if (--pending[edge->index_] == 0) {
+        ready.push(edge);
+      }
+    }
+  }
+  max_streams_ = std::max(max_streams_, used_streams);
+}
+
+// ================================================================================================
+void Graph::SimulateSchedule(uint64_t* makespan, uint32_t* waits) {
+  std::vector<Node> order;
+  TopologicalOrder(order);
+  EstimateCriticalPath(order);
+  *makespan = 0;
+  *waits = 0;
+  std::vector<uint64_t> stream_time(std::max(max_streams_, 1), 0);
+  std::vector<bool> wait_stream(stream_time.size());
+  // Run the nodes in order on the virtual streams. Each stream is in order and
+  // a node waits once per stream for the latest of its dependencies on it
+  for (auto node : order) {
+    uint64_t start = stream_time[node->stream_id_];
+    std::fill(wait_stream.begin(), wait_stream.end(), false);
+    for (auto dep : node->GetDependencies()) {
+      if (dep->stream_id_ != node->stream_id_) {
+        start = std::max(start, dep->sched_finish_ + kGraphSignalCost);
+        if (!wait_stream[dep->stream_id_]) {
+          wait_stream[dep->stream_id_] = true;
+          (*waits)++;
+        }
+      } else {
+        start = std::max(start, dep->sched_finish_);
+      }
+    }
+    node->sched_finish_ = start + node->sched_cost_;
+    stream_time[node->stream_id_] = node->sched_finish_;
+    *makespan = std::max(*makespan, node->sched_finish_);
+  }
+}
+
+namespace {
+// ================================================================================================
+//! Runs the optimization passes on an instantiated graph and keeps the map of cloned nodes valid
+class GraphOptimizer {
+ public:
+  GraphOptimizer(Graph& graph, std::unordered_map<Node, Node>& clonedNodes)
+      : graph_(graph), clonedNodes_(clonedNodes) {
+    for (const auto& it : clonedNodes_) {
+      originals_[it.second].push_back(it.first);
+    }
+  }
+
+  //! Removes empty nodes. The event waits stay, since an exec update can change the events
+  void EliminateNodes(Graph::OptPassStats& stats);
+  //! Merges contiguous nodes of the same type, which run as siblings or as a chain
+  void CoalesceNodes(hipGraphNodeType type, Graph::OptPassStats& stats);
+  //! Removes the edges, implied by other paths in the graph
+  void ReduceEdges(Graph::OptPassStats& stats);
+  //! Moves the host nodes without dependencies to the front of the launch order
+  void HoistHostNodes(Graph::OptPassStats& stats);
+
+ private:
+  //! Returns true if the parent node has an edge to the child node
+  static bool HasEdge(Node parent, Node child) {
+    const auto& edges = parent->GetEdges();
+    return std::find(edges.begin(), edges.end(), child) != edges.end();
+  }
+  //! Returns true if both nodes have the same set of dependencies
+  static bool SameDependencies(Node lhs, Node rhs) {
+    const auto& lhs_deps = lhs->GetDependencies();
+    const auto& rhs_deps = rhs->GetDependencies();
+    if (lhs_deps.size() != rhs_deps.size()) {
+      return false;
+    }
+    for (auto dep : lhs_deps) {
+      if (std::find(rhs_deps.begin(), rhs_deps.end(), dep) == rhs_deps.end()) {
+        return false;
+      }
+    }
+    return true;
+  }
+  //! Adds the edges of the removed node to the node, which replaces it
+  void MoveEdges(Node from, Node to, Graph::OptPassStats& stats);
+  //! Removes the node from the graph and from the map of cloned nodes
+  void Remove(Node node, Graph::OptPassStats& stats);
+  //! Removes the node, which was coalesced into another node, and maps its original nodes
+  //! to the merged node
+  void Merge(Node from, Node to, Graph::OptPassStats& stats);
+
+  Graph& graph_;                                  //!< The optimized graph
+  std::unordered_map<Node, Node>& clonedNodes_;   //!< Original to cloned nodes map
+  std::unordered_map<Node, std::vector<Node>> originals_;  //!< Cloned to original nodes map
+  std::unordered_set<Node> removed_;              //!< Nodes, removed from the graph
+};
+
+// ================================================================================================
+void GraphOptimizer::MoveEdges(Node from, Node to, Graph::OptPassStats& stats) {
+  for (auto edge : from->GetEdges()) {
+    if (!HasEdge(to, edge)) {
+      to->AddEdgeDep(edge);
+      stats.edges_added_++;
+    }
+  }
+}
+
+// ================================================================================================
+void GraphOptimizer::Remove(Node node, Graph::OptPassStats& stats) {
+  stats.nodes_removed_++;
+  stats.edges_removed_ += node->GetDependencies().size() + node->GetEdges().size();
+  // Only empty nodes are removed without a merge. Without the cloned node the exec setters
+  // return hipErrorInvalidValue, the same as for an empty node of an unoptimized graph
+  auto it = originals_.find(node);
+  if (it != originals_.end()) {
+    for (auto original : it->second) {
+      clonedNodes_.erase(original);
+    }
+    originals_.erase(it);
+  }
+  removed_.insert(node);
+  // The node destructor disconnects all edges
+  graph_.RemoveNode(node);
+}
+
+// ================================================================================================
+void GraphOptimizer::Merge(Node from, Node to, Graph::OptPassStats& stats) {
+  MoveEdges(from, to, stats);
+  // The exec setters of all original nodes must find the merged node and reject the update,
+  // otherwise a setter would apply one original range to the whole merged range
+  auto it = originals_.find(from);
+  if (it != originals_.end()) {
+    std::vector<Node> originals = std::move(it->second);
+    originals_.erase(it);
+    for (auto original : originals) {
+      clonedNodes_[original] = to;
+    }
+    auto& merged = originals_[to];
+    merged.insert(merged.end(), originals.begin(), originals.end());
+  }
+  to->SetCoalesced();
+  Remove(from, stats);
+}
+
+// ================================================================================================
+void GraphOptimizer::EliminateNodes(Graph::OptPassStats& stats) {
+  // A wait for an event, recorded by an ancestor node, is redundant only for the events at
+  // instantiate time. hipGraphExecEventRecordNodeSetEvent/WaitNodeSetEvent can change either
+  // event later, and a removed node can't come back. A wait node, which skips the wait at
+  // launch, still needs a marker for the cross stream dependencies and costs the same.
+  for (size_t i = 0; i < graph_.vertices_.size();) {
+    Node node = graph_.vertices_[i];
+    size_t deps = node->GetDependencies().size();
+    size_t edges = node->GetEdges().size();
+    // Keep the barriers between wide fans, since direct edges would grow quadratically
+    if ((node->GetType() != hipGraphNodeTypeEmpty) || (deps * edges > deps + edges) ||
+        (graph_.vertices_.size() == 1)) {
+      i++;
+      continue;
+    }
+    for (auto dep : node->GetDependencies()) {
+      MoveEdges(node, dep, stats);
+    }
+    Remove(node, stats);
+  }
+}
+
+// ================================================================================================
+void GraphOptimizer::CoalesceNodes(hipGraphNodeType type, Graph::OptPassStats& stats) {
+  auto candidate = [type](Node node) { return (node->GetType() == type) && node->CanCoalesce(); };
+  std::vector<Node> roots;
+  for (auto node : graph_.vertices_) {
+    if (candidate(node) && node->GetDependencies().empty()) {
+      roots.push_back(node);
+    }
+  }
+  for (size_t i = 0; i < graph_.vertices_.size(); ++i) {
+    Node node = graph_.vertices_[i];
+    if (!candidate(node)) {
+      continue;
+    }
+    bool merged = true;
+    while (merged) {
+      merged = false;
+      // A chain of two nodes runs as one, if nothing else is ordered between them
+      if (node->GetEdges().size() == 1) {
+        Node next = node->GetEdges()[0];
+        if (candidate(next) && (next->GetDependencies().size() == 1) && node->Coalesce(next)) {
+          node->RemoveEdgeDep(next);
+          stats.edges_removed_++;
+          Merge(next, node, stats);
+          merged = true;
+          continue;
+        }
+      }
+      // The siblings with the same dependencies can run as one
+      std::vector<Node> siblings = node->GetDependencies().empty() ?
+          roots : node->GetDependencies()[0]->GetEdges();
+      for (auto sibling : siblings) {
+        if ((sibling != node) && (removed_.find(sibling) == removed_.end()) &&
+            candidate(sibling) && SameDependencies(node, sibling) && node->Coalesce(sibling)) {
+          Merge(sibling, node, stats);
+          merged = true;
+          break;
+        }
+      }
+    }
+    // The removed nodes could shift the current node in the list
+    i = node->index_;
+  }
+}
+
+// ================================================================================================
+void GraphOptimizer::ReduceEdges(Graph::OptPassStats& stats) {
+  if (graph_.vertices_.size() > kGraphOptMaxReduceNodes) {
+    return;
+  }
+  std::vector<Node> order;
+  if (!graph_.TopologicalOrder(order)) {
+    return;
+  }
+  // Position of every node in topological order by the dense node index
+  std::vector<size_t> position(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    position[order[i]->index_] = i;
+  }
+  // Bit sets of all descendants of every node
+  constexpr size_t kBits = 64;
+  const size_t words = (order.size() + kBits - 1) / kBits;
+  std::vector<uint64_t> reach(order.size() * words, 0);
+  for (size_t i = order.size(); i-- > 0;) {
+    uint64_t* node_reach = &reach[i * words];
+    // An edge is implied, if its node is reachable from an edge earlier in topological order
+    std::vector<Node> edges = order[i]->GetEdges();
+    std::sort(edges.begin(), edges.end(), [&position](Node lhs, Node rhs) {
+      return position[lhs->index_] < position[rhs->index_];
+    });
+    for (auto edge : edges) {
+      size_t j = position[edge->index_];
+      if (node_reach[j / kBits] & (1ull << (j % kBits))) {
+        order[i]->RemoveEdgeDep(edge);
+        stats.edges_removed_++;
+        continue;
+      }
+      node_reach[j / kBits] |= 1ull << (j % kBits);
+      const uint64_t* edge_reach = &reach[j * words];
+      for (size_t w = 0; w < words; ++w) {
+        node_reach[w] |= edge_reach[w];
+      }
+    }
+  }
+}
+
+// ================================================================================================
+void GraphOptimizer::HoistHostNodes(Graph::OptPassStats& stats) {
+  auto it = std::stable_partition(graph_.vertices_.begin(), graph_.vertices_.end(),
+      [](Node node) {
+        return (node->GetType() == hipGraphNodeTypeHost) && node->GetDependencies().empty();
+      });
+  stats.nodes_moved_ = it - graph_.vertices_.begin();
+  graph_.IndexNodes(0);
+}
+}  // namespace
+
+// ================================================================================================
+void Graph::Optimize(uint32_t passes, std::unordered_map<Node, Node>& clonedNodes) {
+  GraphOptimizer optimizer(*this, clonedNodes);
+  opt_stats_.clear();
+  auto run = [this, passes](uint32_t pass, const char* name, auto&& body) {
+    if ((passes & pass) == 0) {
+      return;
+    }
+    OptPassStats stats(name);
+    uint64_t start = amd::Os::timeNanos();
+    body(stats);
+    stats.time_ns_ = amd::Os::timeNanos() - start;
+    ClPrint(amd::LOG_INFO, amd::LOG_CODE,
+            "[hipGraph] Pass %s: removed nodes %zu, moved nodes %zu, removed edges %zu, "
+            "added edges %zu, time %llu ns", stats.name_, stats.nodes_removed_,
+            stats.nodes_moved_, stats.edges_removed_, stats.edges_added_,
+            static_cast<unsigned long long>(stats.time_ns_));
+    opt_stats_.push_back(stats);
+  };
+  run(kGraphOptEliminateNodes, "EliminateNodes",
+      [&](OptPassStats& stats) { optimizer.EliminateNodes(stats); });
+  run(kGraphOptCoalesceMemset, "CoalesceMemset",
+      [&](OptPassStats& stats) { optimizer.CoalesceNodes(hipGraphNodeTypeMemset, stats); });
+  run(kGraphOptCoalesceMemcpy, "CoalesceMemcpy",
+      [&](OptPassStats& stats) { optimizer.CoalesceNodes(hipGraphNodeTypeMemcpy, stats); });
+  // The reduction runs after the passes, which add edges
+  run(kGraphOptReduceEdges, "ReduceEdges",
+      [&](OptPassStats& stats) { optimizer.ReduceEdges(stats); });
+  run(kGraphOptHoistHostNodes, "HoistHostNodes",
+      [&](OptPassStats& stats) { optimizer.HoistHostNodes(stats); });
+}
+
 // ================================================================================================
 bool Graph::TopologicalOrder(std::vector<Node>& TopoOrder) {
-  std::queue<Node> q;
-  std::unordered_map<Node, int> inDegree;
+  // The in-degrees are kept in a flat array by the node index and
+  // the output vector serves as the queue of the ready nodes
+  std::vector<size_t> inDegree(vertices_.size());
+  const size_t first = TopoOrder.size();
+  TopoOrder.reserve(first + vertices_.size());
   for (auto entry : vertices_) {
     if (entry->GetInDegree() == 0) {
-      q.push(entry);
+      TopoOrder.push_back(entry);
     }
-    inDegree[entry] = entry->GetInDegree();
+    inDegree[entry->index_] = entry->GetInDegree();
   }
-  while (!q.empty())
-  {
-    Node node = q.front();
-    TopoOrder.push_back(node);
-    q.pop();
-    for (auto edge : node->GetEdges()) {
-      inDegree[edge]--;
-      if (inDegree[edge] == 0) {
-        q.push(edge);
+  for (size_t i = first; i < TopoOrder.size(); ++i) {
+    for (auto edge : TopoOrder[i]->GetEdges()) {
+      if (--inDegree[edge->index_] == 0) {
+        TopoOrder.push_back(edge);
       }
     }
   }
-  if (GetNodeCount() == TopoOrder.size()) {
+  if (GetNodeCount() == (TopoOrder.size() - first)) {
     return true;
   }
   return false;
@@ -261,30 +702,35 @@ bool Graph::TopologicalOrder(std::vector<Node>& TopoOrder) {
 
 Graph* Graph::clone(std::unordered_map<Node, Node>& clonedNodes) const {
   Graph* newGraph = new Graph(device_, this);
+  // Connect the cloned nodes by the node index, the map is filled only for the caller
+  newGraph->vertices_.reserve(vertices_.size());
+  clonedNodes.reserve(clonedNodes.size() + vertices_.size());
   for (auto entry : vertices_) {
     GraphNode* node = entry->clone();
     node->SetParentGraph(newGraph);
+    node->index_ = entry->index_;
     newGraph->vertices_.push_back(node);
     clonedNodes[entry] = node;
   }
 
+  const std::vector<Node>& cloned = newGraph->vertices_;
   std::vector<Node> clonedEdges;
   std::vector<Node> clonedDependencies;
   for (auto node : vertices_) {
     const std::vector<Node>& edges = node->GetEdges();
     clonedEdges.clear();
     for (auto edge : edges) {
-      clonedEdges.push_back(clonedNodes[edge]);
+      clonedEdges.push_back(cloned[edge->index_]);
     }
-    clonedNodes[node]->SetEdges(clonedEdges);
+    cloned[node->index_]->SetEdges(clonedEdges);
   }
   for (auto node : vertices_) {
     const std::vector<Node>& dependencies = node->GetDependencies();
     clonedDependencies.clear();
     for (auto dep : dependencies) {
-      clonedDependencies.push_back(clonedNodes[dep]);
+      clonedDependencies.push_back(cloned[dep->index_]);
     }
-    clonedNodes[node]->SetDependencies(clonedDependencies);
+    cloned[node->index_]->SetDependencies(clonedDependencies);
   }
   for (auto& userObj : graphUserObj_) {
     userObj.first->retain();
@@ -313,6 +759,45 @@ bool GraphExec::isGraphExecValid(GraphExec* pGraphExec) {
   return true;
 }
 
+void GraphExec::Destroy(GraphExec* exec) {
+  if (exec->launch_fast_path_ && (exec->PendingLaunches() > 0)) {
+    // Don't block the application on the GPU. A marker after the unfinished launches
+    // releases the exec, when the last launch is done
+    amd::Command::EventWaitList waitList;
+    for (const auto& launch : exec->pending_launches_) {
+      waitList.push_back(launch.command_);
+    }
+    amd::HostQueue* queue = exec->pending_launches_.back().command_->queue();
+    amd::Command* command = new amd::Marker(*queue, !kMarkerDisableFlush, waitList);
+    if (command != nullptr) {
+      command->setEventScope(amd::Device::kCacheStateIgnore);
+      if (command->event().setCallback(CL_COMPLETE, GraphExec::ReleaseDestroyed, exec)) {
+        {
+          // The handle is invalid for the application from now on
+          amd::ScopedLock lock(graphExecSetLock_);
+          graphExecSet_.erase(exec);
+        }
+        command->enqueue();
+        command->release();
+        return;
+      }
+      command->release();
+    }
+  }
+  exec->release();
+}
+
+// ================================================================================================
+void GraphExec::ReleaseDestroyed(cl_event event, cl_int command_exec_status, void* user_data) {
+  GraphExec* exec = reinterpret_cast<GraphExec*>(user_data);
+  // The marker waited for all launches, hence the destructor has nothing to wait for
+  for (auto& launch : exec->pending_launches_) {
+    launch.command_->release();
+  }
+  exec->pending_launches_.clear();
+  exec->release();
+}
+
 hipError_t GraphExec::CreateStreams(uint32_t num_streams) {
   parallel_streams_.reserve(num_streams);
   for (uint32_t i = 0; i < num_streams; ++i) {
@@ -349,16 +834,20 @@ hipError_t GraphExec::Init() {
   return status;
 }
 
-//! Chunk size to add to kern arg pool
-constexpr uint32_t kKernArgChunkSize = 128 * Ki;
+//! Kern arg pool headroom for the updates, which can't patch the args in place
+constexpr size_t kKernArgMinHeadroom = 16 * Ki;  //!< The smallest headroom
+constexpr size_t kKernArgHeadroomRatio = 8;      //!< Headroom as the fraction of the footprint
+constexpr size_t kKernArgPoolAlignment = 4 * Ki; //!< Granularity of the kernel arg pool
 // ================================================================================================
 void GetKernelArgSizeForGraph(std::vector<hip::Node>& topoOrder,
                               size_t& kernArgSizeForGraph) {
   // GPU packet capture is enabled for kernel nodes. Calculate the kernel
-  // arg size required for all graph kernel nodes to allocate
+  // arg size required for all graph kernel nodes to allocate. The args are packed in
+  // the capture order, hence follow the same layout for the exact footprint
   for (hip::GraphNode* node : topoOrder) {
     if (node->GraphCaptureEnabled()) {
-      kernArgSizeForGraph += node->GetKerArgSize();
+      kernArgSizeForGraph = amd::alignUp(kernArgSizeForGraph, node->GetKernargSegmentAlignment()) +
+                            node->GetKernargSegmentByteSize();
     } else if (node->GetType() == hipGraphNodeTypeGraph) {
       if (reinterpret_cast<hip::ChildGraphNode*>(node)->childGraph_->max_streams_ == 1) {
         GetKernelArgSizeForGraph(reinterpret_cast<hip::ChildGraphNode*>(node)->childGraphNodeOrder_,
@@ -405,14 +894,18 @@ hipError_t GraphExec::CaptureAQLPackets() {
   if (clonedGraph_->max_streams_ == 1) {
     size_t kernArgSizeForGraph = 0;
     GetKernelArgSizeForGraph(topoOrder_, kernArgSizeForGraph);
-    auto device = g_devices[ihipGetDevice()]->devices()[0];
-    // Add a larger initial pool to accomodate for any updates to kernel args
-    bool bStatus = kernArgManager_->AllocGraphKernargPool(kernArgSizeForGraph + kKernArgChunkSize);
+    // Add a headroom to the initial pool to accomodate for any updates to kernel args
+    size_t headroom = std::max(kernArgSizeForGraph / kKernArgHeadroomRatio, kKernArgMinHeadroom);
+    bool bStatus = kernArgManager_->AllocGraphKernargPool(
+        amd::alignUp(kernArgSizeForGraph + headroom, kKernArgPoolAlignment));
     if (bStatus != true) {
       return hipErrorMemoryAllocation;
     }
 
+    // The nodes with the same arguments share one copy in the pool
+    kernArgManager_->EnableArgsReuse(true);
     status = AllocKernelArgForGraphNode(topoOrder_, capture_stream_, this);
+    kernArgManager_->EnableArgsReuse(false);
     if (status != hipSuccess) {
       return status;
     }
@@ -425,11 +918,75 @@ hipError_t GraphExec::CaptureAQLPackets() {
 hipError_t GraphExec::UpdateAQLPacket(hip::GraphNode* node) {
   hipError_t status = hipSuccess;
   if (clonedGraph_->max_streams_ == 1) {
+    std::vector<uint8_t*> packets;
+    packets.swap(node->GetAqlPackets());
     node->CaptureAndFormPacket(capture_stream_, kernArgManager_);
+    // The launch copies the packets into the AQL queue, hence the old ones are unused
+    for (auto packet : packets) {
+      delete[] packet;
+    }
   }
   return hipSuccess;
 }
 
+// ================================================================================================
+hipError_t GraphExec::UpdateKernelNode(GraphKernelNode* node, const hipKernelNodeParams* params) {
+  bool captured = DEBUG_CLR_GRAPH_PACKET_CAPTURE && (clonedGraph_->max_streams_ == 1) &&
+      !node->GetAqlPackets().empty();
+  GraphKernelNode::ParamsDiff diff =
+      captured ? node->CompareParams(params) : GraphKernelNode::kParamsLaunch;
+  if (diff == GraphKernelNode::kParamsSame) {
+    // Nothing to update, the captured packets are valid
+    return hipSuccess;
+  }
+  // The new parameters can change the kernel and the size of its args
+  size_t args_size = node->GetKernargSegmentByteSize();
+  hipError_t status = node->SetParams(params);
+  if ((status != hipSuccess) || !DEBUG_CLR_GRAPH_PACKET_CAPTURE) {
+    return status;
+  }
+  // Write just the argument values, if the launch configuration didn't change.
+  // The buffers of a launch, which can be still in progress, can't be modified.
+  if (diff == GraphKernelNode::kParamsArgs) {
+    std::vector<address> retired;
+    bool patched = node->PatchCapturedArgs(kernArgManager_, IsLaunchInFlight(), retired);
+    RetireKernArgs(retired, node->GetKernargSegmentByteSize());
+    if (patched) {
+      kernargs_patched_ = true;
+      return hipSuccess;
+    }
+  }
+  // The full capture replaces the args of the packets, which launches in flight can still read
+  std::vector<address> retired;
+  for (auto packet : node->GetAqlPackets()) {
+    address args = nullptr;
+    ::memcpy(&args, packet + kAqlKernargAddressOffset, sizeof(args));
+    if (!kernArgManager_->IsSharedKernArg(args)) {
+      retired.push_back(args);
+    }
+  }
+  status = UpdateAQLPacket(node);
+  RetireKernArgs(retired, args_size);
+  return status;
+}
+
+// ================================================================================================
+void GraphExec::RetireKernArgs(const std::vector<address>& args, size_t size) {
+  // The dispatched launches of a batch are tracked after the batch as the next launch
+  uint64_t launch_id = launch_id_ + (batch_dispatched_ ? 1 : 0);
+  for (auto arg : args) {
+    retired_kernargs_.push_back({arg, size, launch_id});
+  }
+}
+
+// ================================================================================================
+void GraphExec::FlushKernelArgs() {
+  if (kernargs_patched_) {
+    kernArgManager_->ReadBackOrFlush();
+    kernargs_patched_ = false;
+  }
+}
+
 // ================================================================================================
 
 void GraphExec::DecrementRefCount(cl_event event, cl_int command_exec_status, void* user_data) {
@@ -440,12 +997,13 @@ void GraphExec::DecrementRefCount(cl_event event, cl_int command_exec_status, vo
 // ================================================================================================
 
 hipError_t EnqueueGraphWithSingleList(std::vector<hip::Node>& topoOrder, hip::Stream* hip_stream,
-                                      hip::GraphExec* graphExec) {
+                                      hip::GraphExec* graphExec,
+                                      amd::AccumulateCommand* accumulate) {
   // Accumulate command tracks all the AQL packet batch that we submit to the HW. For now
-  // we track only kernel nodes.
-  amd::AccumulateCommand* accumulate = nullptr;
+  // we track only kernel nodes. The caller can provide one for several graph launches.
+  const bool own_accumulate = (accumulate == nullptr);
   hipError_t status = hipSuccess;
-  if (DEBUG_CLR_GRAPH_PACKET_CAPTURE) {
+  if (DEBUG_CLR_GRAPH_PACKET_CAPTURE && own_accumulate) {
     accumulate = new amd::AccumulateCommand(*hip_stream, {}, nullptr);
   }
   for (int i = 0; i < topoOrder.size(); i++) {
@@ -463,7 +1021,7 @@ hipError_t EnqueueGraphWithSingleList(std::vector<hip::Node>& topoOrder, hip::St
     }
   }
 
-  if (DEBUG_CLR_GRAPH_PACKET_CAPTURE) {
+  if (DEBUG_CLR_GRAPH_PACKET_CAPTURE && own_accumulate) {
     accumulate->enqueue();
     accumulate->release();
   }
@@ -560,8 +1118,12 @@ bool Graph::RunOneNode(Node node, bool wait) {
     uint32_t i = 0;
     // Execute the nodes in the edges list
     for (auto edge: node->GetEdges()) {
-      // Don't wait in the nodes, executed on the same streams and if it has just one dependency
-      bool wait = ((i < DEBUG_HIP_FORCE_GRAPH_QUEUES) ||
+      // Don't wait in the nodes, executed on the same streams and if it has just one dependency.
+      // Round robin gives the first DEBUG_HIP_FORCE_GRAPH_QUEUES edges their own streams and
+      // the following edges reuse the streams in order. The critical path scheduler can place
+      // any edge on any stream, hence it always waits. The wait list holds only the
+      // dependencies on other streams, so an edge on the parent's stream doesn't wait anyway
+      bool wait = (critical_path_schedule_ || (i < DEBUG_HIP_FORCE_GRAPH_QUEUES) ||
                    (edge->GetDependencies().size() > 1)) ? true : false;
       // Execute the edge node
       if (!RunOneNode(edge, wait)) {
@@ -673,26 +1235,13 @@ hipError_t GraphExec::Run(hipStream_t graph_launch_stream) {
     }
   }
 
-  // If this is a repeat launch, make sure corresponding MemFreeNode exists for a MemAlloc node
-  if (repeatLaunch_ == true) {
-    if (!topoOrder_.empty() && topoOrder_[0]->GetParentGraph()->GetMemAllocNodeCount() > 0) {
-       return hipErrorInvalidValue;
-    }
-  }  else {
-    repeatLaunch_ = true;
+  status = CheckRepeatLaunch(1);
+  if (status != hipSuccess) {
+    return status;
   }
 
   if (clonedGraph_->max_streams_ == 1 && instantiateDeviceId_ == launch_stream->DeviceId()) {
-    if (DEBUG_CLR_GRAPH_PACKET_CAPTURE) {
-      // If the graph has kernels that does device side allocation,  during packet capture, heap is
-      // allocated because heap pointer has to be added to the AQL packet, and initialized during
-      // graph launch.
-      static bool initialized = false;
-      if (!initialized && HasHiddenHeap()) {
-        launch_stream->vdev()->HiddenHeapInit();
-        initialized = true;
-      }
-    }
+    InitHiddenHeap(launch_stream);
     status = EnqueueGraphWithSingleList(topoOrder_, launch_stream, this);
   } else if (clonedGraph_->max_streams_ == 1 && instantiateDeviceId_ != launch_stream->DeviceId()) {
     for (int i = 0; i < topoOrder_.size(); i++) {
@@ -709,6 +1258,56 @@ hipError_t GraphExec::Run(hipStream_t graph_launch_stream) {
       return hipErrorOutOfMemory;
     }
   }
+  hipError_t track_status = TrackLaunch(launch_stream);
+  return (track_status != hipSuccess) ? track_status : status;
+}
+
+// ================================================================================================
+hipError_t GraphExec::CheckRepeatLaunch(uint32_t num_launches) {
+  // If this is a repeat launch, make sure corresponding MemFreeNode exists for a MemAlloc node
+  if (repeatLaunch_ || (num_launches > 1)) {
+    if (!topoOrder_.empty() && topoOrder_[0]->GetParentGraph()->GetMemAllocNodeCount() > 0) {
+      return hipErrorInvalidValue;
+    }
+  }
+  repeatLaunch_ = true;
+  return hipSuccess;
+}
+
+// ================================================================================================
+void GraphExec::InitHiddenHeap(hip::Stream* launch_stream) {
+  if (DEBUG_CLR_GRAPH_PACKET_CAPTURE) {
+    // If the graph has kernels that does device side allocation,  during packet capture, heap is
+    // allocated because heap pointer has to be added to the AQL packet, and initialized during
+    // graph launch.
+    static bool initialized = false;
+    if (!initialized && HasHiddenHeap()) {
+      launch_stream->vdev()->HiddenHeapInit();
+      initialized = true;
+    }
+  }
+}
+
+// ================================================================================================
+hipError_t GraphExec::TrackLaunch(hip::Stream* launch_stream) {
+  if (launch_fast_path_) {
+    // Track the launch by its last command, polled on the later launches and waited
+    // on destroy, instead of the host callback and the blocking marker
+    if (PendingLaunches() >= kGraphMaxPendingLaunches) {
+      // Not all commands report the completion without a notification, so bound the list
+      pending_launches_.front().command_->awaitCompletion();
+      PendingLaunches();
+    }
+    ++launch_id_;
+    amd::Command* command = launch_stream->getLastQueuedCommand(true);
+    if (command != nullptr) {
+      pending_launches_.push_back({command, launch_id_});
+    }
+    ResetQueueIndex();
+    return hipSuccess;
+  }
+  // Release the finished launches, so the list holds only the launches in progress
+  PendingLaunches();
   this->retain();
   amd::Command* CallbackCommand = new amd::Marker(*launch_stream, kMarkerDisableFlush, {});
   // we may not need to flush any caches.
@@ -718,6 +1317,9 @@ hipError_t GraphExec::Run(hipStream_t graph_launch_stream) {
     return hipErrorInvalidHandle;
   }
   CallbackCommand->enqueue();
+  // The marker tracks the launch for the updates of the kernel args
+  CallbackCommand->retain();
+  pending_launches_.push_back({CallbackCommand, ++launch_id_});
   // Add the new barrier to stall the stream, until the callback is done
   amd::Command::EventWaitList eventWaitList;
   eventWaitList.push_back(CallbackCommand);
@@ -731,7 +1333,99 @@ hipError_t GraphExec::Run(hipStream_t graph_launch_stream) {
   block_command->release();
   CallbackCommand->release();
   ResetQueueIndex();
-  return status;
+  return hipSuccess;
+}
+
+// ================================================================================================
+hipError_t GraphExec::RunBatch(hipStream_t graph_launch_stream, uint32_t num_launches,
+                               const std::vector<GraphKernelNode*>& nodes,
+                               const hipKernelNodeParams* params) {
+  hipError_t status = hipSuccess;
+  if (num_launches == 0) {
+    return status;
+  }
+  hip::Stream* launch_stream = hip::getStream(graph_launch_stream);
+  auto update = [&](uint32_t launch) {
+    hipError_t result = hipSuccess;
+    for (size_t i = 0; (i < nodes.size()) && (result == hipSuccess); ++i) {
+      result = UpdateKernelNode(nodes[i], &params[launch * nodes.size() + i]);
+    }
+    FlushKernelArgs();
+    return result;
+  };
+
+  // Only the launches of the captured packets share the submission,
+  // everything else is launched one by one
+  if (!DEBUG_CLR_GRAPH_PACKET_CAPTURE || (clonedGraph_->max_streams_ != 1) ||
+      (instantiateDeviceId_ != launch_stream->DeviceId()) ||
+      (flags_ & hipGraphInstantiateFlagAutoFreeOnLaunch) || (num_launches == 1)) {
+    for (uint32_t launch = 0; (launch < num_launches) && (status == hipSuccess); ++launch) {
+      status = update(launch);
+      if (status == hipSuccess) {
+        status = Run(graph_launch_stream);
+      }
+    }
+    return status;
+  }
+  status = CheckRepeatLaunch(num_launches);
+  if (status != hipSuccess) {
+    return status;
+  }
+  InitHiddenHeap(launch_stream);
+  // One accumulate command tracks the packets of all launches and the doorbell is rung once
+  amd::AccumulateCommand* accumulate = new amd::AccumulateCommand(*launch_stream, {}, nullptr);
+  launch_stream->vdev()->beginPacketBatch();
+  for (uint32_t launch = 0; (launch < num_launches) && (status == hipSuccess); ++launch) {
+    status = update(launch);
+    if (status == hipSuccess) {
+      status = EnqueueGraphWithSingleList(topoOrder_, launch_stream, this, accumulate);
+      // The arguments of the next launch can't overwrite the buffers of the dispatched ones
+      batch_dispatched_ = true;
+    }
+  }
+  launch_stream->vdev()->endPacketBatch();
+  batch_dispatched_ = false;
+  accumulate->enqueue();
+  accumulate->release();
+  hipError_t track_status = TrackLaunch(launch_stream);
+  return (track_status != hipSuccess) ? track_status : status;
+}
+
+// ================================================================================================
+size_t GraphExec::PendingLaunches() {
+  auto finished = [](const PendingLaunch& launch) {
+    amd::Command* command = launch.command_;
+    // Check HW status of the ROCcrl event. Note: not all ROCclr modes support HW status
+    bool ready = command->queue()->device().IsHwEventReady(command->event());
+    if (!ready) {
+      ready = (command->status() == CL_COMPLETE);
+    }
+    if (ready) {
+      command->release();
+    }
+    return ready;
+  };
+  pending_launches_.erase(
+      std::remove_if(pending_launches_.begin(), pending_launches_.end(), finished),
+      pending_launches_.end());
+
+  // The launches can finish out of order on different streams, hence the args are free
+  // only when all launches up to the retirement are done
+  uint64_t oldest = launch_id_ + 1;
+  for (const auto& launch : pending_launches_) {
+    oldest = std::min(oldest, launch.launch_id_);
+  }
+  auto recycled = [this, oldest](const RetiredKernArgs& args) {
+    if (args.launch_id_ < oldest) {
+      kernArgManager_->FreeKernArg(args.args_, args.size_);
+      return true;
+    }
+    return false;
+  };
+  retired_kernargs_.erase(
+      std::remove_if(retired_kernargs_.begin(), retired_kernargs_.end(), recycled),
+      retired_kernargs_.end());
+  return pending_launches_.size();
 }
 
 // ================================================================================================
@@ -760,6 +1454,19 @@ bool GraphKernelArgManager::AllocGraphKernargPool(size_t pool_size) {
 
 address GraphKernelArgManager::AllocKernArg(size_t size, size_t alignment) {
   assert(alignment != 0);
+  // Reuse the args, replaced by the updates, after their launches are done
+  auto it = free_kernargs_.find(size);
+  if (it != free_kernargs_.end()) {
+    auto& list = it->second;
+    for (size_t i = list.size(); i-- > 0;) {
+      if (amd::isMultipleOf(list[i], alignment)) {
+        address result = list[i];
+        list[i] = list.back();
+        list.pop_back();
+        return result;
+      }
+    }
+  }
   address result = nullptr;
   result = amd::alignUp(
       kernarg_graph_.back().kernarg_pool_addr_ + kernarg_graph_.back().kernarg_pool_offset_,
@@ -768,8 +1475,11 @@ address GraphKernelArgManager::AllocKernArg(size_t size, size_t alignment) {
   if (pool_new_usage <= kernarg_graph_.back().kernarg_pool_size_) {
     kernarg_graph_.back().kernarg_pool_offset_ = pool_new_usage;
   } else {
-    // If current chunck is full allocate new chunck with same size as current
-    bool bStatus = AllocGraphKernargPool(kernarg_graph_.back().kernarg_pool_size_);
+    // If current chunck is full allocate new chunck with the double size of the current,
+    // so the number of chunks grows logarithmically with the updates
+    size_t pool_size = std::max(2 * kernarg_graph_.back().kernarg_pool_size_,
+                                amd::alignUp(size + alignment, kKernArgPoolAlignment));
+    bool bStatus = AllocGraphKernargPool(pool_size);
     if (bStatus == false) {
       return nullptr;
     } else {
@@ -780,6 +1490,27 @@ address GraphKernelArgManager::AllocKernArg(size_t size, size_t alignment) {
   return result;
 }
 
+address GraphKernelArgManager::AllocKernArg(size_t size, size_t alignment, const void* args,
+                                            size_t args_size) {
+  if (!args_reuse_ || (args_size == 0)) {
+    return AllocKernArg(size, alignment);
+  }
+  // The key holds the allocation size and the contents, since the tail of the segment
+  // beyond the contents isn't initialized
+  std::string key(reinterpret_cast<const char*>(&size), sizeof(size));
+  key.append(reinterpret_cast<const char*>(args), args_size);
+  auto it = kernarg_blobs_.find(key);
+  if ((it != kernarg_blobs_.end()) && amd::isMultipleOf(it->second, alignment)) {
+    shared_kernargs_.insert(it->second);
+    return it->second;
+  }
+  address result = AllocKernArg(size, alignment);
+  if (result != nullptr) {
+    kernarg_blobs_[std::move(key)] = result;
+  }
+  return result;
+}
+
 void GraphKernelArgManager::ReadBackOrFlush() {
   if (device_kernarg_pool_ && device_) {
     auto kernArgImpl = device_->settings().kernel_arg_impl_;
@@ -47,7 +47,35 @@ struct GraphExec;
 struct UserObject;
 typedef GraphNode* Node;
 hipError_t EnqueueGraphWithSingleList(std::vector<hip::Node>& topoOrder, hip::Stream* hip_stream,
-                                      hip::GraphExec* graphExec = nullptr);
+                                      hip::GraphExec* graphExec = nullptr,
+                                      amd::AccumulateCommand* accumulate = nullptr);
+
+//! Instantiate flag extension, which selects the critical path scheduler for the graph
+constexpr uint64_t kGraphInstantiateFlagCriticalPath = hipExtGraphInstantiateFlagCriticalPath;
+//! Instantiate flag extension, which tracks the launches without the callback markers
+constexpr uint64_t kGraphInstantiateFlagLaunchFastPath = hipExtGraphInstantiateFlagLaunchFastPath;
+//! All instantiate flag extensions
+constexpr uint64_t kGraphInstantiateFlagsExt =
+    kGraphInstantiateFlagCriticalPath | kGraphInstantiateFlagLaunchFastPath;
+//! Maximum number of the tracked launches in the fast path, before a launch waits
+constexpr size_t kGraphMaxPendingLaunches = 1024;
+
+//! Cost estimates, used by the critical path scheduler. The units are abstract and only
+//! compare the nodes against each other
+constexpr uint64_t kGraphDispatchCost = 16;   //!< Fixed cost of any command on a stream
+constexpr uint64_t kGraphSignalCost = 16;     //!< Cost of a cross stream dependency
+constexpr uint64_t kGraphHostNodeCost = 16 * kGraphDispatchCost; //!< Host callback round trip
+
+//! Graph optimization passes at instantiate time, selected with DEBUG_HIP_GRAPH_OPT_PASSES
+constexpr uint32_t kGraphOptEliminateNodes = 0x1;  //!< Remove empty nodes
+constexpr uint32_t kGraphOptCoalesceMemset = 0x2;  //!< Merge contiguous 1D memsets
+constexpr uint32_t kGraphOptCoalesceMemcpy = 0x4;  //!< Merge contiguous 1D copies
+constexpr uint32_t kGraphOptReduceEdges = 0x8;     //!< Transitive reduction of the edges
+constexpr uint32_t kGraphOptHoistHostNodes = 0x10; //!< Launch the root host nodes first
+//! The largest graph for the transitive reduction, which needs N^2 bits of memory
+constexpr size_t kGraphOptMaxReduceNodes = 8192;
+//! Offset of the kernel argument address in AQL kernel dispatch packet
+constexpr size_t kAqlKernargAddressOffset = 32;
 struct UserObject : public amd::ReferenceCountedObject {
   typedef void (*UserCallbackDestructor)(void* data);
   static std::unordered_set<UserObject*> ObjectSet_;
@@ -169,6 +197,35 @@ class GraphKernelArgManager : public amd::ReferenceCountedObject, public amd::Gr
   // If kernel arg pool is full allocate new chunck and alloc kern args from new pool.
   address AllocKernArg(size_t size, size_t alignment) override;
 
+  // Allocate kernel args for the given contents. Identical args are shared while the reuse
+  // is enabled.
+  address AllocKernArg(size_t size, size_t alignment, const void* args,
+                       size_t args_size) override;
+
+  // Enables the reuse of identical kernel args. The reuse must be disabled after the capture,
+  // since the later updates patch the args in place.
+  void EnableArgsReuse(bool enable) {
+    args_reuse_ = enable;
+    if (!enable) {
+      kernarg_blobs_.clear();
+    }
+  }
+
+  // Returns true if the kernel args are referenced by several packets
+  bool IsSharedKernArg(const void* args) const { return shared_kernargs_.count(args) != 0; }
+
+  // Returns the kernel args, which the GPU no longer reads, to the manager for reuse
+  void FreeKernArg(address args, size_t size) { free_kernargs_[size].push_back(args); }
+
+  // Returns the total size of the kernel arg pools
+  size_t PoolSize() const {
+    size_t size = 0;
+    for (const auto& element : kernarg_graph_) {
+      size += element.kernarg_pool_size_;
+    }
+    return size;
+  }
+
   // Do HDP flush/When HDP flush register is invalid fallback to Readback
   void ReadBackOrFlush();
 
@@ -181,6 +238,10 @@ class GraphKernelArgManager : public amd::ReferenceCountedObject, public amd::Gr
     size_t kernarg_pool_offset_;  //! Current offset in the kernel arg alloc
   };
   bool device_kernarg_pool_ = false;  //! Indicate if kernel pool in device mem
+  bool args_reuse_ = false;           //! Share the kernel args with identical contents
+  std::unordered_map<std::string, address> kernarg_blobs_;  //! Allocated args by contents
+  std::unordered_set<const void*> shared_kernargs_;  //! Args referenced by several packets
+  std::unordered_map<size_t, std::vector<address>> free_kernargs_;  //! Reusable args by size
   amd::Device* device_ = nullptr;     //! Device from where kernel arguments are allocated
   std::vector<KernelArgPoolGraph> kernarg_graph_;  //! Vector of allocated kernarg pool
   using KernelArgImpl = device::Settings::KernelArgImpl;
@@ -202,6 +263,11 @@ struct GraphNode : public hipGraphNodeDOTAttribute {
   size_t outDegree_;    //!< count of outgoing edges (@todo: remove, it's edges_.size())
   int32_t stream_id_ = -1;  //! Stream ID on which this node will be executed
   int32_t launch_id_ = -1;  //! Launch ID of this node in the entire graph execution sequence
+  uint64_t sched_cost_ = 0;   //!< Estimated cost of the node for the critical path scheduler
+  uint64_t sched_level_ = 0;  //!< The longest estimated path from this node to a leaf
+  uint64_t sched_finish_ = 0; //!< Estimated finish time of the node in the current schedule
+  size_t index_ = 0;          //!< Dense index of the node in the vertices of its graph
+  bool coalesced_ = false;    //!< The node runs the merged operations of several user nodes
   static int nextID;
   struct Graph* parentGraph_;
   static std::unordered_set<GraphNode*> nodeSet_;
@@ -324,9 +390,7 @@ struct GraphNode : public hipGraphNodeDOTAttribute {
   const std::vector<Node>& GetDependencies() const { return dependencies_; }
   /// Update graph node dependecies
   void SetDependencies(std::vector<Node>& dependencies) {
-    for (auto entry : dependencies) {
-      dependencies_.push_back(entry);
-    }
+    dependencies_.insert(dependencies_.end(), dependencies.begin(), dependencies.end());
   }
   /// Add graph node dependency
   void AddDependency(const Node& node) {
@@ -370,12 +434,22 @@ struct GraphNode : public hipGraphNodeDOTAttribute {
   const std::vector<Node>& GetEdges() const { return edges_; }
   /// Updates graph node children
   void SetEdges(std::vector<Node>& edges) {
-    for (auto entry : edges) {
-      edges_.push_back(entry);
-    }
+    edges_.insert(edges_.end(), edges.begin(), edges.end());
   }
   /// Get topological sort of the nodes embedded as part of the graphnode(e.g. ChildGraph)
   virtual bool TopologicalOrder(std::vector<Node>& TopoOrder) { return true; }
+  /// Returns the estimated execution cost of the node for the critical path scheduler
+  virtual uint64_t EstimateCost() const { return kGraphDispatchCost; }
+  /// Returns true if the node can be merged with another node of the same type
+  virtual bool CanCoalesce() const { return false; }
+  /// Merges the operation of the node into this one, if the ranges are contiguous
+  virtual bool Coalesce(const GraphNode* node) { return false; }
+  /// Returns true if the node runs the merged operations of several user nodes. The exec
+  /// updates of such node are rejected, since a new range of one user node can't be applied
+  /// without the ranges of the other user nodes
+  bool IsCoalesced() const { return coalesced_; }
+  /// Marks the node as the result of a merge
+  void SetCoalesced() { coalesced_ = true; }
   /// Update waitlist of the nodes embedded as part of the graphnode(e.g. ChildGraph)
   virtual void UpdateEventWaitLists(const amd::Command::EventWaitList& waitList) {
     for (auto command : commands_) {
@@ -480,6 +554,8 @@ struct Graph {
   unsigned int id_;
   static int nextID;
   int max_streams_ = 0;       //!< Maximum number of streams used in the graph launch
+  bool critical_path_schedule_ = false; //!< Use the critical path scheduler for the streams
+  uint64_t critical_path_cost_ = 0;     //!< Estimated cost of the graph critical path
   uint32_t memalloc_nodes_ = 0; //!< Count of unreleased Memalloc nodes
   std::vector<Node> roots_;   //!< Root nodes, used in parallel launches
   std::vector<Node> leafs_;   //!< The list of leaf nodes on every parallel stream
@@ -493,6 +569,18 @@ struct Graph {
   std::unordered_set<GraphNode*> capturedNodes_;
   bool graphInstantiated_;
   std::unordered_set<void*> memAllocNodePtrs_;
+
+  //! Statistics of one optimization pass at instantiate time
+  struct OptPassStats {
+    const char* name_;          //!< The name of the pass
+    size_t nodes_removed_ = 0;  //!< Number of removed or merged nodes
+    size_t nodes_moved_ = 0;    //!< Number of nodes, moved in the launch order
+    size_t edges_removed_ = 0;  //!< Number of removed edges
+    size_t edges_added_ = 0;    //!< Number of added edges
+    uint64_t time_ns_ = 0;      //!< Time spent in the pass
+    OptPassStats(const char* name) : name_(name) {}
+  };
+  std::vector<OptPassStats> opt_stats_;  //!< Statistics of the last optimization
  public:
   Graph(hip::Device* device, const Graph* original = nullptr)
       : pOriginalGraph_(original)
@@ -607,16 +695,55 @@ struct Graph {
   // Delete user obj resource from graph
   void RemoveUserObjGraph(UserObject* pUserObj) { graphUserObj_.erase(pUserObj); }
 
+  //! Node with the edges, which are still pending for scheduling
+  struct ScheduleFrame {
+    Node node_;       //!< Node, which was scheduled already
+    size_t edge_;     //!< Index of the next edge for scheduling
+    int stream_id_;   //!< Virtual stream for the next edge
+  };
+
+  //! Reassigns the dense indices of the vertices from the first changed position
+  void IndexNodes(size_t first);
+
   //! Schedules one node on a vitual stream.
-  //! It will also process the nodes in edges, using recursion
+  //! It will also process the nodes in edges, using an explicit stack instead of recursion
   void ScheduleOneNode(
     Node node,      //!< Node for scheduling on a virtual stream
-    int stream_id   //!< Current active virtual stream to use for scheduling
+    int stream_id,  //!< Current active virtual stream to use for scheduling
+    std::vector<ScheduleFrame>& stack  //!< Stack of the nodes with pending edges
     );
 
   //! Schedules all nodes in the graph into different streams
   void ScheduleNodes();
 
+  //! Selects the critical path scheduler instead of the round robin one
+  void SetCriticalPathSchedule(bool enable) { critical_path_schedule_ = enable; }
+
+  //! Estimates the cost of every node and returns the cost of the graph critical path
+  uint64_t EstimateCriticalPath(
+    const std::vector<Node>& order  //!< Nodes of the graph in topological order
+    );
+
+  //! Schedules the nodes in the order of their critical path and packs the branches
+  //! on the streams with the earliest estimated start, accounting the cross stream signals
+  void ScheduleCriticalPath();
+
+  //! Runs the optimization passes, enabled in the mask, on the instantiated graph.
+  //! The removed nodes are dropped from the map of cloned nodes
+  void Optimize(
+    uint32_t passes,  //!< Mask of kGraphOpt* passes
+    std::unordered_map<Node, Node>& clonedNodes  //!< Original to cloned nodes map
+    );
+
+  //! Returns the statistics of the last optimization
+  const std::vector<OptPassStats>& GetOptStats() const { return opt_stats_; }
+
+  //! Simulates the current schedule on the host with the estimated node costs
+  void SimulateSchedule(
+    uint64_t* makespan,   //!< Estimated execution time of the whole graph
+    uint32_t* waits       //!< Number of cross stream waits in the schedule
+    );
+
   //! Update streams for the graph execution
   void UpdateStreams(
     hip::Stream* launch_stream, //!< Launch stream from the application
@@ -742,14 +869,29 @@ struct GraphExec : public amd::ReferenceCountedObject {
   int instantiateDeviceId_ = -1;
   bool hasHiddenHeap_ = false;  //!< Hidden heap indicator for Kernel node
   bool repeatLaunch_ = false;
+  bool kernargs_patched_ = false;  //!< Kernel arguments were patched and require a flush
+  bool launch_fast_path_ = false;  //!< Launches are tracked without the callback markers
+  bool batch_dispatched_ = false;  //!< A launch of the current batch was dispatched
+  struct PendingLaunch {
+    amd::Command* command_;   //!< The last command of the launch
+    uint64_t launch_id_;      //!< Sequence number of the launch
+  };
+  std::vector<PendingLaunch> pending_launches_;  //!< Unfinished launches
+  uint64_t launch_id_ = 0;    //!< Sequence number of the last tracked launch
+  struct RetiredKernArgs {
+    address args_;            //!< Kernel args, replaced in the captured packet
+    size_t size_;             //!< Size of the kernel args
+    uint64_t launch_id_;      //!< The last launch, which can read the args
+  };
+  std::vector<RetiredKernArgs> retired_kernargs_;  //!< Replaced args, read by pending launches
 
  public:
-  GraphExec(std::vector<Node>& topoOrder, struct Graph*& clonedGraph,
-            std::unordered_map<Node, Node>& clonedNodes, uint64_t flags = 0)
+  GraphExec(std::vector<Node>&& topoOrder, struct Graph*& clonedGraph,
+            std::unordered_map<Node, Node>&& clonedNodes, uint64_t flags = 0)
       : ReferenceCountedObject(),
-        topoOrder_(topoOrder),
+        topoOrder_(std::move(topoOrder)),
         clonedGraph_(clonedGraph),
-        clonedNodes_(clonedNodes),
+        clonedNodes_(std::move(clonedNodes)),
         lastEnqueuedCommand_(nullptr),
         currentQueueIndex_(0),
         flags_(flags) {
@@ -758,6 +900,16 @@ struct GraphExec : public amd::ReferenceCountedObject {
   }
 
   ~GraphExec() {
+    // The fast path doesn't hold a reference during the launch. Destroy() defers the release
+    // until the launches are done, hence the wait is for the other releases only.
+    // Otherwise the last reference is released in the callback of the last launch and
+    // the markers can't be waited
+    for (auto& launch : pending_launches_) {
+      if (launch_fast_path_) {
+        launch.command_->awaitCompletion();
+      }
+      launch.command_->release();
+    }
     for (auto stream : parallel_streams_) {
       if (stream != nullptr) {
         stream->finish();
@@ -789,6 +941,10 @@ struct GraphExec : public amd::ReferenceCountedObject {
 
   //! Check executable graphs validity
   static bool isGraphExecValid(GraphExec* pGraphExec);
+  //! Releases the executable graph of the application. The launches of the fast path don't
+  //! hold a reference, so an exec with unfinished launches is released by the callback of
+  //! a marker after its last launch
+  static void Destroy(GraphExec* exec);
   std::vector<Node>& GetNodes() { return topoOrder_; }
 
   hip::Stream* GetAvailableStreams() {
@@ -803,9 +959,38 @@ struct GraphExec : public amd::ReferenceCountedObject {
   hipError_t Init();
   hipError_t CreateStreams(uint32_t num_streams);
   hipError_t Run(hipStream_t stream);
+  //! Launches the graph several times. The kernel node parameters of every launch are applied
+  //! before the launch, the same way as hipGraphExecKernelNodeSetParams()
+  hipError_t RunBatch(
+    hipStream_t stream,       //!< Launch stream from the application
+    uint32_t num_launches,    //!< Number of the graph launches
+    const std::vector<GraphKernelNode*>& nodes,  //!< Cloned kernel nodes for the update
+    const hipKernelNodeParams* params   //!< Parameters of the nodes, nodes.size() per launch
+    );
+  //! Marks the exec launched. Fails, if the launches repeat a graph with MemAlloc nodes
+  hipError_t CheckRepeatLaunch(uint32_t num_launches);
+  //! Initializes the hidden heap once, if the captured kernels use device side allocations
+  void InitHiddenHeap(hip::Stream* launch_stream);
+  //! Keeps the graph alive until the last launch on the stream is done
+  hipError_t TrackLaunch(hip::Stream* launch_stream);
   // Capture GPU Packets from graph commands
   hipError_t CaptureAQLPackets();
   hipError_t UpdateAQLPacket(hip::GraphNode* node);
+  //! Updates the kernel node with the new parameters. If only plain kernel arguments changed,
+  //! then the captured packets are patched instead of the full capture
+  hipError_t UpdateKernelNode(GraphKernelNode* node, const hipKernelNodeParams* params);
+  //! Makes the patched kernel arguments visible to the GPU
+  void FlushKernelArgs();
+  //! Returns true if a launch of the graph can be still in progress on the GPU
+  bool IsLaunchInFlight() { return batch_dispatched_ || (PendingLaunches() > 0); }
+  //! Tracks the launches by their last commands instead of the callback markers
+  void SetLaunchFastPath(bool enable) { launch_fast_path_ = enable; }
+  //! Releases the finished launches, recycles the kernel args, which only the finished
+  //! launches could read, and returns the number of pending launches
+  size_t PendingLaunches();
+  //! Keeps the kernel args, replaced in a captured packet, until the launches, which can read
+  //! them, are done
+  void RetireKernArgs(const std::vector<address>& args, size_t size);
   // Kenrel arg manger is for the entire graph.
   // Child graph also shares the same kernel arg manager object. some apps have 100's of
   // child graph nodes and each child graph has only one node.
@@ -816,6 +1001,8 @@ struct GraphExec : public amd::ReferenceCountedObject {
     return kernArgManager_;
   }
   static void DecrementRefCount(cl_event event, cl_int command_exec_status, void* user_data);
+  //! Releases the destroyed exec, when its last launch of the fast path is done
+  static void ReleaseDestroyed(cl_event event, cl_int command_exec_status, void* user_data);
 };
 
 struct ChildGraphNode : public GraphNode {
@@ -1213,6 +1400,145 @@ class GraphKernelNode : public GraphNode {
 
   void GetParams(hipKernelNodeParams* params) { *params = kernelParams_; }
 
+  uint64_t EstimateCost() const override {
+    // The cost grows with the number of wavefronts in the grid
+    uint64_t threads = static_cast<uint64_t>(kernelParams_.gridDim.x) * kernelParams_.gridDim.y *
+        kernelParams_.gridDim.z * kernelParams_.blockDim.x * kernelParams_.blockDim.y *
+        kernelParams_.blockDim.z;
+    return kGraphDispatchCost + threads / 1024;
+  }
+
+  //! Difference between the node parameters and the new ones
+  enum ParamsDiff {
+    kParamsSame = 0,  //!< The parameters are identical
+    kParamsArgs,      //!< Only the values of plain kernel arguments differ
+    kParamsLaunch     //!< The kernel, the launch configuration or special arguments differ
+  };
+
+  //! Returns the value of the kernel argument from the parameters
+  static const void* ArgValue(const hipKernelNodeParams& params,
+                              const amd::KernelParameterDescriptor& desc, uint32_t index) {
+    return (params.kernelParams != nullptr) ? params.kernelParams[index] :
+        reinterpret_cast<const char*>(params.extra[1]) + desc.offset_;
+  }
+
+  //! Returns true if the argument is copied into the kernel arguments without any processing
+  static bool IsPlainArg(const amd::KernelParameterDescriptor& desc) {
+    return (desc.info_.oclObject_ == amd::KernelParameterDescriptor::ValueObject) ||
+        ((desc.info_.oclObject_ == amd::KernelParameterDescriptor::MemoryObject) &&
+         (desc.addressQualifier_ != CL_KERNEL_ARG_ADDRESS_LOCAL));
+  }
+
+  //! Returns the size of the kernel arguments, passed in the extra parameters,
+  //! or 0 if the extra parameters have an unexpected layout
+  static size_t ExtraArgsSize(const hipKernelNodeParams& params) {
+    if ((params.extra[0] != HIP_LAUNCH_PARAM_BUFFER_POINTER) || (params.extra[1] == nullptr) ||
+        (params.extra[2] != HIP_LAUNCH_PARAM_BUFFER_SIZE) || (params.extra[3] == nullptr)) {
+      return 0;
+    }
+    return *reinterpret_cast<const size_t*>(params.extra[3]);
+  }
+
+  //! Compares the node parameters with the new ones
+  ParamsDiff CompareParams(const hipKernelNodeParams* params) const {
+    if ((params->func != kernelParams_.func) ||
+        (params->sharedMemBytes != kernelParams_.sharedMemBytes) ||
+        (params->gridDim.x != kernelParams_.gridDim.x) ||
+        (params->gridDim.y != kernelParams_.gridDim.y) ||
+        (params->gridDim.z != kernelParams_.gridDim.z) ||
+        (params->blockDim.x != kernelParams_.blockDim.x) ||
+        (params->blockDim.y != kernelParams_.blockDim.y) ||
+        (params->blockDim.z != kernelParams_.blockDim.z) ||
+        ((params->kernelParams == nullptr) != (kernelParams_.kernelParams == nullptr)) ||
+        ((params->extra == nullptr) != (kernelParams_.extra == nullptr))) {
+      return kParamsLaunch;
+    }
+    hipFunction_t func = getFunc(kernelParams_, ihipGetDevice());
+    if (func == nullptr) {
+      return kParamsLaunch;
+    }
+    const amd::KernelSignature& signature =
+        hip::DeviceFunc::asFunction(func)->kernel()->signature();
+    if ((signature.numParameters() > 0) && (params->kernelParams == nullptr) &&
+        (params->extra == nullptr)) {
+      return kParamsLaunch;
+    }
+    // The argument buffers must have the same size and cover all explicit arguments
+    if (params->kernelParams == nullptr) {
+      size_t size = ExtraArgsSize(*params);
+      size_t end = 0;
+      for (uint32_t i = 0; i < signature.numParameters(); ++i) {
+        end = std::max(end, signature.at(i).offset_ + signature.at(i).size_);
+      }
+      if ((size == 0) || (size != ExtraArgsSize(kernelParams_)) || (size < end)) {
+        return kParamsLaunch;
+      }
+    }
+    ParamsDiff diff = kParamsSame;
+    for (uint32_t i = 0; i < signature.numParameters(); ++i) {
+      const amd::KernelParameterDescriptor& desc = signature.at(i);
+      if (::memcmp(ArgValue(kernelParams_, desc, i), ArgValue(*params, desc, i),
+                   desc.size_) == 0) {
+        continue;
+      }
+      if (!IsPlainArg(desc)) {
+        return kParamsLaunch;
+      }
+      diff = kParamsArgs;
+    }
+    return diff;
+  }
+
+  //! Writes the current kernel arguments into the buffers of the captured packets.
+  //! If the GPU can still read the old buffers, then the arguments are copied to new ones
+  //! and the old buffers are returned in retired
+  bool PatchCapturedArgs(GraphKernelArgManager* kernArgMgr, bool copy,
+                         std::vector<address>& retired) {
+    hipFunction_t func = getFunc(kernelParams_, ihipGetDevice());
+    if ((func == nullptr) || gpuPackets_.empty()) {
+      return false;
+    }
+    const amd::KernelSignature& signature =
+        hip::DeviceFunc::asFunction(func)->kernel()->signature();
+    // The args, shared with other packets, can't be modified in place. Allocate all copies
+    // first, so a failed allocation leaves the packets unchanged for the full capture
+    std::vector<address> copies(gpuPackets_.size(), nullptr);
+    for (size_t p = 0; p < gpuPackets_.size(); ++p) {
+      address args = nullptr;
+      ::memcpy(&args, gpuPackets_[p] + kAqlKernargAddressOffset, sizeof(args));
+      if (copy || kernArgMgr->IsSharedKernArg(args)) {
+        copies[p] = kernArgMgr->AllocKernArg(kernargSegmentByteSize_, kernargSegmentAlignment_);
+        if (copies[p] == nullptr) {
+          for (size_t i = 0; i < p; ++i) {
+            if (copies[i] != nullptr) {
+              kernArgMgr->FreeKernArg(copies[i], kernargSegmentByteSize_);
+            }
+          }
+          return false;
+        }
+      }
+    }
+    for (size_t p = 0; p < gpuPackets_.size(); ++p) {
+      uint8_t* packet = gpuPackets_[p];
+      address args = nullptr;
+      ::memcpy(&args, packet + kAqlKernargAddressOffset, sizeof(args));
+      if (copies[p] != nullptr) {
+        ::memcpy(copies[p], args, kernargSegmentByteSize_);
+        ::memcpy(packet + kAqlKernargAddressOffset, &copies[p], sizeof(copies[p]));
+        // The shared args remain in use by other packets
+        if (!kernArgMgr->IsSharedKernArg(args)) {
+          retired.push_back(args);
+        }
+        args = copies[p];
+      }
+      for (uint32_t i = 0; i < signature.numParameters(); ++i) {
+        const amd::KernelParameterDescriptor& desc = signature.at(i);
+        ::memcpy(args + desc.offset_, ArgValue(kernelParams_, desc, i), desc.size_);
+      }
+    }
+    return true;
+  }
+
   hipError_t SetParams(const hipKernelNodeParams* params) {
     hipFunction_t func = getFunc(kernelParams_, ihipGetDevice());
     if (!func) {
@@ -1364,6 +1690,12 @@ class GraphMemcpyNode : public GraphNode {
   }
   ~GraphMemcpyNode() {}
 
+  uint64_t EstimateCost() const override {
+    size_t bytes = copyParams_.extent.width * copyParams_.extent.height *
+        copyParams_.extent.depth;
+    return kGraphDispatchCost + bytes / (64 * Ki);
+  }
+
   GraphMemcpyNode(const GraphMemcpyNode& rhs) : GraphNode(rhs) {
     copyParams_ = rhs.copyParams_;
   }
@@ -1536,6 +1868,48 @@ class GraphMemcpyNode1D : public GraphMemcpyNode {
 
   ~GraphMemcpyNode1D() {}
 
+  uint64_t EstimateCost() const override { return kGraphDispatchCost + count_ / (64 * Ki); }
+
+  bool CanCoalesce() const override { return isEnabled_; }
+
+  bool Coalesce(const GraphNode* node) override {
+    const GraphMemcpyNode1D* next = static_cast<GraphMemcpyNode1D const*>(node);
+    if (next->kind_ != kind_) {
+      return false;
+    }
+    char* dst = reinterpret_cast<char*>(dst_);
+    const char* src = reinterpret_cast<const char*>(src_);
+    char* next_dst = reinterpret_cast<char*>(next->dst_);
+    const char* next_src = reinterpret_cast<const char*>(next->src_);
+    if ((dst + count_ == next_dst) && (src + count_ == next_src)) {
+      // The next copy follows this one
+    } else if ((next_dst + next->count_ == dst) && (next_src + next->count_ == src)) {
+      dst = next_dst;
+      src = next_src;
+    } else {
+      return false;
+    }
+    size_t count = count_ + next->count_;
+    // The merged copy can't overlap with its own source
+    if ((dst < src + count) && (src < dst + count)) {
+      return false;
+    }
+    // A single command can't cross the allocation boundary. The adjacent host allocations,
+    // unknown to the runtime, can't be told apart, hence both sides must be known memory
+    size_t discardOffset = 0;
+    amd::Memory* dstObj = getMemoryObject(dst_, discardOffset);
+    amd::Memory* srcObj = getMemoryObject(src_, discardOffset);
+    if ((dstObj == nullptr) || (srcObj == nullptr) ||
+        (dstObj != getMemoryObject(next->dst_, discardOffset)) ||
+        (srcObj != getMemoryObject(next->src_, discardOffset))) {
+      return false;
+    }
+    dst_ = dst;
+    src_ = src;
+    count_ = count;
+    return true;
+  }
+
   GraphNode* clone() const override {
     return new GraphMemcpyNode1D(static_cast<GraphMemcpyNode1D const&>(*this));
   }
@@ -1736,6 +2110,8 @@ class GraphMemcpyNodeFromSymbol : public GraphMemcpyNode1D {
         static_cast<GraphMemcpyNodeFromSymbol const&>(*this));
   }
 
+  bool CanCoalesce() const override { return false; }
+
   virtual hipError_t CreateCommand(hip::Stream* stream) override {
     hipError_t status = GraphNode::CreateCommand(stream);
     if (status != hipSuccess) {
@@ -1828,6 +2204,8 @@ class GraphMemcpyNodeToSymbol : public GraphMemcpyNode1D {
     return new GraphMemcpyNodeToSymbol(static_cast<GraphMemcpyNodeToSymbol const&>(*this));
   }
 
+  bool CanCoalesce() const override { return false; }
+
   virtual hipError_t CreateCommand(hip::Stream* stream) override {
     hipError_t status = GraphNode::CreateCommand(stream);
     if (status != hipSuccess) {
@@ -1942,6 +2320,42 @@ class GraphMemsetNode : public GraphNode {
     return new GraphMemsetNode(static_cast<GraphMemsetNode const&>(*this));
   }
 
+  uint64_t EstimateCost() const override {
+    size_t bytes = memsetParams_.width * memsetParams_.height * depth_ * memsetParams_.elementSize;
+    return kGraphDispatchCost + bytes / (256 * Ki);
+  }
+
+  bool CanCoalesce() const override {
+    return isEnabled_ && (memsetParams_.height == 1) && (depth_ == 1);
+  }
+
+  bool Coalesce(const GraphNode* node) override {
+    const GraphMemsetNode* next = static_cast<GraphMemsetNode const*>(node);
+    if ((next->memsetParams_.value != memsetParams_.value) ||
+        (next->memsetParams_.elementSize != memsetParams_.elementSize)) {
+      return false;
+    }
+    char* dst = reinterpret_cast<char*>(memsetParams_.dst);
+    char* next_dst = reinterpret_cast<char*>(next->memsetParams_.dst);
+    if (dst + memsetParams_.width * memsetParams_.elementSize == next_dst) {
+      // The next memset follows this one
+    } else if (next_dst + next->memsetParams_.width * memsetParams_.elementSize == dst) {
+      dst = next_dst;
+    } else {
+      return false;
+    }
+    // A single command can't cross the allocation boundary
+    size_t discardOffset = 0;
+    amd::Memory* memObj = getMemoryObject(memsetParams_.dst, discardOffset);
+    if ((memObj == nullptr) ||
+        (memObj != getMemoryObject(next->memsetParams_.dst, discardOffset))) {
+      return false;
+    }
+    memsetParams_.dst = dst;
+    memsetParams_.width += next->memsetParams_.width;
+    return true;
+  }
+
   virtual std::string GetLabel(hipGraphDebugDotFlags flag) override {
     std::string label;
     if (flag == hipGraphDebugDotFlagsMemsetNodeParams || flag == hipGraphDebugDotFlagsVerbose) {
@@ -2221,6 +2635,8 @@ class GraphHostNode : public GraphNode {
     return new GraphHostNode(static_cast<GraphHostNode const&>(*this));
   }
 
+  uint64_t EstimateCost() const override { return kGraphHostNodeCost; }
+
   hipError_t CreateCommand(hip::Stream* stream) override {
     hipError_t status = GraphNode::CreateCommand(stream);
     if (status != hipSuccess) {
@@ -304,6 +304,7 @@ public:
 
   class Device;
   class MemoryPool;
+  class TrimWorker;
   class Event;
   class Stream : public amd::HostQueue {
   public:
@@ -511,6 +512,7 @@ public:
     MemoryPool* graph_mem_pool_;    //!< Memory pool, associated with graphs for this device
 
     std::set<MemoryPool*> mem_pools_;
+    TrimWorker* trim_worker_;       //!< Background release of freed memory in the pools
 
   public:
     Device(amd::Context* ctx, int devId): context_(ctx),
@@ -519,7 +521,8 @@ public:
         isActive_(false),
         default_mem_pool_(nullptr),
         current_mem_pool_(nullptr),
-        graph_mem_pool_(nullptr)
+        graph_mem_pool_(nullptr),
+        trim_worker_(nullptr)
         { assert(ctx != nullptr); }
     ~Device();
 
@@ -584,6 +587,9 @@ public:
     /// Get the graph memory pool on the device
     MemoryPool* GetGraphMemoryPool() const { return graph_mem_pool_; }
 
+    /// Get the background trim worker of the memory pools. nullptr if trim is done inline
+    TrimWorker* GetTrimWorker() const { return trim_worker_; }
+
     /// Add memory pool to the device
     void AddMemoryPool(MemoryPool* pool);
 
@@ -25,59 +25,373 @@
 namespace hip {
 
 // ================================================================================================
-void Heap::AddMemory(amd::Memory* memory, Stream* stream) {
-  auto mem_size = memory->getSize();
-  allocations_.insert({{mem_size, memory}, {stream}});
-  total_size_ += mem_size;
-  max_total_size_ = std::max(max_total_size_, total_size_);
+static void SetPeerAccess(amd::Memory* memory, hip::Device* device, bool enable) {
+  auto peer_device = device->asContext()->devices()[0];
+  device::Memory* mem = memory->getDeviceMemory(*peer_device);
+  if (mem != nullptr) {
+    if (!mem->getAllowedPeerAccess() && enable) {
+      // Enable p2p access for the specified device
+      peer_device->allowPeerAccess(mem);
+      mem->setAllowedPeerAccess(true);
+    } else if (mem->getAllowedPeerAccess() && !enable) {
+      mem->setAllowedPeerAccess(false);
+    }
+  } else {
+    LogError("Couldn't find device memory for P2P access");
+  }
+}
+
+// ================================================================================================
+SubAllocator::~SubAllocator() {
+  // The pool returns all views into the chunks on destruction. A live view here would point
+  // to a released chunk
+  if (carved_size_ != 0) {
+    LogPrintfError("Pool suballocator destroyed with %zu bytes of live views", carved_size_);
+    assert(!"Pool suballocator destroyed with live views");
+  }
+  for (auto it = chunks_.begin(); it != chunks_.end();) {
+    it = ReleaseChunk(it);
+  }
+}
+
+// ================================================================================================
+void SubAllocator::AddChunk(amd::Memory* chunk) {
+  // Hide the chunk from MemObjMap, since only the views are valid pointers for the app
+  amd::MemObjMap::RemoveMemObj(chunk->getSvmPtr());
+  auto it = chunks_.emplace(chunk, Chunk()).first;
+  it->second.free_[0] = chunk->getSize();
+  free_blocks_.insert({chunk->getSize(), chunk, 0});
+  reserved_size_ += chunk->getSize();
+  ClPrint(amd::LOG_INFO, amd::LOG_MEM_POOL, "Pool AddChunk: %p, reserved: %zu, carved: %zu",
+          chunk->getSvmPtr(), reserved_size_, carved_size_);
+}
+
+// ================================================================================================
+amd::Memory* SubAllocator::Allocate(size_t size) {
+  size = amd::alignUp(size, kAlignment);
+  // Find the smallest free block, which fits the requested size
+  auto block = free_blocks_.lower_bound({size, nullptr, 0});
+  if (block == free_blocks_.end()) {
+    return nullptr;
+  }
+  auto [block_size, parent, offset] = *block;
+  free_blocks_.erase(block);
+  auto chunk = chunks_.find(parent);
+  chunk->second.free_.erase(offset);
+  if (block_size > size) {
+    chunk->second.free_[offset + size] = block_size - size;
+    free_blocks_.insert({block_size - size, parent, offset + size});
+  }
+
+  amd::Memory* memory = new (parent->getContext())
+      amd::Buffer(*parent, parent->getMemFlags(), offset, size);
+  if ((memory != nullptr) && !memory->create(nullptr)) {
+    memory->release();
+    memory = nullptr;
+  }
+  if (memory == nullptr) {
+    InsertFree(chunk, offset, size);
+    return nullptr;
+  }
+  memory->getUserData().deviceId = parent->getUserData().deviceId;
+  amd::MemObjMap::AddMemObj(memory->getSvmPtr(), memory);
+  chunk->second.used_ += size;
+  carved_size_ += size;
+  return memory;
+}
+
+// ================================================================================================
+bool SubAllocator::Free(amd::Memory* memory) {
+  if (memory->parent() == nullptr) {
+    return false;
+  }
+  auto chunk = chunks_.find(memory->parent());
+  if (chunk == chunks_.end()) {
+    return false;
+  }
+  size_t offset = memory->getOrigin();
+  size_t size = memory->getSize();
+  amd::MemObjMap::RemoveMemObj(memory->getSvmPtr());
+  memory->release();
+
+  chunk->second.used_ -= size;
+  carved_size_ -= size;
+  InsertFree(chunk, offset, size);
+  return true;
+}
+
+// ================================================================================================
+void SubAllocator::InsertFree(ChunkMap::iterator chunk, size_t offset, size_t size) {
+  auto& free = chunk->second.free_;
+  auto next = free.lower_bound(offset);
+  // Coalesce with the following free block
+  if ((next != free.end()) && ((offset + size) == next->first)) {
+    free_blocks_.erase({next->second, chunk->first, next->first});
+    size += next->second;
+    next = free.erase(next);
+  }
+  // Coalesce with the preceding free block
+  if (next != free.begin()) {
+    auto prev = std::prev(next);
+    if ((prev->first + prev->second) == offset) {
+      free_blocks_.erase({prev->second, chunk->first, prev->first});
+      offset = prev->first;
+      size += prev->second;
+      free.erase(prev);
+    }
+  }
+  free[offset] = size;
+  free_blocks_.insert({size, chunk->first, offset});
+}
+
+// ================================================================================================
+SubAllocator::ChunkMap::iterator SubAllocator::ReleaseChunk(ChunkMap::iterator chunk) {
+  amd::Memory* memory = chunk->first;
+  free_blocks_.erase({memory->getSize(), memory, 0});
+  reserved_size_ -= memory->getSize();
+  ClPrint(amd::LOG_INFO, amd::LOG_MEM_POOL, "Pool ReleaseChunk: %p, reserved: %zu, carved: %zu",
+          memory->getSvmPtr(), reserved_size_, carved_size_);
+  // SVM free looks up the memory object in MemObjMap, hence restore the chunk
+  amd::MemObjMap::AddMemObj(memory->getSvmPtr(), memory);
+  amd::SvmBuffer::free(memory->getContext(), memory->getSvmPtr());
+  return chunks_.erase(chunk);
+}
+
+// ================================================================================================
+void SubAllocator::Trim(size_t bytes_to_hold) {
+  for (auto it = chunks_.begin(); it != chunks_.end();) {
+    if (reserved_size_ <= bytes_to_hold) {
+      break;
+    }
+    if (it->second.used_ == 0) {
+      it = ReleaseChunk(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// ================================================================================================
+void SubAllocator::SetAccess(hip::Device* device, bool enable) {
+  for (const auto& it : chunks_) {
+    SetPeerAccess(it.first, device, enable);
+  }
+}
+
+// ================================================================================================
+void Heap::IndexAdd(const Key& key, const MemoryTimestamp& ts) {
+  if (!indexed_) {
+    return;
+  }
+  for (auto stream : ts.safe_streams_) {
+    stream_index_[stream].insert(key);
+  }
+  if (ts.event_ == nullptr) {
+    released_.insert(key);
+  }
+}
+
+// ================================================================================================
+void Heap::IndexRemove(const Key& key, const MemoryTimestamp& ts) {
+  if (!indexed_) {
+    return;
+  }
+  for (auto stream : ts.safe_streams_) {
+    auto it = stream_index_.find(stream);
+    if (it != stream_index_.end()) {
+      it->second.erase(key);
+      if (it->second.empty()) {
+        stream_index_.erase(it);
+      }
+    }
+  }
+  if (ts.event_ == nullptr) {
+    released_.erase(key);
+  }
+}
+
+// ================================================================================================
+void Heap::ForgetLastFreed(SortedMap::iterator it) {
+  // Only the safe streams of the allocation can refer to it
+  for (auto stream : it->second.safe_streams_) {
+    auto last = last_freed_.find(stream);
+    if ((last != last_freed_.end()) && (last->second == it)) {
+      last_freed_.erase(last);
+    }
+  }
+}
+
+// ================================================================================================
+void Heap::SampleScan(size_t blocks) {
+  // A long walk is counted up to the cap only, so the sample stays cheap with the indexes
+  scan_blocks_ += std::min(blocks, kIndexMaxSampleBlocks);
+  scan_samples_++;
+}
+
+// ================================================================================================
+size_t Heap::ScanLength(const Key& key, Stream* stream) {
+  size_t blocks = 0;
+  for (auto it = allocations_.lower_bound(key); it != allocations_.end(); ++it) {
+    if ((++blocks >= kIndexMaxSampleBlocks) || it->second.IsSafeFind(stream, false)) {
+      break;
+    }
+  }
+  return blocks;
+}
+
+// ================================================================================================
+void Heap::UpdateIndexes() {
+  // The linear scan is faster, unless the lookups walk many blocks on average: the misses
+  // walk all bigger blocks, and the hits walk all bigger blocks, which aren't safe. The
+  // lower bound to drop the indexes avoids rebuilds on every window
+  const size_t min_blocks = indexed_ ? kIndexMinScanBlocks / 2 : kIndexMinScanBlocks;
+  const bool index = (scan_blocks_ >= scan_samples_ * min_blocks);
+  lookups_ = 0;
+  scan_blocks_ = 0;
+  scan_samples_ = 0;
+  if (index == indexed_) {
+    return;
+  }
+  if (index) {
+    indexed_ = true;
+    for (const auto& it : allocations_) {
+      IndexAdd(it.first, it.second);
+    }
+  } else {
+    indexed_ = false;
+    stream_index_.clear();
+    released_.clear();
+  }
 }
 
 // ================================================================================================
 void Heap::AddMemory(amd::Memory* memory, const MemoryTimestamp& ts) {
   auto mem_size = memory->getSize();
-  allocations_.insert({{mem_size, memory}, ts});
+  auto result = allocations_.insert({{mem_size, memory}, ts});
+  if (result.second) {
+    IndexAdd(result.first->first, result.first->second);
+    for (auto stream : result.first->second.safe_streams_) {
+      last_freed_[stream] = result.first;
+    }
+  }
   total_size_ += mem_size;
   max_total_size_ = std::max(max_total_size_, total_size_);
 }
 
+// ================================================================================================
+amd::Memory* Heap::TakeMemory(SortedMap::iterator it, MemoryTimestamp* ts) {
+  amd::Memory* memory = it->first.second;
+  total_size_ -= memory->getSize();
+  // Preserve event, since the logic could skip GPU wait on reuse
+  ts->event_ = it->second.event_;
+  // Remove found allocation from the map
+  IndexRemove(it->first, it->second);
+  ForgetLastFreed(it);
+  allocations_.erase(it);
+  return memory;
+}
+
 // ================================================================================================
 amd::Memory* Heap::FindMemory(size_t size, Stream* stream, bool opportunistic,
     void* dptr, MemoryTimestamp* ts) {
-  amd::Memory* memory = nullptr;
-  auto start = allocations_.lower_bound({size, nullptr});
-  for (auto it = start; it != allocations_.end();) {
-    bool check_address = (dptr == nullptr);
-    if (it->first.second->getSvmPtr() == dptr) {
-      // If the search is done for the specified address then runtime must wait
-      it->second.Wait();
-      check_address = true;
-    }
-    // Runtime can accept an allocation with 12.5% on the size threshold
-    bool opp_mode = opportunistic;
-    if (it->first.first > (size / 8.0) * 9) {
-      // Disable opportunistic mode for more aggressive search
-      opp_mode = false;
-    }
-    // Check if size can match and it's safe to use this resource.
-    if (check_address && (it->second.IsSafeFind(stream, opp_mode))) {
-      memory = it->first.second;
-      total_size_ -= memory->getSize();
-      // Preserve event, since the logic could skip GPU wait on reuse
-      ts->event_ = it->second.event_;
-      // Remove found allocation from the map
-      it = allocations_.erase(it);
-      break;
-    } else {
-      ++it;
+  const Key key = {size, nullptr};
+  if (dptr != nullptr) {
+    // The search is done for the specified address
+    for (auto it = allocations_.lower_bound(key); it != allocations_.end(); ++it) {
+      if (it->first.second->getSvmPtr() == dptr) {
+        // Runtime must wait for the allocation with the specified address
+        it->second.Wait();
+        bool opp_mode = opportunistic && (it->first.first <= (size / 8.0) * 9);
+        return it->second.IsSafeFind(stream, opp_mode) ? TakeMemory(it, ts) : nullptr;
+      }
     }
+    return nullptr;
+  }
+
+  amd::Memory* memory = FindSafeMemory(size, stream, opportunistic, ts);
+  // The update follows the lookup, since it can drop the indexes, which the lookup holds keys of
+  if (lookups_ >= kIndexWindow) {
+    UpdateIndexes();
   }
   return memory;
 }
 
+// ================================================================================================
+amd::Memory* Heap::FindSafeMemory(size_t size, Stream* stream, bool opportunistic,
+    MemoryTimestamp* ts) {
+  const Key key = {size, nullptr};
+  // Runtime can accept an allocation with 12.5% on the size threshold in opportunistic mode
+  const double max_size = (size / 8.0) * 9;
+  // The linear scan is measured on every lookup without the indexes and on a sample of
+  // the lookups with them
+  const bool sample = !indexed_ || ((lookups_ % kIndexSampleRate) == 0);
+  lookups_++;
+
+  // The last allocation, freed on the stream, is safe for it. A loop of the same allocation
+  // size on a stream reuses it without a search, if it isn't over the size threshold
+  auto last = last_freed_.find(stream);
+  if ((last != last_freed_.end()) && (last->second->first.first >= size) &&
+      (last->second->first.first <= max_size)) {
+    if (sample) {
+      SampleScan(0);
+    }
+    return TakeMemory(last->second, ts);
+  }
+
+  if (!indexed_) {
+    size_t blocks = 0;
+    for (auto it = allocations_.lower_bound(key); it != allocations_.end(); ++it) {
+      blocks++;
+      bool opp_mode = opportunistic && (it->first.first <= max_size);
+      if (it->second.IsSafeFind(stream, opp_mode)) {
+        SampleScan(blocks);
+        return TakeMemory(it, ts);
+      }
+    }
+    SampleScan(blocks);
+    return nullptr;
+  }
+
+  if (sample) {
+    SampleScan(ScanLength(key, stream));
+  }
+
+  // The smallest allocation, which is safe without a HIP event query: either the stream
+  // can reuse it or it doesn't have any pending work
+  const Key* best = nullptr;
+  auto safe = stream_index_.find(stream);
+  if (safe != stream_index_.end()) {
+    auto it = safe->second.lower_bound(key);
+    if (it != safe->second.end()) {
+      best = &(*it);
+    }
+  }
+  auto released = released_.lower_bound(key);
+  if ((released != released_.end()) && ((best == nullptr) || (*released < *best))) {
+    best = &(*released);
+  }
+
+  // Only smaller allocations than the best safe one require HIP event validation
+  if (opportunistic) {
+    for (auto it = allocations_.lower_bound(key); it != allocations_.end(); ++it) {
+      if ((it->first.first > max_size) || ((best != nullptr) && !(it->first < *best))) {
+        break;
+      }
+      if (it->second.IsSafeFind(stream, opportunistic)) {
+        return TakeMemory(it, ts);
+      }
+    }
+  }
+
+  return (best != nullptr) ? TakeMemory(allocations_.find(*best), ts) : nullptr;
+}
+
 // ================================================================================================
 bool Heap::RemoveMemory(amd::Memory* memory, MemoryTimestamp* ts) {
   auto mem_size = memory->getSize();
   if (auto it = allocations_.find({mem_size, memory}); it != allocations_.end()) {
+    IndexRemove(it->first, it->second);
+    ForgetLastFreed(it);
     if (ts != nullptr) {
       // Preserve timestamp info for possible reuse later
       *ts = it->second;
@@ -91,14 +405,50 @@ bool Heap::RemoveMemory(amd::Memory* memory, MemoryTimestamp* ts) {
   return false;
 }
 
+// ================================================================================================
+void Heap::AddSafeStream(Stream* event_stream, Stream* wait_stream) {
+  if (event_stream == wait_stream) {
+    return;
+  }
+  if (!indexed_) {
+    for (auto& it : allocations_) {
+      it.second.AddSafeStream(event_stream, wait_stream);
+    }
+    return;
+  }
+  // Only allocations, which are safe on the event stream, become safe on the wait stream
+  auto safe = stream_index_.find(event_stream);
+  if (safe == stream_index_.end()) {
+    return;
+  }
+  // Note: rehash on insertion invalidates iterators, but not references
+  const auto& safe_index = safe->second;
+  auto& wait_index = stream_index_[wait_stream];
+  // Both the safe index and the allocations are sorted by the key, hence walk them together
+  // and insert into the wait index with a hint, instead of a tree search per allocation
+  auto alloc = allocations_.begin();
+  auto hint = wait_index.begin();
+  for (const auto& key : safe_index) {
+    while (alloc->first < key) {
+      ++alloc;
+    }
+    alloc->second.AddSafeStream(event_stream, wait_stream);
+    hint = std::next(wait_index.insert(hint, key));
+  }
+}
+
 // ================================================================================================
 Heap::SortedMap::iterator Heap::EraseAllocaton(Heap::SortedMap::iterator& it) {
   auto memory = it->first.second;
   const device::Memory* dev_mem = memory->getDeviceMemory(*device_->devices()[0]);
   void* dev_mem_vaddr = reinterpret_cast<void*>(dev_mem->virtualAddress());
   total_size_ -= it->first.first;
-  
-  if (dev_mem_vaddr != nullptr) {
+  IndexRemove(it->first, it->second);
+  ForgetLastFreed(it);
+
+  if ((suballoc_ != nullptr) && suballoc_->Free(memory)) {
+    // The view was returned into its chunk
+  } else if (dev_mem_vaddr != nullptr) {
     amd::SvmBuffer::free(memory->getContext(), dev_mem_vaddr);
   } else {
     amd::SvmBuffer::free(memory->getContext(), memory->getSvmPtr());
@@ -147,30 +497,70 @@ bool Heap::ReleaseAllMemory() {
 
 // ================================================================================================
 void Heap::RemoveStream(Stream* stream) {
-  for (auto it : allocations_) {
-    it.second.safe_streams_.erase(stream);
+  last_freed_.erase(stream);
+  if (!indexed_) {
+    for (auto& it : allocations_) {
+      it.second.safe_streams_.erase(stream);
+    }
+    return;
+  }
+  auto safe = stream_index_.find(stream);
+  if (safe != stream_index_.end()) {
+    for (const auto& key : safe->second) {
+      allocations_[key].safe_streams_.erase(stream);
+    }
+    stream_index_.erase(safe);
   }
 }
 
 // ================================================================================================
 void Heap::SetAccess(hip::Device* device, bool enable) {
   for (const auto& it : allocations_) {
-    auto peer_device = device->asContext()->devices()[0];
-    device::Memory* mem = it.first.second->getDeviceMemory(*peer_device);
-    if (mem != nullptr) {
-      if (!mem->getAllowedPeerAccess() && enable) {
-        // Enable p2p access for the specified device
-        peer_device->allowPeerAccess(mem);
-        mem->setAllowedPeerAccess(true);
-      } else if (mem->getAllowedPeerAccess() && !enable) {
-        mem->setAllowedPeerAccess(false);
-      }
-    } else {
-      LogError("Couldn't find device memory for P2P access");
+    // Suballocations share the access of their chunk
+    if ((suballoc_ != nullptr) && (it.first.second->parent() != nullptr)) {
+      continue;
     }
+    SetPeerAccess(it.first.second, device, enable);
   }
 }
 
+// ================================================================================================
+amd::Memory* MemoryPool::AllocateDeviceMemory(size_t size) {
+  amd::Context* context = device_->asContext();
+  const auto& dev_info = context->devices()[0]->info();
+  if (dev_info.maxMemAllocSize_ < size) {
+    return nullptr;
+  }
+  cl_svm_mem_flags flags = (state_.interprocess_) ? ROCCLR_MEM_INTERPROCESS : 0;
+  flags |= (state_.phys_mem_) ? ROCCLR_MEM_PHYMEM : 0;
+  void* dev_ptr = amd::SvmBuffer::malloc(*context, flags, size, dev_info.memBaseAddrAlign_, nullptr);
+  if (dev_ptr == nullptr) {
+    size_t free = 0, total =0;
+    hipError_t err = hipMemGetInfo(&free, &total);
+    if (err == hipSuccess) {
+      LogPrintfError("Allocation failed : Device memory : required :%zu | free :%zu | total :%zu",
+        size, free, total);
+    }
+    return nullptr;
+  }
+
+  size_t offset = 0;
+  amd::Memory* memory = getMemoryObject(dev_ptr, offset);
+  // Saves the current device id so that it can be accessed later
+  memory->getUserData().deviceId = device_->deviceId();
+
+  // Update access for the new allocation from other devices
+  for (const auto& it : access_map_) {
+    auto vdi_device = it.first->asContext()->devices()[0];
+    device::Memory* mem = memory->getDeviceMemory(*vdi_device);
+    if ((mem != nullptr) && (it.second != hipMemAccessFlagsProtNone)) {
+      vdi_device->allowPeerAccess(mem);
+      mem->setAllowedPeerAccess(true);
+    }
+  }
+  return memory;
+}
+
 // ================================================================================================
 void* MemoryPool::AllocateMemory(size_t size, Stream* stream, void* dptr) {
   amd::ScopedLock lock(lock_pool_ops_);
@@ -179,41 +569,35 @@ void* MemoryPool::AllocateMemory(size_t size, Stream* stream, void* dptr) {
   MemoryTimestamp ts;
   amd::Memory* memory = free_heap_.FindMemory(size, stream, Opportunistic(), dptr, &ts);
   if (memory == nullptr) {
-    if (Properties().maxSize != 0 && (max_total_size_ + size) > Properties().maxSize) {
-      return nullptr;
-    }
-    amd::Context* context = device_->asContext();
-    const auto& dev_info = context->devices()[0]->info();
-    if (dev_info.maxMemAllocSize_ < size) {
-      return nullptr;
-    }
-    cl_svm_mem_flags flags = (state_.interprocess_) ? ROCCLR_MEM_INTERPROCESS : 0;
-    flags |= (state_.phys_mem_) ? ROCCLR_MEM_PHYMEM : 0;
-    dev_ptr = amd::SvmBuffer::malloc(*context, flags, size, dev_info.memBaseAddrAlign_, nullptr);
-    if (dev_ptr == nullptr) {
-      size_t free = 0, total =0;
-      hipError_t err = hipMemGetInfo(&free, &total);
-      if (err == hipSuccess) {
-        LogPrintfError("Allocation failed : Device memory : required :%zu | free :%zu | total :%zu",
-          size, free, total);
+    if ((dptr == nullptr) && suballoc_.IsSuballocSize(size)) {
+      // Carve small allocations from the chunks to avoid a device allocation per pointer
+      memory = suballoc_.Allocate(size);
+      if (memory == nullptr) {
+        size_t chunk_size = suballoc_.ChunkSize();
+        if (Properties().maxSize != 0 && (max_total_size_ + chunk_size) > Properties().maxSize) {
+          return nullptr;
+        }
+        amd::Memory* chunk = AllocateDeviceMemory(chunk_size);
+        if (chunk == nullptr) {
+          return nullptr;
+        }
+        suballoc_.AddChunk(chunk);
+        memory = suballoc_.Allocate(size);
+        if (memory == nullptr) {
+          suballoc_.Trim(0);
+          return nullptr;
+        }
       }
-      return nullptr;
-    }
-
-    size_t offset = 0;
-    memory = getMemoryObject(dev_ptr, offset);
-    // Saves the current device id so that it can be accessed later
-    memory->getUserData().deviceId = device_->deviceId();
-
-    // Update access for the new allocation from other devices
-    for (const auto& it : access_map_) {
-      auto vdi_device = it.first->asContext()->devices()[0];
-      device::Memory* mem = memory->getDeviceMemory(*vdi_device);
-      if ((mem != nullptr) && (it.second != hipMemAccessFlagsProtNone)) {
-        vdi_device->allowPeerAccess(mem);
-        mem->setAllowedPeerAccess(true);
+    } else {
+      if (Properties().maxSize != 0 && (max_total_size_ + size) > Properties().maxSize) {
+        return nullptr;
+      }
+      memory = AllocateDeviceMemory(size);
+      if (memory == nullptr) {
+        return nullptr;
       }
     }
+    dev_ptr = memory->getSvmPtr();
   } else {
     dev_ptr = memory->getSvmPtr();
     if (!amd::MemObjMap::FindMemObj(dev_ptr))
@@ -223,8 +607,7 @@ void* MemoryPool::AllocateMemory(size_t size, Stream* stream, void* dptr) {
   ts.AddSafeStream(stream);
   busy_heap_.AddMemory(memory, ts);
 
-  max_total_size_ = std::max(max_total_size_, busy_heap_.GetTotalSize() +
-                                                  free_heap_.GetTotalSize());
+  max_total_size_ = std::max(max_total_size_, ReservedSize());
   // Increment the reference counter on the pool
   retain();
 
@@ -247,6 +630,7 @@ bool MemoryPool::FreeMemory(amd::Memory* memory, Stream* stream, Event* event) {
       // Use event base release to reduce memory pressure
       constexpr size_t kBytesToHold = 0;
       free_heap_.ReleaseAllMemory(kBytesToHold);
+      suballoc_.Trim(free_heap_.GetReleaseThreshold());
 
       // If free mmeory is less than 12.5% of total, then force wait release
       size_t free = 0;
@@ -255,6 +639,7 @@ bool MemoryPool::FreeMemory(amd::Memory* memory, Stream* stream, Event* event) {
       if ((err == hipSuccess) && (free < (total >> 3))) {
         constexpr bool kSafeRelease = true;
         free_heap_.ReleaseAllMemory(free_heap_.GetTotalSize() >> 1, kSafeRelease);
+        suballoc_.Trim(kBytesToHold);
       }
     }
 
@@ -312,16 +697,60 @@ bool MemoryPool::FreeMemory(amd::Memory* memory, Stream* stream, Event* event) {
 
 // ================================================================================================
 void MemoryPool::ReleaseAllMemory() {
+  if (device_->GetTrimWorker() != nullptr) {
+    device_->GetTrimWorker()->Cancel(this);
+  }
   constexpr bool kSafeRelease = true;
   free_heap_.ReleaseAllMemory(0, kSafeRelease);
   busy_heap_.ReleaseAllMemory(0, kSafeRelease);
+  suballoc_.Trim(0);
 }
 
 // ================================================================================================
 void MemoryPool::ReleaseFreedMemory() {
   amd::ScopedLock lock(lock_pool_ops_);
 
-  free_heap_.ReleaseAllMemory();
+  if (HIP_MEM_POOL_TRIM_MODE == 0) {
+    free_heap_.ReleaseAllMemory();
+    suballoc_.Trim(free_heap_.GetReleaseThreshold());
+    return;
+  }
+  // Keep the idle memory for reuse, until it grows over the high watermark
+  if (IdleSize() <= HighWatermark()) {
+    return;
+  }
+  if (device_->GetTrimWorker() != nullptr) {
+    device_->GetTrimWorker()->Schedule(this);
+  } else {
+    // Deterministic mode: apply the worker policy inline, without the rate limit
+    while (ReleaseIdleMemory(HIP_MEM_POOL_TRIM_STEP * Mi)) {}
+  }
+}
+
+// ================================================================================================
+bool MemoryPool::TrimStep(size_t max_bytes) {
+  amd::ScopedLock lock(lock_pool_ops_);
+
+  return ReleaseIdleMemory(max_bytes);
+}
+
+// ================================================================================================
+bool MemoryPool::ReleaseIdleMemory(size_t max_bytes) {
+  uint64_t low = free_heap_.GetReleaseThreshold();
+  uint64_t idle = IdleSize();
+  if (idle <= low) {
+    return false;
+  }
+  uint64_t release = std::min<uint64_t>(idle - low, max_bytes);
+  uint64_t free_size = free_heap_.GetTotalSize();
+  // Only allocations with retired HIP events are released, hence the step can't stall
+  free_heap_.ReleaseAllMemory(free_size - std::min(free_size, release));
+  suballoc_.Trim(low);
+
+  uint64_t new_idle = IdleSize();
+  ClPrint(amd::LOG_INFO, amd::LOG_MEM_POOL, "Pool TrimStep: %p, idle: %zu -> %zu, low: %zu",
+          this, idle, new_idle, low);
+  return (new_idle < idle) && (new_idle > low);
 }
 
 // ================================================================================================
@@ -336,6 +765,7 @@ void MemoryPool::TrimTo(size_t min_bytes_to_hold) {
   amd::ScopedLock lock(lock_pool_ops_);
 
   free_heap_.ReleaseAllMemory(min_bytes_to_hold);
+  suballoc_.Trim(min_bytes_to_hold);
 }
 
 // ================================================================================================
@@ -410,8 +840,9 @@ hipError_t MemoryPool::GetAttribute(hipMemPoolAttr attr, void* value) {
       *reinterpret_cast<uint64_t*>(value) = free_heap_.GetReleaseThreshold();
       break;
     case hipMemPoolAttrReservedMemCurrent:
-      // All allocate memory by the pool in OS
-      *reinterpret_cast<uint64_t*>(value) = busy_heap_.GetTotalSize() + free_heap_.GetTotalSize();
+      // All allocate memory by the pool in OS. Unused space in the chunks is reported as
+      // reserved, thus the difference with hipMemPoolAttrUsedMemCurrent shows fragmentation
+      *reinterpret_cast<uint64_t*>(value) = ReservedSize();
       break;
     case hipMemPoolAttrReservedMemHigh:
       // High watermark of all allocated memory in OS, since the last reset
@@ -458,6 +889,7 @@ void MemoryPool::SetAccess(hip::Device* device, hipMemAccessFlags flags) {
     // Update device access on the both pools
     busy_heap_.SetAccess(device, enable_access);
     free_heap_.SetAccess(device, enable_access);
+    suballoc_.SetAccess(device, enable_access);
   }
 }
 
@@ -526,4 +958,83 @@ bool MemoryPool::Import(amd::Os::FileDesc handle) {
   }
   return result;
 }
+
+// ================================================================================================
+TrimWorker::~TrimWorker() {
+  {
+    amd::ScopedLock lock(lock_);
+    terminate_ = true;
+    lock_.notifyAll();
+  }
+  while (thread_.state() < amd::Thread::FINISHED && amd::Os::isThreadAlive(thread_)) {
+    amd::Os::yield();
+  }
+}
+
+// ================================================================================================
+bool TrimWorker::Create() {
+  if (thread_.state() < amd::Thread::INITIALIZED) {
+    return false;
+  }
+  return thread_.start(this);
+}
+
+// ================================================================================================
+void TrimWorker::Schedule(MemoryPool* pool) {
+  amd::ScopedLock lock(lock_);
+  // @note: The pool is queued even if it's trimmed at the moment, since the active step may have
+  // checked the watermarks before the new memory was freed
+  if (std::find(pending_.begin(), pending_.end(), pool) == pending_.end()) {
+    pending_.push_back(pool);
+    lock_.notifyAll();
+  }
+}
+
+// ================================================================================================
+void TrimWorker::Cancel(MemoryPool* pool) {
+  amd::ScopedLock lock(lock_);
+  while (current_ == pool) {
+    lock_.wait();
+  }
+  auto it = std::find(pending_.begin(), pending_.end(), pool);
+  if (it != pending_.end()) {
+    pending_.erase(it);
+  }
+}
+
+// ================================================================================================
+void TrimWorker::Run() {
+  while (true) {
+    MemoryPool* pool = nullptr;
+    {
+      amd::ScopedLock lock(lock_);
+      while (pending_.empty() && !terminate_) {
+        lock_.wait();
+      }
+      if (terminate_) {
+        break;
+      }
+      pool = pending_.front();
+      pending_.pop_front();
+      current_ = pool;
+    }
+
+    bool more = pool->TrimStep(HIP_MEM_POOL_TRIM_STEP * Mi);
+
+    {
+      amd::ScopedLock lock(lock_);
+      current_ = nullptr;
+      // Requeue the pool, so other pools get a chance between the steps
+      if (more && (std::find(pending_.begin(), pending_.end(), pool) == pending_.end())) {
+        pending_.push_back(pool);
+      }
+      // Wake up the worker loop and possible cancel requests
+      lock_.notifyAll();
+    }
+    if (more) {
+      // Rate limit the release, so the driver calls don't saturate the CPU
+      amd::Os::sleep(HIP_MEM_POOL_TRIM_INTERVAL);
+    }
+  }
+}
 }
@@ -23,6 +23,10 @@
 #include <hip/hip_runtime.h>
 #include "hip_event.hpp"
 #include "hip_internal.hpp"
+#include <deque>
+#include <limits>
+#include <set>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -97,12 +101,101 @@ struct MemoryTimestamp {
   hip::Event*   event_ = nullptr;   //!< Last known HIP event, associated with the memory object
 };
 
-class Heap : public amd::EmbeddedObject {
+/// Carves small pool allocations out of large device chunks. Every allocation is an amd::Buffer
+/// view of its chunk and is registered in MemObjMap, hence the rest of HIP handles it as
+/// a regular allocation. The chunks themselves are hidden from MemObjMap.
+/// @note: Disabled unless HIP_MEM_POOL_CHUNK_SIZE is set. With chunks the pool reports the
+/// whole chunks in hipMemPoolAttrReservedMemCurrent/High and checks them against maxSize.
+class SubAllocator : public amd::EmbeddedObject {
 public:
-  typedef std::map<std::pair<size_t, amd::Memory*>, MemoryTimestamp> SortedMap;
+  static constexpr size_t kAlignment = 256;   //!< Alignment of suballocations within a chunk
+
+  SubAllocator(hip::Device* device):
+    chunk_size_(0), reserved_size_(0), carved_size_(0), device_(device) {}
+  ~SubAllocator();
+
+  /// Sets the chunk size. 0 disables suballocation
+  void SetChunkSize(size_t size) { chunk_size_ = size; }
+
+  /// Returns the chunk size
+  size_t ChunkSize() const { return chunk_size_; }
+
+  /// Returns true if the requested size is small enough to be carved from a chunk
+  bool IsSuballocSize(size_t size) const {
+    return (chunk_size_ != 0) && (size <= (chunk_size_ >> 3));
+  }
+
+  /// Adds a new chunk for suballocations
+  void AddChunk(amd::Memory* chunk);
+
+  /// Carves a view from the best fitting free block. Returns nullptr if there is no space
+  amd::Memory* Allocate(size_t size);
+
+  /// Returns the view back to its chunk. Returns false if memory isn't a suballocation
+  bool Free(amd::Memory* memory);
+
+  /// Releases empty chunks, until the reserved size is below bytes_to_hold
+  void Trim(size_t bytes_to_hold);
+
+  /// Enables P2P access to the provided device for all chunks
+  void SetAccess(hip::Device* device, bool enable);
+
+  /// Returns the size of all chunks
+  uint64_t GetReservedSize() const { return reserved_size_; }
+
+  /// Returns the size of all views, carved from the chunks
+  uint64_t GetCarvedSize() const { return carved_size_; }
+
+  /// Returns the size of the largest free block across all chunks
+  uint64_t GetLargestFreeBlock() const {
+    return free_blocks_.empty() ? 0 : std::get<0>(*free_blocks_.rbegin());
+  }
+
+private:
+  SubAllocator() = delete;
+  SubAllocator(const SubAllocator&) = delete;
+  SubAllocator& operator=(const SubAllocator&) = delete;
+
+  struct Chunk {
+    size_t used_ = 0;                   //!< Size of the views, carved from the chunk
+    std::map<size_t, size_t> free_;     //!< Free blocks in the chunk, offset to size
+  };
+  typedef std::map<amd::Memory*, Chunk> ChunkMap;
+  //! Free block: size, chunk and offset. Sorted by size for the best fit search
+  typedef std::tuple<size_t, amd::Memory*, size_t> FreeBlock;
+
+  /// Returns a free block into the chunk and coalesces it with the neighbours
+  void InsertFree(ChunkMap::iterator chunk, size_t offset, size_t size);
+
+  /// Releases the empty chunk back to the device
+  ChunkMap::iterator ReleaseChunk(ChunkMap::iterator chunk);
+
+  ChunkMap chunks_;                 //!< All chunks, allocated for suballocations
+  std::set<FreeBlock> free_blocks_; //!< Free blocks of all chunks
+  size_t chunk_size_;               //!< The size of a new chunk
+  uint64_t reserved_size_;          //!< Size of all chunks
+  uint64_t carved_size_;            //!< Size of all views, carved from the chunks
+  hip::Device*  device_;            //!< Hip device the chunks will reside
+};
 
-  Heap(hip::Device* device):
-    total_size_(0), max_total_size_(0), release_threshold_(0), device_(device) {}
+class Heap : public amd::EmbeddedObject {
+public:
+  typedef std::pair<size_t, amd::Memory*> Key;
+  typedef std::map<Key, MemoryTimestamp> SortedMap;
+  typedef std::set<Key> SortedSet;
+
+  /// Number of lookups, after which the heap decides between the linear scan and the indexes
+  static constexpr size_t kIndexWindow = 256;
+  /// With the indexes every N-th lookup measures the linear scan
+  static constexpr size_t kIndexSampleRate = 16;
+  /// Average blocks the linear scan walks per lookup, above which the indexes are used
+  static constexpr size_t kIndexMinScanBlocks = 64;
+  /// A sample counts a longer walk of the linear scan as this number of blocks
+  static constexpr size_t kIndexMaxSampleBlocks = 4 * kIndexMinScanBlocks;
+
+  Heap(hip::Device* device, SubAllocator* suballoc = nullptr):
+    total_size_(0), max_total_size_(0), release_threshold_(0), suballoc_(suballoc),
+    device_(device) {}
   ~Heap() {}
 
   /// Adds allocation into the heap on a specific stream
@@ -152,11 +245,7 @@ public:
   SortedMap::iterator EraseAllocaton(SortedMap::iterator& it);
 
   /// Add a safe stream for  quick looks-ups in all allocations
-  void AddSafeStream(Stream* event_stream, Stream* wait_stream) {
-    for (auto& it : allocations_) {
-      it.second.AddSafeStream(event_stream, wait_stream);
-    }
-  }
+  void AddSafeStream(Stream* event_stream, Stream* wait_stream);
 
   /// Checks if memory belongs to this heap
   bool IsActiveMemory(amd::Memory* memory) const {
@@ -164,19 +253,100 @@ public:
   }
   const auto& Allocations() { return allocations_; }
 
+  /// The lookups use the per stream indexes instead of the linear scan
+  bool IsIndexed() const { return indexed_; }
+
 private:
   Heap() = delete;
   Heap(const Heap&) = delete;
   Heap& operator=(const Heap&) = delete;
 
+  /// Adds an allocation into the lookup indices
+  void IndexAdd(const Key& key, const MemoryTimestamp& ts);
+
+  /// Removes an allocation from the lookup indices
+  void IndexRemove(const Key& key, const MemoryTimestamp& ts);
+
+  /// Removes the found allocation from the heap and returns the memory object
+  amd::Memory* TakeMemory(SortedMap::iterator it, MemoryTimestamp* ts);
+
+  /// Finds a safe allocation for the stream with the last freed one, the linear scan or the
+  /// indexes
+  amd::Memory* FindSafeMemory(size_t size, Stream* stream, bool opportunistic,
+    MemoryTimestamp* ts);
+
+  /// Forgets the allocation as the last freed one of its streams
+  void ForgetLastFreed(SortedMap::iterator it);
+
+  /// Adds the number of blocks, the linear scan walked for a lookup, to the current window
+  void SampleScan(size_t blocks);
+
+  /// Returns the number of blocks, the linear scan would walk for a lookup
+  size_t ScanLength(const Key& key, Stream* stream);
+
+  /// Builds or drops the lookup indexes at the end of a window, based on the average walk of
+  /// the linear scan
+  void UpdateIndexes();
+
   SortedMap allocations_;       //!< Map of allocations on a specific stream
+  //! Allocations, which are safe for reuse on a stream without HIP event validation.
+  //! Mirrors MemoryTimestamp::safe_streams_ of all allocations, if the heap is indexed
+  std::unordered_map<Stream*, SortedSet> stream_index_;
+  SortedSet released_;          //!< Allocations without HIP event, safe for reuse on any stream
+  //! The last allocation, added on a stream, for the reuse without a search
+  std::unordered_map<Stream*, SortedMap::iterator> last_freed_;
+  bool indexed_ = false;        //!< The lookup indexes are valid
+  size_t lookups_ = 0;          //!< Lookups in the current window
+  size_t scan_blocks_ = 0;      //!< Blocks, the linear scan walked in the current window
+  size_t scan_samples_ = 0;     //!< Lookups, which measured the linear scan
   uint64_t total_size_;         //!< Size of all allocations in the heap
   uint64_t max_total_size_;     //!< Maximum heap allocation size
   uint64_t release_threshold_;  //!< Threshold size in bytes for memory release from heap, default 0
+  SubAllocator* suballoc_;      //!< Suballocator, which owns the views in the heap
 
   hip::Device*  device_;    //!< Hip device the allocations will reside
 };
 
+/// Background worker, which releases freed memory of the pools on a device, so the release
+/// latency doesn't land on the app's synchronization path
+class TrimWorker : public amd::HeapObject {
+ public:
+  TrimWorker(): lock_("TrimWorker::lock", true), current_(nullptr), terminate_(false) {}
+  ~TrimWorker();
+
+  /// Starts the worker thread
+  bool Create();
+
+  /// Schedules the pool for trimming
+  void Schedule(MemoryPool* pool);
+
+  /// Removes the pool from the worker and waits for the active trim of the pool.
+  /// @note: The pool must be removed from the device list beforehand, so it can't be scheduled
+  /// again by a concurrent sync
+  void Cancel(MemoryPool* pool);
+
+ private:
+  TrimWorker(const TrimWorker&) = delete;
+  TrimWorker& operator=(const TrimWorker&) = delete;
+
+  class Thread : public amd::Thread {
+   public:
+    Thread() : amd::Thread("Memory Pool Trim Thread", CQ_THREAD_STACK_SIZE) {}
+
+    //! The trim worker thread entry point
+    void run(void* data) { reinterpret_cast<TrimWorker*>(data)->Run(); }
+  };
+
+  /// The trim loop of the worker thread
+  void Run();
+
+  amd::Monitor lock_;                 //!< Protects the worker state
+  std::deque<MemoryPool*> pending_;   //!< Pools, scheduled for trimming
+  MemoryPool* current_;               //!< The pool, which is trimmed at the moment
+  bool terminate_;                    //!< The worker thread must exit
+  Thread thread_;                     //!< The worker thread
+};
+
 /// Allocates memory in the pool on the specified stream and places the allocation into busy_heap_
 /// @note: the logic also will look in free_heap for possible reuse.
 /// hipMemPoolReuseAllowOpportunistic option will validate if HIP event,
@@ -197,9 +367,10 @@ class MemoryPool : public amd::ReferenceCountedObject {
   };
 
   MemoryPool(hip::Device* device, const hipMemPoolProps* props = nullptr, bool phys_mem = false)
-      : busy_heap_(device),
-        free_heap_(device),
-        lock_pool_ops_(true), /* Pool operations */
+      : suballoc_(device),
+        busy_heap_(device, &suballoc_),
+        free_heap_(device, &suballoc_),
+        lock_pool_ops_("MemoryPool::lock_pool_ops", true), /* Pool operations */
         device_(device),
         shared_(nullptr),
         max_total_size_(0) {
@@ -220,15 +391,21 @@ class MemoryPool : public amd::ReferenceCountedObject {
                      .reserved = {}};
     }
     state_.interprocess_ = properties_.handleTypes != hipMemHandleTypeNone;
+    // IPC export and graph allocations require a dedicated allocation per pointer
+    if (!state_.interprocess_ && !phys_mem) {
+      suballoc_.SetChunkSize(HIP_MEM_POOL_CHUNK_SIZE);
+    }
   }
 
   virtual ~MemoryPool() {
+    // Remove memory pool from the list of all pool on the current device first. A sync on
+    // another thread walks the list and could schedule the pool for trimming after the cancel
+    device_->RemoveMemoryPool(this);
     if (!busy_heap_.IsEmpty()) {
       LogError("Shouldn't destroy pool with busy allocations!");
     }
+    // Cancels the pending trim and waits for the active one
     ReleaseAllMemory();
-    // Remove memory pool from the list of all pool on the current device
-    device_->RemoveMemoryPool(this);
     if (shared_ != nullptr) {
       // Note: The app supposes to close the handle... Double close in Windows will cause a crash
       amd::Os::CloseIpcMemory(0, shared_, sizeof(SharedMemPool));
@@ -244,10 +421,17 @@ class MemoryPool : public amd::ReferenceCountedObject {
   /// Check if memory is active and belongs to the busy heap
   bool IsBusyMemory(amd::Memory* memory) const { return busy_heap_.IsActiveMemory(memory); }
 
+  /// The free heap uses its lookup indexes instead of the linear scan
+  bool IsFreeHeapIndexed() const { return free_heap_.IsIndexed(); }
+
   /// Releases all allocations from free_heap_. It can be called on Stream or Device synchronization
   /// @note The caller must make sure it's safe to release memory
   void ReleaseFreedMemory();
 
+  /// Releases up to max_bytes of idle memory, until the low watermark is met.
+  /// Returns true if the pool made progress and still has memory above the low watermark
+  bool TrimStep(size_t max_bytes);
+
   /// Removes a stream from tracking
   void RemoveStream(hip::Stream* stream);
 
@@ -309,6 +493,31 @@ class MemoryPool : public amd::ReferenceCountedObject {
   MemoryPool(const MemoryPool&) = delete;
   MemoryPool& operator=(const MemoryPool&) = delete;
 
+  /// Allocates a new device memory object and enables access from the peer devices
+  amd::Memory* AllocateDeviceMemory(size_t size);
+
+  /// Returns the size of all memory, reserved by the pool in OS
+  uint64_t ReservedSize() const {
+    return busy_heap_.GetTotalSize() + free_heap_.GetTotalSize() - suballoc_.GetCarvedSize() +
+        suballoc_.GetReservedSize();
+  }
+
+  /// Returns the size of reserved memory, which isn't used by the app
+  uint64_t IdleSize() const { return ReservedSize() - busy_heap_.GetTotalSize(); }
+
+  /// Returns the idle size above which the freed memory is released. The release threshold
+  /// serves as the low watermark
+  uint64_t HighWatermark() const {
+    uint64_t low = free_heap_.GetReleaseThreshold();
+    uint64_t step = HIP_MEM_POOL_TRIM_STEP * Mi;
+    return (low > (std::numeric_limits<uint64_t>::max() - step)) ?
+        std::numeric_limits<uint64_t>::max() : (low + step);
+  }
+
+  /// Releases up to max_bytes of idle memory. The caller must hold the pool lock
+  bool ReleaseIdleMemory(size_t max_bytes);
+
+  SubAllocator suballoc_; //!< Suballocator of small allocations
   Heap busy_heap_;    //!< Heap of busy allocations
   Heap free_heap_;    //!< Heap of freed allocations
   union {
@@ -55,6 +55,15 @@ extern hipError_t ihipModuleLaunchKernel(
     void** kernelParams, void** extra, hipEvent_t startEvent, hipEvent_t stopEvent,
     uint32_t flags = 0, uint32_t params = 0, uint32_t gridId = 0, uint32_t numGrids = 0,
     uint64_t prevGridSum = 0, uint64_t allGridSum = 0, uint32_t firstDevice = 0);
+// With the deferred loading the programs are built per device on the first use of a kernel
+static bool isDeferredLoadingEnabled() {
+  static int enable_deferred_loading{[]() {
+    char* var = getenv("HIP_ENABLE_DEFERRED_LOADING");
+    return var ? atoi(var) : 1;
+  }()};
+  return enable_deferred_loading != 0;
+}
+
 static bool isCompatibleCodeObject(const std::string& codeobj_target_id, const char* device_name) {
   // Workaround for device name mismatch.
   // Device name may contain feature strings delimited by '+', e.g.
@@ -86,10 +95,6 @@ void __hipRegisterFunction(hip::FatBinaryInfo** modules, const void* hostFunctio
                                       char* deviceFunction, const char* deviceName,
                                       unsigned int threadLimit, uint3* tid, uint3* bid,
                                       dim3* blockDim, dim3* gridDim, int* wSize) {
-  static int enable_deferred_loading{[]() {
-    char* var = getenv("HIP_ENABLE_DEFERRED_LOADING");
-    return var ? atoi(var) : 1;
-  }()};
   hipError_t hip_error = hipSuccess;
   // Compiler might share same hostFunction and hence it's needless to have another
   // hip::Function and hip::Function is stored in map with hostFunction as key.
@@ -100,10 +105,16 @@ void __hipRegisterFunction(hip::FatBinaryInfo** modules, const void* hostFunctio
   }
   guarantee((hip_error == hipSuccess), "Cannot register Static function, error: %d", hip_error);
 
-  if (!enable_deferred_loading) {
+  if (!isDeferredLoadingEnabled()) {
     HIP_INIT_VOID();
     hipFunction_t hfunc = nullptr;
 
+    // Build the programs of all devices once per module, the failures are reported per device
+    // below
+    hip_error = PlatformState::instance().buildFatBinary(modules);
+    if (hip_error != hipSuccess) {
+      HIP_ERROR_PRINT(hip_error, "cannot build the fat binary for all devices");
+    }
     for (size_t dev_idx = 0; dev_idx < g_devices.size(); ++dev_idx) {
       hip_error = PlatformState::instance().getStatFunc(&hfunc, hostFunction, dev_idx);
       guarantee((hip_error == hipSuccess), "Cannot retrieve Static function, error: %d",
@@ -730,10 +741,18 @@ void PlatformState::init() {
     return;
   }
   initialized_ = true;
-  for (auto& it : statCO_.modules_) {
-    hipError_t err = digestFatBinary(it.first, it.second);
-    if (err != hipSuccess) {
-      HIP_ERROR_PRINT(err, "continue parsing remaining modules");
+  // With the lazy loading the fat binaries are digested on the first use of their symbols
+  if (!DEBUG_HIP_LAZY_CODE_OBJECT_LOADING) {
+    if (!isDeferredLoadingEnabled() && (DEBUG_HIP_CODE_OBJECT_LOAD_THREADS != 1)) {
+      // All devices are built right after the init, so extract the fat binaries in parallel
+      statCO_.digestFatBinaries();
+    } else {
+      for (auto& it : statCO_.modules_) {
+        hipError_t err = digestFatBinary(it.first, it.second);
+        if (err != hipSuccess) {
+          HIP_ERROR_PRINT(err, "continue parsing remaining modules");
+        }
+      }
     }
   }
   for (auto& it : statCO_.vars_) {
@@ -902,6 +921,10 @@ hipError_t PlatformState::digestFatBinary(const void* data, hip::FatBinaryInfo*&
   return statCO_.digestFatBinary(data, programs);
 }
 
+hipError_t PlatformState::buildFatBinary(hip::FatBinaryInfo** module) {
+  return statCO_.buildFatBinary(module);
+}
+
 hip::FatBinaryInfo** PlatformState::addFatBinary(const void* data, bool& success) {
   return statCO_.addFatBinary(data, initialized_, success);
 }
@@ -85,6 +85,7 @@ class PlatformState {
   hip::FatBinaryInfo** addFatBinary(const void* data, bool& success);
   hipError_t removeFatBinary(hip::FatBinaryInfo** module);
   hipError_t digestFatBinary(const void* data, hip::FatBinaryInfo*& programs);
+  hipError_t buildFatBinary(hip::FatBinaryInfo** module);
 
   hipError_t registerStatFunction(const void* hostFunction, hip::Function* func);
   hipError_t registerStatGlobalVar(const void* hostVar, hip::Var* var);
@@ -32,7 +32,7 @@ Stream::Stream(hip::Device* dev, Priority p, unsigned int f, bool null_stream,
                const std::vector<uint32_t>& cuMask, hipStreamCaptureStatus captureStatus)
     : amd::HostQueue(*dev->asContext(), *dev->devices()[0], 0, amd::CommandQueue::RealTimeDisabled,
                      convertToQueuePriority(p), cuMask),
-      lock_("Stream Callback lock"),
+      lock_("Stream Callback lock", true),
       device_(dev),
       priority_(p),
       flags_(f),
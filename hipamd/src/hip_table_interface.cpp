@@ -1819,3 +1819,9 @@ hipError_t hipGraphNodeSetParams(hipGraphNode_t node, hipGraphNodeParams *nodePa
 hipError_t hipExtHostAlloc(void** ptr, size_t size, unsigned int flags) {
   return hip::GetHipDispatchTable()->hipExtHostAlloc_fn(ptr, size, flags);
 }
+hipError_t hipExtGraphLaunchBatch(hipGraphExec_t graphExec, hipStream_t stream,
+                                  unsigned int numLaunches, const hipGraphNode_t* nodes,
+                                  const hipKernelNodeParams* nodeParams, unsigned int numNodes) {
+  return hip::GetHipDispatchTable()->hipExtGraphLaunchBatch_fn(graphExec, stream, numLaunches,
+                                                               nodes, nodeParams, numNodes);
+}
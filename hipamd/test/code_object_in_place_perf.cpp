@@ -0,0 +1,222 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+
+// Cost of referencing the code objects of an uncompressed offload bundle in place, which the
+// zero copy unbundling (DEBUG_HIP_ZERO_COPY_UNBUNDLING) does, against copying them out of the
+// bundle. The bundles are synthetic, with a host entry and 1..N hipv4 code objects of distinct
+// processors, so no device is required. The devices select every third code object, half of
+// them with the target features. The tool checks that every selected pointer is inside the
+// bundle at the offset and with the size of its entry, that the code object matches, and that a
+// missing target and a compressed bundle are reported.
+
+#include "hip_code_object.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+static constexpr char BundleMagic[] = "__CLANG_OFFLOAD_BUNDLE__";
+static constexpr size_t CodeObjectAlignment = 4096;
+static constexpr size_t ElfHeaderSize = 64;
+
+// Entry of the synthetic bundle
+struct Entry {
+  std::string id_;
+  uint64_t offset_;
+  uint64_t size_;
+};
+
+static std::string Processor(size_t index) { return "gfx" + std::to_string(9000 + index); }
+
+static void Append(std::vector<char>& data, const void* value, size_t size) {
+  const char* bytes = static_cast<const char*>(value);
+  data.insert(data.end(), bytes, bytes + size);
+}
+
+// Builds a bundle of one host entry and the code objects of the processors with the features.
+// Every code object is an ELF header without an AMDGPU machine, so it isn't generic, filled with
+// its index
+static std::vector<char> Build(size_t targets, size_t size, std::vector<Entry>& entries,
+                               const std::string& features = "") {
+  entries.clear();
+  entries.push_back({"host-x86_64-unknown-linux-gnu-", 0, 0});
+  for (size_t i = 0; i < targets; ++i) {
+    entries.push_back({"hipv4-amdgcn-amd-amdhsa--" + Processor(i) + features, 0, size});
+  }
+
+  size_t header = (sizeof(BundleMagic) - 1) + sizeof(uint64_t);
+  for (const auto& entry : entries) {
+    header += 3 * sizeof(uint64_t) + entry.id_.size();
+  }
+  uint64_t offset = (header + CodeObjectAlignment - 1) & ~(CodeObjectAlignment - 1);
+  for (auto& entry : entries) {
+    if (entry.size_ != 0) {
+      entry.offset_ = offset;
+      offset += (entry.size_ + CodeObjectAlignment - 1) & ~(CodeObjectAlignment - 1);
+    }
+  }
+
+  std::vector<char> data;
+  data.reserve(offset);
+  Append(data, BundleMagic, sizeof(BundleMagic) - 1);
+  uint64_t count = entries.size();
+  Append(data, &count, sizeof(count));
+  for (const auto& entry : entries) {
+    uint64_t idSize = entry.id_.size();
+    Append(data, &entry.offset_, sizeof(entry.offset_));
+    Append(data, &entry.size_, sizeof(entry.size_));
+    Append(data, &idSize, sizeof(idSize));
+    Append(data, entry.id_.data(), idSize);
+  }
+  data.resize(offset, 0);
+  for (size_t i = 1; i < entries.size(); ++i) {
+    char* image = data.data() + entries[i].offset_;
+    ::memset(image + ElfHeaderSize, static_cast<int>(i), entries[i].size_ - ElfHeaderSize);
+    ::memcpy(image, "\x7f" "ELF", 4);
+  }
+  return data;
+}
+
+// Every third processor, with and without the target features
+static std::vector<std::string> Devices(size_t targets) {
+  std::vector<std::string> devices;
+  for (size_t i = 0; i < targets; i += 3) {
+    std::string name = "amdgcn-amd-amdhsa--" + Processor(i);
+    devices.push_back(((devices.size() % 2) == 0) ? name : name + ":sramecc+:xnack-");
+  }
+  return devices;
+}
+
+// Returns the number of code objects, which aren't the entry of their device
+static size_t Check(const std::vector<char>& bundle, const std::vector<Entry>& entries,
+                    const std::vector<std::pair<const void*, size_t>>& code_objs) {
+  size_t errors = 0;
+  for (size_t dev = 0; dev < code_objs.size(); ++dev) {
+    const Entry& entry = entries[1 + dev * 3];
+    const char* image = static_cast<const char*>(code_objs[dev].first);
+    if ((image != bundle.data() + entry.offset_) || (code_objs[dev].second != entry.size_) ||
+        (image[ElfHeaderSize] != static_cast<char>(1 + dev * 3))) {
+      errors++;
+    }
+  }
+  return errors;
+}
+
+// Returns the number of errors of the bundles, which can't be referenced in place
+static size_t Reject() {
+  size_t errors = 0;
+  std::vector<Entry> entries;
+  std::vector<char> bundle = Build(4, CodeObjectAlignment, entries);
+  std::vector<std::string> devices = {"amdgcn-amd-amdhsa--" + Processor(1),
+                                      "amdgcn-amd-amdhsa--" + Processor(7)};
+  std::vector<std::pair<const void*, size_t>> code_objs;
+  // The second device has no code object, the first one is still referenced
+  if ((hip::CodeObject::ExtractCodeObjectInPlace(bundle.data(), devices, code_objs) !=
+       hipErrorNoBinaryForGpu) || (code_objs.size() != 2) ||
+      (code_objs[0].first != bundle.data() + entries[2].offset_) ||
+      (code_objs[1].first != nullptr)) {
+    errors++;
+  }
+  // The features of the code objects must match the device
+  bundle = Build(4, CodeObjectAlignment, entries, ":xnack-");
+  devices = {"amdgcn-amd-amdhsa--" + Processor(1) + ":xnack+",
+             "amdgcn-amd-amdhsa--" + Processor(2) + ":sramecc+:xnack-"};
+  code_objs.clear();
+  if ((hip::CodeObject::ExtractCodeObjectInPlace(bundle.data(), devices, code_objs) !=
+       hipErrorNoBinaryForGpu) || (code_objs[0].first != nullptr) ||
+      (code_objs[1].first != bundle.data() + entries[3].offset_)) {
+    errors++;
+  }
+  // The compressed bundles are copied by COMGR
+  std::vector<char> compressed(bundle.size(), 0);
+  ::memcpy(compressed.data(), "CCOB", 4);
+  code_objs.clear();
+  if (hip::CodeObject::ExtractCodeObjectInPlace(compressed.data(), devices, code_objs) !=
+      hipErrorInvalidKernelFile) {
+    errors++;
+  }
+  return errors;
+}
+
+int main(int argc, char** argv) {
+  size_t maxTargets = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 64;
+  size_t iterations = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 100;
+  if ((maxTargets == 0) || (iterations == 0)) {
+    printf("Usage: %s [max code objects per bundle] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  size_t errors = 0;
+  printf("Uncompressed bundle unbundling: %zu iterations, us per bundle\n", iterations);
+  printf("%-8s %-8s %8s %12s %12s\n", "objects", "size KB", "devices", "copy", "in place");
+  for (size_t size : {64 * 1024, 4 * 1024 * 1024}) {
+    for (size_t targets = 1; targets <= maxTargets; targets *= 4) {
+      std::vector<Entry> entries;
+      std::vector<char> bundle = Build(targets, size, entries);
+      std::vector<std::string> devices = Devices(targets);
+
+      // The copy of the selected code objects, which the unbundling did before
+      std::vector<std::pair<const void*, size_t>> code_objs;
+      std::vector<std::vector<char>> copies;
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < iterations; ++i) {
+        code_objs.clear();
+        if (hip::CodeObject::ExtractCodeObjectInPlace(bundle.data(), devices, code_objs) !=
+            hipSuccess) {
+          errors++;
+          break;
+        }
+        copies.clear();
+        for (const auto& code_obj : code_objs) {
+          const char* image = static_cast<const char*>(code_obj.first);
+          copies.emplace_back(image, image + code_obj.second);
+        }
+      }
+      auto copied = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < iterations; ++i) {
+        code_objs.clear();
+        if (hip::CodeObject::ExtractCodeObjectInPlace(bundle.data(), devices, code_objs) !=
+            hipSuccess) {
+          errors++;
+          break;
+        }
+      }
+      auto end = std::chrono::steady_clock::now();
+      errors += (code_objs.size() != devices.size()) ? 1 : Check(bundle, entries, code_objs);
+
+      printf("%-8zu %-8zu %8zu %12.1f %12.1f\n", targets, size / 1024, devices.size(),
+             std::chrono::duration<double, std::micro>(copied - start).count() / iterations,
+             std::chrono::duration<double, std::micro>(end - copied).count() / iterations);
+    }
+  }
+  errors += Reject();
+
+  if (errors != 0) {
+    printf("FAILED: %zu code objects weren't referenced in place\n", errors);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
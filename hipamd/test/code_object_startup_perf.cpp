@@ -0,0 +1,196 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Startup cost of the static fat binaries with the eager and the lazy code object loading.
+// The tool copies its own offload bundle from the .hip_fatbin section into N synthetic modules
+// and registers them with one kernel each, like N linked libraries, before the runtime init.
+// Then it launches the kernels of a few modules. Every mode runs in a child process, since the
+// fat binaries are digested once per process, with DEBUG_HIP_LAZY_CODE_OBJECT_LOADING set by
+// the parent. The tool reports the time of the runtime init, the first launches and both.
+
+#include <hip/hip_runtime.h>
+
+#include <elf.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#define CHECK(cmd)                                                                     \
+  do {                                                                                 \
+    hipError_t status = (cmd);                                                         \
+    if (status != hipSuccess) {                                                        \
+      printf("%s failed: %s at line %d\n", #cmd, hipGetErrorString(status), __LINE__); \
+      exit(1);                                                                         \
+    }                                                                                  \
+  } while (0)
+
+// The registration entry points, which the compiler calls from the module constructors
+extern "C" void** __hipRegisterFatBinary(const void* data);
+extern "C" void __hipRegisterFunction(void** modules, const void* hostFunction,
+                                      char* deviceFunction, const char* deviceName,
+                                      unsigned int threadLimit, uint3* tid, uint3* bid,
+                                      dim3* blockDim, dim3* gridDim, int* wSize);
+
+extern "C" __global__ void StartupProbe(int* out, int index) {
+  if (threadIdx.x == 0) {
+    out[index] = index + 1;
+  }
+}
+
+struct FatBinaryWrapper {
+  unsigned int magic_;
+  unsigned int version_;
+  const void* binary_;
+  void* unused_;
+};
+
+static constexpr unsigned int FatMagic = 0x48495046;  // "HIPF"
+static constexpr size_t BundleAlignment = 4096;
+
+// Returns the offload bundle of the executable, empty if it doesn't exist
+static std::vector<char> ReadBundle() {
+  std::ifstream file("/proc/self/exe", std::ios::binary);
+  std::vector<char> image((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+  if (image.size() < sizeof(Elf64_Ehdr)) {
+    return {};
+  }
+  const auto* ehdr = reinterpret_cast<const Elf64_Ehdr*>(image.data());
+  const auto* shdr = reinterpret_cast<const Elf64_Shdr*>(image.data() + ehdr->e_shoff);
+  const char* names = image.data() + shdr[ehdr->e_shstrndx].sh_offset;
+  for (uint16_t i = 0; i < ehdr->e_shnum; ++i) {
+    if (strcmp(names + shdr[i].sh_name, ".hip_fatbin") == 0) {
+      return std::vector<char>(image.begin() + shdr[i].sh_offset,
+                               image.begin() + shdr[i].sh_offset + shdr[i].sh_size);
+    }
+  }
+  return {};
+}
+
+static double Ms(std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Registers the modules, initializes the runtime and launches the kernels of the first modules
+static int RunChild(size_t modules, size_t touched) {
+  std::vector<char> bundle = ReadBundle();
+  if (bundle.empty()) {
+    printf("FAILED: no .hip_fatbin section in the executable\n");
+    return 1;
+  }
+  size_t size = (bundle.size() + BundleAlignment - 1) & ~(BundleAlignment - 1);
+  std::vector<char*> images(modules);
+  std::vector<FatBinaryWrapper> wrappers(modules);
+  std::vector<char> stubs(modules);  // Unique host function addresses
+  std::string name = "StartupProbe";
+  for (size_t m = 0; m < modules; ++m) {
+    images[m] = static_cast<char*>(aligned_alloc(BundleAlignment, size));
+    memcpy(images[m], bundle.data(), bundle.size());
+    wrappers[m] = {FatMagic, 1, images[m], nullptr};
+    void** handle = __hipRegisterFatBinary(&wrappers[m]);
+    if (handle == nullptr) {
+      printf("FAILED: module %zu wasn't registered\n", m);
+      return 1;
+    }
+    __hipRegisterFunction(handle, &stubs[m], &name[0], name.c_str(),
+                          static_cast<unsigned int>(-1), nullptr, nullptr, nullptr, nullptr,
+                          nullptr);
+  }
+
+  // The first API call initializes the runtime, which digests the fat binaries without the
+  // lazy loading
+  auto start = std::chrono::steady_clock::now();
+  int count = 0;
+  CHECK(hipGetDeviceCount(&count));
+  auto initialized = std::chrono::steady_clock::now();
+
+  int* out = nullptr;
+  CHECK(hipHostMalloc(&out, touched * sizeof(int), hipHostMallocDefault));
+  memset(out, 0, touched * sizeof(int));
+  auto launch = std::chrono::steady_clock::now();
+  for (size_t m = 0; m < touched; ++m) {
+    int index = static_cast<int>(m);
+    void* args[] = {&out, &index};
+    CHECK(hipLaunchKernel(&stubs[m], dim3(1), dim3(64), args, 0, nullptr));
+  }
+  CHECK(hipDeviceSynchronize());
+  auto end = std::chrono::steady_clock::now();
+
+  size_t errors = 0;
+  for (size_t m = 0; m < touched; ++m) {
+    errors += (out[m] != static_cast<int>(m + 1)) ? 1 : 0;
+  }
+  CHECK(hipHostFree(out));
+  const char* lazy = getenv("DEBUG_HIP_LAZY_CODE_OBJECT_LOADING");
+  printf("%-6s %12.1f %14.1f %10.1f\n", (atoi(lazy) != 0) ? "lazy" : "eager",
+         Ms(start, initialized), Ms(launch, end), Ms(start, initialized) + Ms(launch, end));
+  if (errors != 0) {
+    printf("FAILED: %zu kernels didn't run\n", errors);
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  size_t modules = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 200;
+  size_t touched = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 4;
+  if ((modules == 0) || (touched > modules)) {
+    printf("Usage: %s [modules] [modules with a launch, <= modules]\n", argv[0]);
+    return 1;
+  }
+  if (getenv("HIP_STARTUP_PERF_CHILD") != nullptr) {
+    return RunChild(modules, touched);
+  }
+
+  printf("Static fat binary startup: %zu modules, kernels of %zu launched, times in ms\n",
+         modules, touched);
+  printf("%-6s %12s %14s %10s\n", "mode", "init", "first launch", "total");
+  fflush(stdout);
+  size_t errors = 0;
+  for (const char* lazy : {"0", "1"}) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      setenv("HIP_STARTUP_PERF_CHILD", "1", 1);
+      setenv("DEBUG_HIP_LAZY_CODE_OBJECT_LOADING", lazy, 1);
+      execv("/proc/self/exe", argv);
+      _exit(127);
+    }
+    int status = 0;
+    if ((pid < 0) || (waitpid(pid, &status, 0) != pid) || !WIFEXITED(status) ||
+        (WEXITSTATUS(status) != 0)) {
+      errors++;
+    }
+  }
+  if (errors != 0) {
+    printf("FAILED: %zu modes failed\n", errors);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
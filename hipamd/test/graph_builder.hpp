@@ -0,0 +1,148 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#pragma once
+
+// Synthetic graph shapes for the host-only graph tools. A shape adds its nodes through the
+// caller's node factory, hence a tool can attach its own data to the nodes, e.g. a cost.
+
+#include "hip_graph_internal.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace graph_builder {
+
+//! Creates a new node with the estimated cost, which a tool may ignore
+typedef hip::GraphNode* (*NewNode)(uint64_t cost);
+
+struct Shape {
+  const char* name_;
+  void (*build_)(hip::Graph& graph, std::mt19937_64& rng, size_t nodes, NewNode new_node);
+};
+
+//! Mostly small kernels with a few large ones
+inline uint64_t RandomCost(std::mt19937_64& rng) {
+  return hip::kGraphDispatchCost + (((rng() % 8) == 0) ? (rng() % 4096) : (rng() % 128));
+}
+
+inline hip::GraphNode* Add(hip::Graph& graph, NewNode new_node, uint64_t cost) {
+  hip::GraphNode* node = new_node(cost);
+  graph.AddNode(node);
+  return node;
+}
+
+//! Adds the edge, unless the random pick produced it already
+inline void AddUniqueEdge(hip::GraphNode* dep, hip::GraphNode* node) {
+  const auto& edges = dep->GetEdges();
+  if (std::find(edges.begin(), edges.end(), node) == edges.end()) {
+    dep->AddEdgeDep(node);
+  }
+}
+
+//! Every node depends on the previous one, the depth equals the number of nodes
+inline void BuildChain(hip::Graph& graph, std::mt19937_64& rng, size_t nodes, NewNode new_node) {
+  hip::GraphNode* prev = Add(graph, new_node, RandomCost(rng));
+  for (size_t i = 1; i < nodes; ++i) {
+    hip::GraphNode* node = Add(graph, new_node, RandomCost(rng));
+    prev->AddEdgeDep(node);
+    prev = node;
+  }
+}
+
+//! A long chain of large nodes with small side nodes, which feed into the chain
+inline void BuildChainWithSides(hip::Graph& graph, std::mt19937_64& rng, size_t nodes,
+                                NewNode new_node) {
+  hip::GraphNode* prev = Add(graph, new_node, 1024);
+  for (size_t i = 1; i < nodes; ++i) {
+    if ((rng() % 4) == 0) {
+      hip::GraphNode* node = Add(graph, new_node, 1024);
+      prev->AddEdgeDep(node);
+      prev = node;
+    } else {
+      hip::GraphNode* side = Add(graph, new_node, RandomCost(rng));
+      side->AddEdgeDep(prev);
+    }
+  }
+}
+
+//! One root with an edge to every node and one leaf, which depends on every node
+inline void BuildFan(hip::Graph& graph, std::mt19937_64& rng, size_t nodes, NewNode new_node) {
+  hip::GraphNode* root = Add(graph, new_node, hip::kGraphDispatchCost);
+  hip::GraphNode* leaf = Add(graph, new_node, hip::kGraphDispatchCost);
+  for (size_t i = 2; i < nodes; ++i) {
+    hip::GraphNode* node = Add(graph, new_node, RandomCost(rng));
+    root->AddEdgeDep(node);
+    node->AddEdgeDep(leaf);
+  }
+}
+
+//! Fork-join: branches of a random length between a fork and a join node
+inline void BuildForkJoin(hip::Graph& graph, std::mt19937_64& rng, size_t nodes,
+                          NewNode new_node) {
+  hip::GraphNode* fork = Add(graph, new_node, hip::kGraphDispatchCost);
+  hip::GraphNode* join = Add(graph, new_node, hip::kGraphDispatchCost);
+  size_t left = nodes - 2;
+  while (left != 0) {
+    size_t length = std::min<size_t>(left, 1 + rng() % 16);
+    hip::GraphNode* prev = fork;
+    for (size_t i = 0; i < length; ++i) {
+      hip::GraphNode* node = Add(graph, new_node, RandomCost(rng));
+      prev->AddEdgeDep(node);
+      prev = node;
+    }
+    prev->AddEdgeDep(join);
+    left -= length;
+  }
+}
+
+//! Binary tree from the root to the leaves
+inline void BuildTree(hip::Graph& graph, std::mt19937_64& rng, size_t nodes, NewNode new_node) {
+  std::vector<hip::GraphNode*> all;
+  all.push_back(Add(graph, new_node, RandomCost(rng)));
+  for (size_t i = 1; i < nodes; ++i) {
+    hip::GraphNode* node = Add(graph, new_node, RandomCost(rng));
+    all[(i - 1) / 2]->AddEdgeDep(node);
+    all.push_back(node);
+  }
+}
+
+//! Random layers of Width nodes, every node depends on 1-3 nodes of the previous layers.
+//! With Local the dependencies come from the previous layer only
+template <size_t Width, bool Local>
+void BuildLayered(hip::Graph& graph, std::mt19937_64& rng, size_t nodes, NewNode new_node) {
+  std::vector<hip::GraphNode*> all;
+  for (size_t i = 0; i < nodes; ++i) {
+    hip::GraphNode* node = Add(graph, new_node, RandomCost(rng));
+    size_t layer_start = (i / Width) * Width;
+    if (layer_start != 0) {
+      size_t deps = 1 + rng() % 3;
+      for (size_t d = 0; d < deps; ++d) {
+        size_t dep = Local ? (layer_start - Width + rng() % Width) : (rng() % layer_start);
+        AddUniqueEdge(all[dep], node);
+      }
+    }
+    all.push_back(node);
+  }
+}
+
+}  // namespace graph_builder
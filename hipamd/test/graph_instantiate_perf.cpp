@@ -0,0 +1,133 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Host part of hipGraphInstantiate on synthetic graphs: the clone, the topological order and
+// the stream schedule, which run before any command is created. The graphs are built from
+// empty nodes on a HIP device object without a GPU. A long chain checks that the traversals
+// don't recurse over the graph depth, a wide fan and a tree stress the edge lists and random
+// layers give a mix of both. Every order is checked against the dependencies.
+
+#include "graph_builder.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+static hip::GraphNode* NewEmptyNode(uint64_t /* cost */) {
+  return new hip::GraphEmptyNode();
+}
+
+// Returns true if every node follows its dependencies in the order
+static bool ValidOrder(const std::vector<hip::GraphNode*>& order, size_t nodes) {
+  if (order.size() != nodes) {
+    return false;
+  }
+  std::unordered_map<hip::GraphNode*, size_t> position;
+  for (size_t i = 0; i < order.size(); ++i) {
+    position[order[i]] = i;
+  }
+  for (auto node : order) {
+    for (auto dep : node->GetDependencies()) {
+      if (position.at(dep) >= position.at(node)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static double Ms(std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char** argv) {
+  size_t maxNodes = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 100000;
+  if (maxNodes < 1000) {
+    printf("Usage: %s [max nodes per graph, >= 1000]\n", argv[0]);
+    return 1;
+  }
+
+  // Runtime locks require a runtime thread
+  new amd::HostThread();
+  amd::Context::Info info = {};
+  amd::Context* context = new amd::Context(std::vector<amd::Device*>(), info);
+  hip::Device* device = new hip::Device(context, 0);
+  if (!device->Create()) {
+    printf("Couldn't create the device object\n");
+    return 1;
+  }
+
+  using namespace graph_builder;
+  const Shape shapes[] = {
+    {"chain", BuildChain},
+    {"fan", BuildFan},
+    {"binary tree", BuildTree},
+    {"random layers", BuildLayered<64, true>},
+  };
+
+  size_t errors = 0;
+  printf("Graph instantiate, host part: times in ms, %u streams\n",
+         DEBUG_HIP_FORCE_GRAPH_QUEUES);
+  printf("%-14s %7s %8s %8s %8s %8s %8s\n", "shape", "nodes", "clone", "order",
+         "schedule", "critical", "total");
+  for (const auto& shape : shapes) {
+    for (size_t nodes = 1000; nodes <= maxNodes; nodes *= 10) {
+      std::mt19937_64 rng(nodes);
+      hip::Graph* graph = new hip::Graph(device);
+      shape.build_(*graph, rng, nodes, NewEmptyNode);
+
+      auto start = std::chrono::steady_clock::now();
+      std::unordered_map<hip::GraphNode*, hip::GraphNode*> clonedNodes;
+      hip::Graph* clone = graph->clone(clonedNodes);
+      auto cloned = std::chrono::steady_clock::now();
+      std::vector<hip::GraphNode*> order;
+      bool sorted = clone->TopologicalOrder(order);
+      auto ordered = std::chrono::steady_clock::now();
+      clone->SetCriticalPathSchedule(false);
+      clone->ScheduleNodes();
+      auto scheduled = std::chrono::steady_clock::now();
+      clone->SetCriticalPathSchedule(true);
+      clone->ScheduleNodes();
+      auto critical = std::chrono::steady_clock::now();
+
+      if (!sorted || (clonedNodes.size() != nodes) || !ValidOrder(order, nodes)) {
+        errors++;
+      }
+      printf("%-14s %7zu %8.2f %8.2f %8.2f %8.2f %8.2f\n", shape.name_, nodes,
+             Ms(start, cloned), Ms(cloned, ordered), Ms(ordered, scheduled),
+             Ms(scheduled, critical), Ms(start, scheduled));
+      delete clone;
+      delete graph;
+    }
+  }
+
+  delete device;
+  context->release();
+  if (errors != 0) {
+    printf("FAILED: %zu graphs with an invalid order\n", errors);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,142 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Launch overhead of small graphs with the default launch tracking and with
+// hipExtGraphInstantiateFlagLaunchFastPath. The graphs are chains of empty kernels. The tool
+// reports the host time of hipGraphLaunch, while the GPU is busy with the earlier launches,
+// and the time per launch until the stream is idle. The last graph is destroyed while its
+// launches are in flight, which must not wait for the GPU in the fast path. The batch mode
+// submits all launches with one hipExtGraphLaunchBatch call, which rings the doorbell once.
+
+#include <hip/hip_runtime.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define CHECK(cmd)                                                                     \
+  do {                                                                                 \
+    hipError_t status = (cmd);                                                         \
+    if (status != hipSuccess) {                                                        \
+      printf("%s failed: %s at line %d\n", #cmd, hipGetErrorString(status), __LINE__); \
+      exit(1);                                                                         \
+    }                                                                                  \
+  } while (0)
+
+__global__ void Count(unsigned int* counter) {
+  if ((threadIdx.x == 0) && (blockIdx.x == 0)) {
+    atomicAdd(counter, 1);
+  }
+}
+
+static hipGraph_t BuildChain(unsigned int* counter, size_t kernels) {
+  hipGraph_t graph;
+  CHECK(hipGraphCreate(&graph, 0));
+  void* args[] = {&counter};
+  hipKernelNodeParams params = {};
+  params.func = reinterpret_cast<void*>(Count);
+  params.gridDim = dim3(1);
+  params.blockDim = dim3(64);
+  params.kernelParams = args;
+  hipGraphNode_t prev = nullptr;
+  for (size_t i = 0; i < kernels; ++i) {
+    hipGraphNode_t node;
+    CHECK(hipGraphAddKernelNode(&node, graph, (prev == nullptr) ? nullptr : &prev,
+                                (prev == nullptr) ? 0 : 1, &params));
+    prev = node;
+  }
+  return graph;
+}
+
+static double Us(std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+int main(int argc, char** argv) {
+  size_t launches = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 10000;
+  if (launches == 0) {
+    printf("Usage: %s [launches per graph]\n", argv[0]);
+    return 1;
+  }
+
+  unsigned int* counter = nullptr;
+  CHECK(hipHostMalloc(&counter, sizeof(*counter), hipHostMallocDefault));
+  hipStream_t stream;
+  CHECK(hipStreamCreate(&stream));
+
+  size_t errors = 0;
+  printf("Graph launch overhead: %zu launches per graph, times in us\n", launches);
+  printf("%-8s %-10s %12s %12s %12s\n", "kernels", "mode", "launch", "per launch",
+         "destroy");
+  for (size_t kernels : {1, 4, 16}) {
+    hipGraph_t graph = BuildChain(counter, kernels);
+    for (const char* mode : {"default", "fast path", "batch"}) {
+      bool fast_path = (mode[0] != 'd');
+      bool batch = (mode[0] == 'b');
+      hipGraphExec_t exec;
+      CHECK(hipGraphInstantiateWithFlags(&exec, graph,
+          fast_path ? hipExtGraphInstantiateFlagLaunchFastPath : 0));
+      // Warm up the exec and the stream
+      CHECK(hipGraphLaunch(exec, stream));
+      CHECK(hipStreamSynchronize(stream));
+      *counter = 0;
+
+      double launch = 0.0;
+      auto start = std::chrono::steady_clock::now();
+      if (batch) {
+        CHECK(hipExtGraphLaunchBatch(exec, stream, launches, nullptr, nullptr, 0));
+        launch = Us(start, std::chrono::steady_clock::now());
+      } else {
+        for (size_t i = 0; i < launches; ++i) {
+          auto before = std::chrono::steady_clock::now();
+          CHECK(hipGraphLaunch(exec, stream));
+          launch += Us(before, std::chrono::steady_clock::now());
+        }
+      }
+      CHECK(hipStreamSynchronize(stream));
+      auto end = std::chrono::steady_clock::now();
+      errors += (*counter != launches * kernels) ? 1 : 0;
+
+      // Destroy with the launches in flight
+      for (size_t i = 0; i < 100; ++i) {
+        CHECK(hipGraphLaunch(exec, stream));
+      }
+      auto before = std::chrono::steady_clock::now();
+      CHECK(hipGraphExecDestroy(exec));
+      double destroy = Us(before, std::chrono::steady_clock::now());
+      CHECK(hipStreamSynchronize(stream));
+
+      printf("%-8zu %-10s %12.2f %12.2f %12.1f\n", kernels, mode, launch / launches,
+             Us(start, end) / launches, destroy);
+    }
+    CHECK(hipGraphDestroy(graph));
+  }
+
+  CHECK(hipStreamDestroy(stream));
+  CHECK(hipHostFree(counter));
+  if (errors != 0) {
+    printf("FAILED: %zu graphs ran a wrong number of kernels\n", errors);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
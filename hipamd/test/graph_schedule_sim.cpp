@@ -0,0 +1,152 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Host simulation of the graph stream schedulers. Synthetic graphs are built from empty nodes
+// with a configured cost, on a HIP device object without a GPU. Every graph is scheduled with
+// the round robin and the critical path schedulers of hip::Graph and replayed with
+// Graph::SimulateSchedule. The tool reports the estimated makespan against the critical path
+// and the number of cross stream waits, and checks that every cross stream dependency has
+// a signal.
+
+#include "graph_builder.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Empty node with a configured cost
+class SimNode : public hip::GraphEmptyNode {
+ public:
+  explicit SimNode(uint64_t cost) : cost_(cost) {}
+  uint64_t EstimateCost() const override { return cost_; }
+
+  // Returns true if every dependency on another stream signals this node
+  bool SignalsValid() const {
+    for (auto dep : dependencies_) {
+      auto node = static_cast<const SimNode*>(dep);
+      if ((node->stream_id_ != stream_id_) && !node->signal_is_required_) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  uint64_t cost_;
+};
+
+static hip::GraphNode* NewSimNode(uint64_t cost) {
+  return new SimNode(cost);
+}
+
+struct Result {
+  uint64_t makespan_ = 0;
+  uint64_t critical_path_ = 0;
+  uint32_t waits_ = 0;
+  int streams_ = 0;
+};
+
+static Result Schedule(hip::Graph& graph, bool critical_path, size_t& errors) {
+  Result res;
+  graph.SetCriticalPathSchedule(critical_path);
+  graph.ScheduleNodes();
+  graph.SimulateSchedule(&res.makespan_, &res.waits_);
+  res.critical_path_ = graph.critical_path_cost_;
+  res.streams_ = graph.max_streams_;
+  for (auto node : graph.GetNodes()) {
+    if (!static_cast<SimNode*>(node)->SignalsValid()) {
+      errors++;
+    }
+  }
+  if (res.makespan_ < res.critical_path_) {
+    errors++;
+  }
+  return res;
+}
+
+int main(int argc, char** argv) {
+  size_t graphs = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 100;
+  size_t nodes = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 200;
+  if ((graphs == 0) || (nodes < 3)) {
+    printf("Usage: %s [graphs per shape] [nodes per graph, >= 3]\n", argv[0]);
+    return 1;
+  }
+
+  // Runtime locks require a runtime thread
+  new amd::HostThread();
+  amd::Context::Info info = {};
+  amd::Context* context = new amd::Context(std::vector<amd::Device*>(), info);
+  hip::Device* device = new hip::Device(context, 0);
+  if (!device->Create()) {
+    printf("Couldn't create the device object\n");
+    return 1;
+  }
+
+  using namespace graph_builder;
+  const Shape shapes[] = {
+    {"layered", BuildLayered<8, false>},
+    {"fork-join", BuildForkJoin},
+    {"chain with side nodes", BuildChainWithSides},
+  };
+
+  size_t errors = 0;
+  printf("Graph schedule simulation: %zu graphs per shape, %zu nodes, %u streams\n", graphs,
+         nodes, DEBUG_HIP_FORCE_GRAPH_QUEUES);
+  for (const auto& shape : shapes) {
+    double makespan[2] = {};
+    double waits[2] = {};
+    double streams[2] = {};
+    size_t wins = 0;
+    std::mt19937_64 rng(7);
+    for (size_t g = 0; g < graphs; ++g) {
+      hip::Graph* graph = new hip::Graph(device);
+      shape.build_(*graph, rng, nodes, NewSimNode);
+      Result res[2];
+      for (bool critical_path : {false, true}) {
+        res[critical_path] = Schedule(*graph, critical_path, errors);
+        // Makespan relative to the lower bound
+        makespan[critical_path] +=
+            static_cast<double>(res[critical_path].makespan_) / res[critical_path].critical_path_;
+        waits[critical_path] += res[critical_path].waits_;
+        streams[critical_path] += res[critical_path].streams_;
+      }
+      wins += (res[1].makespan_ <= res[0].makespan_) ? 1 : 0;
+      delete graph;
+    }
+    for (bool critical_path : {false, true}) {
+      printf("%-22s %-13s: makespan %5.2fx critical path, %7.1f waits, %4.1f streams\n",
+             shape.name_, critical_path ? "critical path" : "round robin",
+             makespan[critical_path] / graphs, waits[critical_path] / graphs,
+             streams[critical_path] / graphs);
+    }
+    printf("%-22s critical path makespan <= round robin in %zu of %zu graphs\n", shape.name_,
+           wins, graphs);
+  }
+
+  delete device;
+  context->release();
+  if (errors != 0) {
+    printf("FAILED: %zu schedule errors\n", errors);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
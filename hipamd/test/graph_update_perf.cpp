@@ -0,0 +1,171 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Cost of hipGraphExecKernelNodeSetParams on a large graph. The graph is a chain of kernel
+// nodes, which store their argument into the output buffer. Every node is updated with:
+// - the same parameters, which leave the captured packets untouched;
+// - a new argument value on an idle graph, which patches the kernel args in place;
+// - a new argument value while a launch is in flight, which copies the kernel args;
+// - a new block size, which recaptures the packet.
+// An update and launch loop checks the output of every launch and reports the device memory
+// growth, which stays flat when the copied kernel args are recycled.
+
+#include <hip/hip_runtime.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define CHECK(cmd)                                                                     \
+  do {                                                                                 \
+    hipError_t status = (cmd);                                                         \
+    if (status != hipSuccess) {                                                        \
+      printf("%s failed: %s at line %d\n", #cmd, hipGetErrorString(status), __LINE__); \
+      exit(1);                                                                         \
+    }                                                                                  \
+  } while (0)
+
+__global__ void Store(int* out, int index, int value) {
+  if (threadIdx.x == 0) {
+    out[index] = value;
+  }
+}
+
+struct Args {
+  int* out_;
+  int index_;
+  int value_;
+  void* params_[3];
+};
+
+static hipKernelNodeParams NodeParams(Args& args, unsigned int block) {
+  args.params_[0] = &args.out_;
+  args.params_[1] = &args.index_;
+  args.params_[2] = &args.value_;
+  hipKernelNodeParams params = {};
+  params.func = reinterpret_cast<void*>(Store);
+  params.gridDim = dim3(1);
+  params.blockDim = dim3(block);
+  params.kernelParams = args.params_;
+  return params;
+}
+
+// Updates all nodes and returns the time per node in ns
+static double Update(hipGraphExec_t exec, const std::vector<hipGraphNode_t>& nodes,
+                     std::vector<Args>& args, int value, unsigned int block) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    args[i].value_ = value;
+    hipKernelNodeParams params = NodeParams(args[i], block);
+    CHECK(hipGraphExecKernelNodeSetParams(exec, nodes[i], &params));
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / nodes.size();
+}
+
+static size_t Check(const int* out, size_t count, int value) {
+  size_t errors = 0;
+  for (size_t i = 0; i < count; ++i) {
+    errors += (out[i] != value) ? 1 : 0;
+  }
+  return errors;
+}
+
+int main(int argc, char** argv) {
+  size_t count = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 10000;
+  size_t iterations = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 100;
+  if ((count == 0) || (iterations == 0)) {
+    printf("Usage: %s [kernel nodes] [update and launch iterations]\n", argv[0]);
+    return 1;
+  }
+
+  int* out = nullptr;
+  CHECK(hipHostMalloc(&out, count * sizeof(int), hipHostMallocDefault));
+  hipStream_t stream;
+  CHECK(hipStreamCreate(&stream));
+
+  hipGraph_t graph;
+  CHECK(hipGraphCreate(&graph, 0));
+  std::vector<hipGraphNode_t> nodes(count);
+  std::vector<Args> args(count);
+  for (size_t i = 0; i < count; ++i) {
+    args[i].out_ = out;
+    args[i].index_ = static_cast<int>(i);
+    args[i].value_ = 0;
+    hipKernelNodeParams params = NodeParams(args[i], 1);
+    CHECK(hipGraphAddKernelNode(&nodes[i], graph, (i == 0) ? nullptr : &nodes[i - 1],
+                                (i == 0) ? 0 : 1, &params));
+  }
+  hipGraphExec_t exec;
+  CHECK(hipGraphInstantiate(&exec, graph, nullptr, nullptr, 0));
+  CHECK(hipGraphLaunch(exec, stream));
+  CHECK(hipStreamSynchronize(stream));
+
+  printf("Graph exec update: %zu kernel nodes in a chain\n", count);
+  double same = Update(exec, nodes, args, 0, 1);
+  printf("%-28s %8.1f ns/node\n", "same parameters", same);
+  double idle = Update(exec, nodes, args, 1, 1);
+  printf("%-28s %8.1f ns/node\n", "new value, idle graph", idle);
+  CHECK(hipGraphLaunch(exec, stream));
+  double inflight = Update(exec, nodes, args, 2, 1);
+  printf("%-28s %8.1f ns/node\n", "new value, launch in flight", inflight);
+  CHECK(hipStreamSynchronize(stream));
+  double recapture = Update(exec, nodes, args, 3, 2);
+  printf("%-28s %8.1f ns/node\n", "new block size, recapture", recapture);
+
+  // Every launch must see the values of the update before it
+  size_t errors = 0;
+  size_t free_start = 0;
+  size_t free_end = 0;
+  size_t total = 0;
+  CHECK(hipGraphLaunch(exec, stream));
+  CHECK(hipStreamSynchronize(stream));
+  errors += Check(out, count, 3);
+  CHECK(hipMemGetInfo(&free_start, &total));
+  auto start = std::chrono::steady_clock::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    Update(exec, nodes, args, static_cast<int>(it + 4), 2);
+    CHECK(hipGraphLaunch(exec, stream));
+    if ((it % 16) == 15) {
+      CHECK(hipStreamSynchronize(stream));
+      errors += Check(out, count, static_cast<int>(it + 4));
+    }
+  }
+  CHECK(hipStreamSynchronize(stream));
+  auto end = std::chrono::steady_clock::now();
+  errors += Check(out, count, static_cast<int>(iterations + 3));
+  CHECK(hipMemGetInfo(&free_end, &total));
+  double loop = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+  printf("%-28s %8.2f ms/iteration, device memory growth %lld KB\n",
+         "update and launch loop", loop,
+         (static_cast<long long>(free_start) - static_cast<long long>(free_end)) / 1024);
+
+  CHECK(hipGraphExecDestroy(exec));
+  CHECK(hipGraphDestroy(graph));
+  CHECK(hipStreamDestroy(stream));
+  CHECK(hipHostFree(out));
+  if (errors != 0) {
+    printf("FAILED: %zu stale values\n", errors);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
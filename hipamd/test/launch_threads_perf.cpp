@@ -0,0 +1,149 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Host overhead of hipLaunchKernel from several threads. Every thread launches a rotation of
+// 16 distinct kernels on its own stream, so every launch resolves a host stub to its device
+// function and the threads contend on that lookup only. The tool reports the launch rate of
+// all threads together and the time of one launch for 1..N threads, and checks that every
+// launch ran.
+
+#include <hip/hip_runtime.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define CHECK(cmd)                                                                     \
+  do {                                                                                 \
+    hipError_t status = (cmd);                                                         \
+    if (status != hipSuccess) {                                                        \
+      printf("%s failed: %s at line %d\n", #cmd, hipGetErrorString(status), __LINE__); \
+      exit(1);                                                                         \
+    }                                                                                  \
+  } while (0)
+
+template <int N> __global__ void Count(unsigned int* counter) {
+  if ((threadIdx.x == 0) && (blockIdx.x == 0)) {
+    atomicAdd(counter, N + 1);
+  }
+}
+
+template <int... N> static std::vector<const void*> Kernels(std::integer_sequence<int, N...>) {
+  return {reinterpret_cast<const void*>(&Count<N>)...};
+}
+
+// Launches the kernels in a rotation, each kernel adds its index + 1 to the counter
+static void Launch(const std::vector<const void*>& kernels, unsigned int* counter,
+                   hipStream_t stream, size_t launches) {
+  void* args[] = {&counter};
+  for (size_t i = 0; i < launches; ++i) {
+    CHECK(hipLaunchKernel(kernels[i % kernels.size()], dim3(1), dim3(64), args, 0, stream));
+  }
+}
+
+// Expected counter value after the launches of one thread
+static unsigned long long Expected(size_t kernels, size_t launches) {
+  unsigned long long sum = 0;
+  for (size_t i = 0; i < launches; ++i) {
+    sum += (i % kernels) + 1;
+  }
+  return sum;
+}
+
+int main(int argc, char** argv) {
+  size_t maxThreads = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 16;
+  size_t launches = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 10000;
+  if ((maxThreads == 0) || (launches == 0)) {
+    printf("Usage: %s [max threads] [launches per thread]\n", argv[0]);
+    return 1;
+  }
+
+  const std::vector<const void*> kernels = Kernels(std::make_integer_sequence<int, 16>());
+  std::vector<hipStream_t> streams(maxThreads);
+  for (auto& stream : streams) {
+    CHECK(hipStreamCreate(&stream));
+  }
+  unsigned int* counters = nullptr;
+  CHECK(hipHostMalloc(&counters, maxThreads * sizeof(*counters), hipHostMallocDefault));
+
+  // Warm up every stream and resolve every kernel once
+  for (size_t t = 0; t < maxThreads; ++t) {
+    Launch(kernels, &counters[t], streams[t], kernels.size());
+  }
+  CHECK(hipDeviceSynchronize());
+
+  size_t errors = 0;
+  double single = 0.0;
+  printf("hipLaunchKernel from several threads: %zu launches per thread, %zu kernels\n",
+         launches, kernels.size());
+  printf("%-8s %14s %14s %10s\n", "threads", "launches/s", "us/launch", "scaling");
+  for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+    for (size_t t = 0; t < threads; ++t) {
+      counters[t] = 0;
+    }
+    std::atomic<size_t> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t]() {
+        ready++;
+        while (!go.load(std::memory_order_acquire)) {
+          std::this_thread::yield();
+        }
+        Launch(kernels, &counters[t], streams[t], launches);
+      });
+    }
+    while (ready.load() != threads) {
+      std::this_thread::yield();
+    }
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    CHECK(hipDeviceSynchronize());
+    for (size_t t = 0; t < threads; ++t) {
+      errors += (counters[t] != Expected(kernels.size(), launches)) ? 1 : 0;
+    }
+
+    double us = std::chrono::duration<double, std::micro>(end - start).count();
+    double rate = threads * launches / us * 1e6;
+    if (threads == 1) {
+      single = rate;
+    }
+    printf("%-8zu %14.0f %14.2f %9.2fx\n", threads, rate, us / launches, rate / single);
+  }
+
+  CHECK(hipHostFree(counters));
+  for (auto stream : streams) {
+    CHECK(hipStreamDestroy(stream));
+  }
+  if (errors != 0) {
+    printf("FAILED: %zu threads ran a wrong number of kernels\n", errors);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
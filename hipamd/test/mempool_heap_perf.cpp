@@ -0,0 +1,384 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Stream ordered reuse in a memory pool: the MemoryPool::AllocateMemory/FreeMemory cycle of
+// hipMallocAsync/hipFreeAsync. The pool runs on a mock device, which hands out SVM addresses
+// without any memory behind them, and streams are opaque pointers. Pending work on a freed
+// block is marked with a mock event, which never completes during a run. Every selection is
+// checked against a reference model: the last block, freed on the stream, if it fits, and
+// otherwise a linear scan over all free blocks. The free heap of the pool chooses between its
+// linear scan and its per stream indexes by the observed walk of the scan, the report shows
+// the mode at the end of a run. The same size runs allocate one size per stream, which the
+// last freed block serves. The miss runs time requests, which no free block can serve.
+
+#include "hip_event.hpp"
+#include "hip_mempool_impl.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+static constexpr size_t MinSize = 4 * 1024;
+static constexpr uint32_t SizeClasses = 9;     // 4KB .. 1MB
+static constexpr uint32_t ReleasedRatio = 8;   // Every N-th free is a synchronous release
+
+// Device memory of the mock device. The pool only reads the virtual address
+class MockMemory : public device::Memory {
+ public:
+  MockMemory(amd::Memory& owner) : device::Memory(owner) {}
+};
+
+// A device, which allocates the address range only
+class MockDevice : public amd::Device {
+ public:
+  MockDevice() {
+    info_.type_ = CL_DEVICE_TYPE_GPU;
+    info_.maxMemAllocSize_ = uint64_t(1) << 40;
+    info_.memBaseAddrAlign_ = 4096;
+    info_.svmCapabilities_ = CL_DEVICE_SVM_COARSE_GRAIN_BUFFER;
+    settings_ = new device::Settings();
+  }
+
+  void* svmAlloc(amd::Context& context, size_t size, size_t alignment, cl_svm_mem_flags flags,
+                 void* svmPtr) const {
+    if (svmPtr != nullptr) {
+      return svmPtr;
+    }
+    svmPtr = reinterpret_cast<void*>(next_);
+    next_ += amd::alignUp(size, 4096);
+    amd::Memory* mem = new (context) amd::Buffer(context, flags, size, svmPtr);
+    if (!mem->create(nullptr)) {
+      mem->release();
+      return nullptr;
+    }
+    amd::MemObjMap::AddMemObj(svmPtr, mem);
+    return svmPtr;
+  }
+  void svmFree(void* ptr) const {
+    amd::Memory* mem = amd::MemObjMap::FindMemObj(ptr);
+    if (mem != nullptr) {
+      amd::MemObjMap::RemoveMemObj(ptr);
+      mem->release();
+    }
+  }
+  device::Memory* createMemory(amd::Memory& owner) const { return new MockMemory(owner); }
+
+  device::VirtualDevice* createVirtualDevice(amd::CommandQueue* queue = nullptr) {
+    return nullptr;
+  }
+  device::Program* createProgram(amd::Program& owner, amd::option::Options* options = nullptr) {
+    return nullptr;
+  }
+  device::Memory* createMemory(size_t size) const { return nullptr; }
+  bool createSampler(const amd::Sampler&, device::Sampler**) const { return false; }
+  device::Memory* createView(amd::Memory& owner, const device::Memory& parent) const {
+    return nullptr;
+  }
+  device::Signal* createSignal() const { return nullptr; }
+  bool bindExternalDevice(uint flags, void* const pDevice[], void* pContext, bool validateOnly) {
+    return false;
+  }
+  bool unbindExternalDevice(uint flags, void* const pDevice[], void* pContext,
+                            bool validateOnly) {
+    return false;
+  }
+  bool globalFreeMemory(size_t* freeMemory) const { return false; }
+  bool importExtSemaphore(void** extSemaphore, const amd::Os::FileDesc& handle,
+                          amd::ExternalSemaphoreHandleType sem_handle_type) {
+    return false;
+  }
+  void DestroyExtSemaphore(void* extSemaphore) {}
+  void* virtualAlloc(void* addr, size_t size, size_t alignment) { return nullptr; }
+  bool virtualFree(void* addr) { return false; }
+  bool SetMemAccess(void* va_addr, size_t va_size, VmmAccess access_flags) { return false; }
+  bool GetMemAccess(void* va_addr, VmmAccess* access_flags_ptr) const { return false; }
+  bool ValidateMemAccess(amd::Memory& mem, bool read_write) const { return false; }
+#if defined(WITH_COMPILER_LIB)
+  amd::Compiler* compiler() const { return nullptr; }
+#endif
+
+ private:
+  mutable uintptr_t next_ = uintptr_t(1) << 44;   //!< The next free address
+};
+
+// HIP event of a free with pending work. The work completes only, when the pool waits for it
+class PendingEvent : public hip::Event {
+ public:
+  PendingEvent() : hip::Event(0) {}
+  hipError_t query() { return done_ ? hipSuccess : hipErrorNotReady; }
+  hipError_t synchronize() {
+    done_ = true;
+    return hipSuccess;
+  }
+
+ private:
+  bool done_ = false;
+};
+
+// Reference model of the free heap: the same free blocks, searched linearly after the last
+// block, freed on the stream
+struct Reference {
+  struct Entry {
+    std::set<hip::Stream*> safe_;
+    bool released_;
+  };
+  typedef std::map<hip::Heap::Key, Entry> Blocks;
+  Blocks blocks_;
+  std::map<hip::Stream*, hip::Heap::Key> last_freed_;
+
+  amd::Memory* Take(Blocks::iterator it) {
+    for (auto last = last_freed_.begin(); last != last_freed_.end();) {
+      last = (last->second == it->first) ? last_freed_.erase(last) : std::next(last);
+    }
+    amd::Memory* memory = it->first.second;
+    blocks_.erase(it);
+    return memory;
+  }
+
+  amd::Memory* Find(size_t size, hip::Stream* stream) {
+    auto last = last_freed_.find(stream);
+    if ((last != last_freed_.end()) && (last->second.first >= size) &&
+        (last->second.first <= (size / 8.0) * 9)) {
+      return Take(blocks_.find(last->second));
+    }
+    for (auto it = blocks_.lower_bound({size, nullptr}); it != blocks_.end(); ++it) {
+      if (it->second.released_ || (it->second.safe_.count(stream) != 0)) {
+        return Take(it);
+      }
+    }
+    return nullptr;
+  }
+
+  // A free without a stream is a synchronous release. The allocating stream stays safe
+  void Add(amd::Memory* memory, hip::Stream* stream, hip::Stream* free_stream) {
+    hip::Heap::Key key = {memory->getSize(), memory};
+    Entry& entry = blocks_[key];
+    entry.safe_ = {stream};
+    if (free_stream != nullptr) {
+      entry.safe_.insert(free_stream);
+    }
+    entry.released_ = (free_stream == nullptr);
+    for (auto safe : entry.safe_) {
+      last_freed_[safe] = key;
+    }
+  }
+
+  void AddSafeStream(hip::Stream* event_stream, hip::Stream* wait_stream) {
+    if (event_stream == wait_stream) {
+      return;
+    }
+    for (auto& it : blocks_) {
+      if (it.second.safe_.count(event_stream) != 0) {
+        it.second.safe_.insert(wait_stream);
+      }
+    }
+  }
+};
+
+static hip::Stream* FakeStream(size_t index) {
+  return reinterpret_cast<hip::Stream*>(0x1000 * (index + 1));
+}
+
+// Frees the pointer on the stream with pending work or releases it synchronously
+static void Free(hip::MemoryPool* pool, void* ptr, hip::Stream* free_stream) {
+  amd::Memory* memory = amd::MemObjMap::FindMemObj(ptr);
+  pool->FreeMemory(memory, free_stream, (free_stream != nullptr) ? new PendingEvent() : nullptr);
+}
+
+// Fills the pool with freed blocks, spread across the streams
+static void Fill(hip::MemoryPool* pool, Reference& reference, std::mt19937_64& rng,
+                 size_t numBlocks, size_t numStreams, bool released) {
+  std::vector<std::pair<void*, hip::Stream*>> blocks(numBlocks);
+  for (auto& block : blocks) {
+    size_t size = MinSize << (rng() % SizeClasses);
+    size += (rng() % 16) * hip::SubAllocator::kAlignment;
+    block.second = FakeStream(rng() % numStreams);
+    block.first = pool->AllocateMemory(size, block.second);
+  }
+  for (const auto& block : blocks) {
+    hip::Stream* free_stream = (released && ((rng() % ReleasedRatio) == 0)) ?
+        nullptr : block.second;
+    Free(pool, block.first, free_stream);
+    reference.Add(amd::MemObjMap::FindMemObj(block.first), block.second, free_stream);
+  }
+}
+
+// Every waitRatio-th op is a stream wait on another stream, 0 disables the waits. The same
+// size runs allocate a fixed size on every stream and free it on the same stream
+static void Run(hip::Device* device, size_t numBlocks, size_t numStreams, size_t ops,
+                size_t waitRatio, bool sameSize, size_t& errors) {
+  std::mt19937_64 rng(numBlocks * 31 + numStreams);
+  hip::MemoryPool* pool = new hip::MemoryPool(device);
+  Reference reference;
+  Fill(pool, reference, rng, numBlocks, numStreams, true);
+
+  struct Op {
+    size_t size_;
+    hip::Stream* stream_;
+    hip::Stream* free_stream_;
+    hip::Stream* wait_stream_;
+  };
+  std::vector<Op> sequence(ops);
+  for (auto& op : sequence) {
+    size_t stream = rng() % numStreams;
+    op.size_ = sameSize ? ((MinSize << (stream % SizeClasses)) + stream) :
+                          ((MinSize << (rng() % SizeClasses)) + (rng() % MinSize));
+    op.stream_ = FakeStream(stream);
+    op.free_stream_ = sameSize ? op.stream_ : FakeStream(rng() % numStreams);
+    if ((rng() % ReleasedRatio) == 0) {
+      op.free_stream_ = nullptr;
+    }
+    op.wait_stream_ = ((waitRatio != 0) && ((rng() % waitRatio) == 0)) ?
+        FakeStream(rng() % numStreams) : nullptr;
+  }
+
+  // A missed request allocates a new block on the device, which the free adds to the pool
+  std::vector<void*> found(ops);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < ops; ++i) {
+    const Op& op = sequence[i];
+    if (op.wait_stream_ != nullptr) {
+      pool->AddSafeStream(op.stream_, op.wait_stream_);
+    }
+    found[i] = pool->AllocateMemory(op.size_, op.stream_);
+    Free(pool, found[i], op.free_stream_);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double poolNs = std::chrono::duration<double, std::nano>(end - start).count() / ops;
+  bool indexed = pool->IsFreeHeapIndexed();
+
+  // Replay the sequence on the reference. A miss must return a block, the pool didn't have
+  std::unordered_set<amd::Memory*> known;
+  for (const auto& it : reference.blocks_) {
+    known.insert(it.first.second);
+  }
+  size_t misses = 0;
+  for (size_t i = 0; i < ops; ++i) {
+    const Op& op = sequence[i];
+    if (op.wait_stream_ != nullptr) {
+      reference.AddSafeStream(op.stream_, op.wait_stream_);
+    }
+    amd::Memory* memory = amd::MemObjMap::FindMemObj(found[i]);
+    amd::Memory* expected = reference.Find(op.size_, op.stream_);
+    if (expected == nullptr) {
+      misses++;
+      if (!known.insert(memory).second) {
+        errors++;
+      }
+    } else if (expected != memory) {
+      errors++;
+    }
+    reference.Add(memory, op.stream_, op.free_stream_);
+  }
+
+  printf("%7zu blocks %3zu streams %-5s: pool %8.1f ns/op (%-7s), %5.1f%% misses\n",
+         numBlocks, numStreams, sameSize ? "same" : "mixed", poolNs,
+         indexed ? "indexed" : "scan", 100.0 * misses / ops);
+
+  // The pool waits for the pending events and releases the blocks on destruction
+  pool->release();
+}
+
+// All free blocks have pending work on another stream, so every request misses. The new
+// blocks stay busy until the end of the run
+static void RunMisses(hip::Device* device, size_t numBlocks, size_t ops, size_t& errors) {
+  std::mt19937_64 rng(numBlocks);
+  hip::MemoryPool* pool = new hip::MemoryPool(device);
+  Reference reference;
+  Fill(pool, reference, rng, numBlocks, 1, false);
+
+  std::vector<void*> busy(ops);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < ops; ++i) {
+    busy[i] = pool->AllocateMemory(MinSize, FakeStream(1));
+  }
+  auto end = std::chrono::steady_clock::now();
+  double poolNs = std::chrono::duration<double, std::nano>(end - start).count() / ops;
+  bool indexed = pool->IsFreeHeapIndexed();
+
+  for (auto ptr : busy) {
+    amd::Memory* memory = amd::MemObjMap::FindMemObj(ptr);
+    if (reference.blocks_.count({memory->getSize(), memory}) != 0) {
+      errors++;
+    }
+    Free(pool, ptr, FakeStream(1));
+  }
+  printf("%7zu blocks misses:            pool %8.1f ns/op (%-7s)\n",
+         numBlocks, poolNs, indexed ? "indexed" : "scan");
+  pool->release();
+}
+
+int main(int argc, char** argv) {
+  size_t maxBlocks = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 65536;
+  size_t maxStreams = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 64;
+  size_t ops = (argc > 3) ? strtoull(argv[3], nullptr, 0) : 100000;
+  size_t waitRatio = (argc > 4) ? strtoull(argv[4], nullptr, 0) : 64;
+  if ((maxBlocks == 0) || (maxStreams == 0) || (ops == 0)) {
+    printf("Usage: %s [max free blocks] [max streams] [ops] [ops per stream wait]\n",
+           argv[0]);
+    return 1;
+  }
+
+  // Runtime locks require a runtime thread
+  new amd::HostThread();
+  // The release on memory pressure queries the memory info of a real GPU
+  AMD_DIRECT_DISPATCH = false;
+  MockDevice* mockDevice = new MockDevice();
+  amd::Context::Info info = {};
+  amd::Context* context = new amd::Context(std::vector<amd::Device*>(1, mockDevice), info);
+  hip::Device* device = new hip::Device(context, 0);
+  if (!device->Create()) {
+    printf("Couldn't create the device object\n");
+    return 1;
+  }
+  // HIP events belong to the current device
+  hip::tls.device_ = device;
+
+  size_t errors = 0;
+  printf("Memory pool: AllocateMemory + FreeMemory per op, stream wait every %zu ops\n",
+         waitRatio);
+  for (bool sameSize : {false, true}) {
+    for (size_t blocks = 1024; blocks <= maxBlocks; blocks *= 4) {
+      for (size_t streams = 1; streams <= maxStreams; streams *= 4) {
+        Run(device, blocks, streams, ops, waitRatio, sameSize, errors);
+      }
+    }
+  }
+  for (size_t blocks = 256; blocks <= maxBlocks; blocks *= 2) {
+    RunMisses(device, blocks, std::max<size_t>(ops / 100, 1), errors);
+  }
+  hip::tls.device_ = nullptr;
+  delete device;
+  context->release();
+  delete mockDevice;
+
+  if (errors != 0) {
+    printf("FAILED: %zu selections differ from the reference\n", errors);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
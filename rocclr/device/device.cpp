@@ -95,7 +95,7 @@ static_assert(static_cast<uint32_t>(device::Memory::MemAccess::kMemAccessReadWri
 
 namespace amd {
 
-amd::Monitor Device::lockP2P_("Lock P2P ON/OFF");
+amd::Monitor Device::lockP2P_("Lock P2P ON/OFF", true);
 std::pair<const Isa*, const Isa*> Isa::supportedIsas() {
   constexpr amd::Isa::Feature NONE = amd::Isa::Feature::Unsupported;
   constexpr amd::Isa::Feature ANY  = amd::Isa::Feature::Any;
@@ -328,15 +328,36 @@ Monitor Device::p2p_stage_ops_(true);
 Memory* Device::p2p_stage_ = nullptr;
 
 std::shared_mutex MemObjMap::AllocatedLock_ ROCCLR_INIT_PRIORITY(101);
-std::map<uintptr_t, amd::Memory*> MemObjMap::MemObjMap_ ROCCLR_INIT_PRIORITY(101);
-std::map<uintptr_t, amd::Memory*> MemObjMap::VirtualMemObjMap_ ROCCLR_INIT_PRIORITY(101);
+std::map<uintptr_t, MemObjMap::Range> MemObjMap::MemObjMap_ ROCCLR_INIT_PRIORITY(101);
+std::map<uintptr_t, MemObjMap::Range> MemObjMap::VirtualMemObjMap_ ROCCLR_INIT_PRIORITY(101);
+// Stamp 0 is never used, so the default initialized caches are always invalid
+MemObjMap::RangeStamp MemObjMap::Stamps_[1 << MemObjMap::kRangeStampBits];
+thread_local MemObjMap::LookupCache MemObjMap::LastHit_;
+
+const std::pair<const uintptr_t, MemObjMap::Range>* MemObjMap::FindRange(
+    const std::map<uintptr_t, Range>& map, uintptr_t key) {
+  auto it = map.upper_bound(key);
+  if (it == map.begin()) {
+    return nullptr;
+  }
+
+  --it;
+  // Check if the key is in the range
+  return (key < it->second.end_) ? &(*it) : nullptr;
+}
 
 void MemObjMap::AddMemObj(const void* k, amd::Memory* v) {
   std::unique_lock lock(AllocatedLock_);
-  auto rval = MemObjMap_.insert({ reinterpret_cast<uintptr_t>(k), v });
+  uintptr_t key = reinterpret_cast<uintptr_t>(k);
+  auto rval = MemObjMap_.insert({ key, { key + v->getSize(), v } });
   if (!rval.second) {
-    DevLogPrintfError("Memobj map already has an entry for ptr: 0x%x",
-                      reinterpret_cast<uintptr_t>(k));
+    DevLogPrintfError("Memobj map already has an entry for ptr: 0x%x", key);
+    return;
+  }
+  // A new range can shadow the tail of the previous one, hence invalidate its caches
+  auto prev = rval.first;
+  if ((prev != MemObjMap_.begin()) && (key < (--prev)->second.end_)) {
+    InvalidateRange(prev->first);
   }
 }
 
@@ -345,27 +366,37 @@ void MemObjMap::RemoveMemObj(const void* k) {
   auto rval = MemObjMap_.erase(reinterpret_cast<uintptr_t>(k));
   guarantee(rval == 1, "Memobj map does not have ptr: 0x%x",
                         reinterpret_cast<uintptr_t>(k));
+  InvalidateRange(reinterpret_cast<uintptr_t>(k));
 }
 
 amd::Memory* MemObjMap::FindMemObj(const void* k, size_t* offset) {
-  std::shared_lock lock(AllocatedLock_);
   uintptr_t key = reinterpret_cast<uintptr_t>(k);
-  auto it = MemObjMap_.upper_bound(key);
-  if (it == MemObjMap_.begin()) {
-    return nullptr;
-  }
-
-  --it;
-  amd::Memory* mem = it->second;
-  if (key >= it->first && key < (it->first + mem->getSize())) {
+  // Fast path: the same allocation is usually accessed by the thread multiple times in a row.
+  // The cached entry is valid only if its range didn't change since the lookup
+  LookupCache& cache = LastHit_;
+  if ((key >= cache.start_) && (key < cache.end_) &&
+      (cache.stamp_ == Stamp(cache.start_).load(std::memory_order_acquire))) {
     if (offset != nullptr) {
-      *offset = key - it->first;
+      *offset = key - cache.start_;
     }
-    // the k is in the range
-    return mem;
-  } else {
+    return cache.mem_;
+  }
+
+  std::shared_lock lock(AllocatedLock_);
+  auto range = FindRange(MemObjMap_, key);
+  if (range == nullptr) {
     return nullptr;
   }
+
+  if (offset != nullptr) {
+    *offset = key - range->first;
+  }
+  // The stamps change under the exclusive lock only
+  cache.stamp_ = Stamp(range->first).load(std::memory_order_relaxed);
+  cache.start_ = range->first;
+  cache.end_ = range->second.end_;
+  cache.mem_ = range->second.mem_;
+  return range->second.mem_;
 }
 
 void MemObjMap::UpdateAccess(amd::Device *peerDev) {
@@ -375,10 +406,11 @@ void MemObjMap::UpdateAccess(amd::Device *peerDev) {
   // Provides access to all memory allocated on peerDev but
   // hsa_amd_agents_allow_access was not called because there was no peer
   std::shared_lock lock(AllocatedLock_);
-  for (auto it : MemObjMap_) {
-    const std::vector<Device*>& devices = it.second->getContext().devices();
+  for (const auto& it : MemObjMap_) {
+    amd::Memory* memObj = it.second.mem_;
+    const std::vector<Device*>& devices = memObj->getContext().devices();
     if (devices.size() == 1 && devices[0] == peerDev) {
-      device::Memory* devMem = it.second->getDeviceMemory(*devices[0]);
+      device::Memory* devMem = memObj->getDeviceMemory(*devices[0]);
       if (!devMem->getAllowedPeerAccess()) {
         peerDev->deviceAllowAccess(reinterpret_cast<void*>(it.first));
         devMem->setAllowedPeerAccess(true);
@@ -391,11 +423,12 @@ void MemObjMap::Purge(amd::Device* dev) {
   assert(dev != nullptr);
   std::unique_lock lock(AllocatedLock_);
   for (auto it = MemObjMap_.cbegin(); it != MemObjMap_.cend(); ) {
-    amd::Memory* memObj = it->second;
+    amd::Memory* memObj = it->second.mem_;
     unsigned int flags = memObj->getMemFlags();
     const std::vector<Device*>& devices = memObj->getContext().devices();
     if (devices.size() == 1 && devices[0] == dev && !(flags & ROCCLR_MEM_INTERNAL_MEMORY)) {
       memObj->release();
+      InvalidateRange(it->first);
       it = MemObjMap_.erase(it);
     } else {
       ++it;
@@ -405,10 +438,10 @@ void MemObjMap::Purge(amd::Device* dev) {
 
 void MemObjMap::AddVirtualMemObj(const void* k, amd::Memory* v) {
   std::unique_lock lock(AllocatedLock_);
-  auto rval = VirtualMemObjMap_.insert({ reinterpret_cast<uintptr_t>(k), v });
+  uintptr_t key = reinterpret_cast<uintptr_t>(k);
+  auto rval = VirtualMemObjMap_.insert({ key, { key + v->getSize(), v } });
   if (!rval.second) {
-    DevLogPrintfError("Virtual Memobj map already has an entry for ptr: 0x%x",
-                      reinterpret_cast<uintptr_t>(k));
+    DevLogPrintfError("Virtual Memobj map already has an entry for ptr: 0x%x", key);
   }
 }
 
@@ -421,20 +454,8 @@ void MemObjMap::RemoveVirtualMemObj(const void* k) {
 
 amd::Memory* MemObjMap::FindVirtualMemObj(const void* k) {
   std::shared_lock lock(AllocatedLock_);
-  uintptr_t key = reinterpret_cast<uintptr_t>(k);
-  auto it = VirtualMemObjMap_.upper_bound(key);
-  if (it == VirtualMemObjMap_.begin()) {
-    return nullptr;
-  }
-
-  --it;
-  amd::Memory* mem = it->second;
-  if (key >= it->first && key < (it->first + mem->getSize())) {
-    // the k is in the range
-    return mem;
-  } else {
-    return nullptr;
-  }
+  auto range = FindRange(VirtualMemObjMap_, reinterpret_cast<uintptr_t>(k));
+  return (range != nullptr) ? range->second.mem_ : nullptr;
 }
 
 //==================================================================================================
@@ -1332,6 +1332,10 @@ class VirtualDevice : public amd::HeapObject {
   virtual bool dispatchAqlPacket(uint8_t* aqlpacket,
                                  const std::string& kernelName,
                                  amd::AccumulateCommand* vcmd = nullptr) = 0;
+  //! Starts a batch of captured AQL packets. The doorbell is rung once at the end of the batch
+  virtual void beginPacketBatch() {}
+  //! Ends the batch of captured AQL packets and rings the doorbell for all of them
+  virtual void endPacketBatch() {}
 
   //! Returns the number of outstanding HSA async handlers
   std::atomic<uint64_t>& QueuedAsyncHandlers() const { return queued_async_handlers_; }
@@ -1381,12 +1385,54 @@ class MemObjMap : public AllStatic {
   static amd::Memory* FindVirtualMemObj(const void* k);
 
  private:
+  //! Address range, owned by a memory object. The end address is cached in the map entry,
+  //! so the lookup doesn't have to dereference every visited memory object
+  struct Range {
+    uintptr_t end_;       //!< The end address of the range (exclusive)
+    amd::Memory* mem_;    //!< The memory object, which owns the range
+  };
+
+  //! The number of range stamps must be a power of 2
+  static constexpr uint32_t kRangeStampBits = 8;
+
+  //! Version of the ranges, which start addresses hash to the stamp. It changes, when one
+  //! of the ranges is removed or shadowed by a new range inside of it
+  struct alignas(64) RangeStamp {
+    std::atomic<uint64_t> value_{1};
+  };
+
+  //! The last successful lookup of the current thread
+  struct LookupCache {
+    uint64_t stamp_ = 0;          //!< The stamp of the range, when the entry was cached
+    uintptr_t start_ = 0;         //!< The start address of the cached range
+    uintptr_t end_ = 0;           //!< The end address of the cached range
+    amd::Memory* mem_ = nullptr;  //!< The cached memory object
+  };
+
+  //! Finds the range for the specified key in the container. The caller must hold the lock
+  static const std::pair<const uintptr_t, Range>* FindRange(
+      const std::map<uintptr_t, Range>& map, uintptr_t key);
+
+  //! Returns the stamp of the range with the specified start address
+  static std::atomic<uint64_t>& Stamp(uintptr_t start) {
+    return Stamps_[(start * 0x9E3779B97F4A7C15ull) >> (64 - kRangeStampBits)].value_;
+  }
+
+  //! Invalidates the cached lookups of the range. The caller must hold the lock
+  static void InvalidateRange(uintptr_t start) {
+    Stamp(start).fetch_add(1, std::memory_order_release);
+  }
+
   //!< the mem object<->hostptr information container
-  static std::map<uintptr_t, amd::Memory*> MemObjMap_;
+  static std::map<uintptr_t, Range> MemObjMap_;
   //!< the virtual mem object<->hostptr information container
-  static std::map<uintptr_t, amd::Memory*> VirtualMemObjMap_;
+  static std::map<uintptr_t, Range> VirtualMemObjMap_;
   //!< Shared read/write lock
   static std::shared_mutex AllocatedLock_;
+  //!< Validate the lookup caches, an update invalidates only the caches of the changed ranges
+  static RangeStamp Stamps_[1 << kRangeStampBits];
+  //!< The last hit of FindMemObj() in the current thread, validated without the lock
+  static thread_local LookupCache LastHit_;
 };
 
 /// @brief Instruction Set Architecture properties.
@@ -2165,7 +2211,8 @@ class Device : public RuntimeObject {
   uint64_t stack_size_{1024};       //!< Device stack size
   device::Memory* initial_heap_buffer_;   //!< Initial heap buffer
   uint64_t initial_heap_size_{HIP_INITIAL_DM_SIZE};  //!< Initial device heap size
-  amd::Monitor activeQueuesLock_ {}; //!< Guards access to the activeQueues set
+  //! Guards access to the activeQueues set
+  amd::Monitor activeQueuesLock_ {"Device::activeQueuesLock", false};
   std::unordered_set<amd::CommandQueue*> activeQueues; //!< The set of active queues
  private:
   const Isa *isa_;                //!< Device isa
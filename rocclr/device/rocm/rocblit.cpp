@@ -40,7 +40,9 @@ DmaBlitManager::DmaBlitManager(VirtualGPU& gpu, Setup setup)
 inline void DmaBlitManager::synchronize() const {
   if (syncOperation_) {
     gpu().releaseGpuMemoryFence();
-    gpu().releasePinnedMem();
+    if (!ROC_PINNED_MEMORY_CACHE_PERSISTENT) {
+      gpu().releasePinnedMem();
+    }
   }
 }
 
@@ -2560,6 +2562,9 @@ amd::Memory* DmaBlitManager::pinHostMemory(const void* hostMem, size_t pinSize,
   amdMemory = gpu().findPinnedMem(tmpHost, pinAllocSize);
 
   if (nullptr != amdMemory) {
+    // The cached memory can start before the requested range
+    partial = reinterpret_cast<const char*>(hostMem) -
+              reinterpret_cast<const char*>(amdMemory->getHostMem());
     return amdMemory;
   }
 
@@ -0,0 +1,135 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <map>
+
+namespace amd::roc {
+
+//! Byte budgeted LRU cache of pinned host ranges. The cache only tracks the ranges. The pinned
+//! memory objects and the GPU state are provided by the owner, hence the cache logic doesn't
+//! depend on HSA and can be tested on the host
+template <typename Memory>
+class PinnedCache {
+ public:
+  explicit PinnedCache(size_t budget) : budget_(budget) {}
+
+  //! Returns the cached memory, which contains the host range [start, start + size),
+  //! and makes it the most recently used one. Returns nullptr on a miss
+  Memory* Find(uintptr_t start, size_t size) {
+    // Walk back from the last range, which starts at or before the requested address.
+    // The cached ranges may overlap, so the closest one doesn't necessarily contain the request.
+    // A range, which starts more than the biggest range size before the end, can't contain it
+    auto it = ranges_.upper_bound(start);
+    while (it != ranges_.begin()) {
+      --it;
+      if ((start + size) > (it->first + maxSize_)) {
+        break;
+      }
+      if ((start + size) <= (it->first + it->second.size_)) {
+        lru_.splice(lru_.end(), lru_, it->second.lru_);
+        ++hits_;
+        return it->second.memory_;
+      }
+    }
+    ++misses_;
+    return nullptr;
+  }
+
+  //! Adds the memory for the host range [start, start + size) as the most recently used one.
+  //! A cached range at the same address is replaced. The least recently used ranges are evicted
+  //! until the cache fits into the budget, but the new range always stays. evict(memory) is
+  //! called for every removed memory object. Returns false if the memory is already cached
+  template <typename Evict>
+  bool Add(Memory* memory, uintptr_t start, size_t size, Evict evict) {
+    auto it = ranges_.find(start);
+    if (it != ranges_.end()) {
+      if (it->second.memory_ == memory) {
+        // The memory came from the cache
+        return false;
+      }
+      // The new range starts at the same address, but it's bigger. Replace the old one
+      Remove(it, evict);
+    }
+    lru_.push_back(start);
+    ranges_[start] = {memory, size, std::prev(lru_.end())};
+    size_ += size;
+    maxSize_ = std::max(maxSize_, size);
+    while ((size_ > budget_) && (lru_.size() > 1)) {
+      Remove(ranges_.find(lru_.front()), evict);
+    }
+    return true;
+  }
+
+  //! Removes all ranges from the cache. evict(memory) is called for every memory object
+  template <typename Evict>
+  void Clear(Evict evict) {
+    while (!ranges_.empty()) {
+      Remove(ranges_.begin(), evict);
+    }
+  }
+
+  //! Returns the number of cached ranges
+  size_t NumRanges() const { return ranges_.size(); }
+
+  //! Returns the total size of the cached ranges
+  size_t Size() const { return size_; }
+
+  //! Returns the number of lookups, which found a range
+  uint64_t Hits() const { return hits_; }
+
+  //! Returns the number of lookups, which required new pinning
+  uint64_t Misses() const { return misses_; }
+
+ private:
+  struct Range {
+    Memory* memory_;                        //!< Pinned memory object
+    size_t size_;                           //!< Size of the pinned host range
+    std::list<uintptr_t>::iterator lru_;    //!< Position in the LRU list
+  };
+
+  template <typename Evict>
+  void Remove(typename std::map<uintptr_t, Range>::iterator it, Evict& evict) {
+    size_ -= it->second.size_;
+    lru_.erase(it->second.lru_);
+    Memory* memory = it->second.memory_;
+    ranges_.erase(it);
+    if (ranges_.empty()) {
+      maxSize_ = 0;
+    }
+    evict(memory);
+  }
+
+  std::map<uintptr_t, Range> ranges_;   //!< Cached ranges, indexed by the host address
+  std::list<uintptr_t> lru_;            //!< Host addresses, the least recently used first
+  size_t budget_;                       //!< Size limit of the cache in bytes
+  size_t size_ = 0;                     //!< Total size of the cached ranges
+  size_t maxSize_ = 0;                  //!< The biggest range size since the cache was empty
+  uint64_t hits_ = 0;                   //!< The number of lookups, which found a range
+  uint64_t misses_ = 0;                 //!< The number of lookups, which required new pinning
+};
+
+}  // namespace amd::roc
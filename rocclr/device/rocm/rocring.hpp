@@ -0,0 +1,92 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace amd::roc {
+
+//! Ring of memory chunks, which grows on pressure instead of waiting for the GPU.
+//! The ring only orders the chunks. The chunk resources and the GPU state are provided by the
+//! owner, hence the ring logic doesn't depend on HSA and can be simulated on the host
+template <typename Chunk>
+class ChunkRing {
+ public:
+  explicit ChunkRing(uint32_t max_chunks) : max_chunks_(max_chunks) {
+    chunks_.reserve(max_chunks);
+  }
+
+  //! Appends a chunk to the end of the ring
+  void Append(const Chunk& chunk) { chunks_.push_back(chunk); }
+
+  //! Returns the active chunk
+  Chunk& Active() { return chunks_[active_]; }
+
+  //! Returns all chunks in the order of reuse
+  const std::vector<Chunk>& Chunks() const { return chunks_; }
+
+  //! Switches to the next chunk in the order of reuse. If the GPU still uses the next chunk,
+  //! then a new chunk is created after the active one, until the ring reaches the maximum size.
+  //! The insertion point keeps the oldest chunk as the next one. Otherwise the CPU waits.
+  //! busy(chunk) returns true if the GPU still uses the chunk, create(chunk) allocates the
+  //! resources of a new chunk and wait(chunk) blocks until the GPU is done with the chunk
+  template <typename Busy, typename Create, typename Wait>
+  Chunk& Advance(Busy busy, Create create, Wait wait) {
+    ++switches_;
+    uint32_t next = (active_ + 1) % NumChunks();
+    if (busy(chunks_[next])) {
+      Chunk chunk = {};
+      if ((NumChunks() < max_chunks_) && create(chunk)) {
+        next = active_ + 1;
+        chunks_.insert(chunks_.begin() + next, chunk);
+        ++grows_;
+      } else {
+        ++stalls_;
+        wait(chunks_[next]);
+      }
+    }
+    active_ = next;
+    return chunks_[active_];
+  }
+
+  //! Returns the number of chunks in the ring
+  uint32_t NumChunks() const { return static_cast<uint32_t>(chunks_.size()); }
+
+  //! Returns the number of chunk switches
+  uint64_t Switches() const { return switches_; }
+
+  //! Returns the number of CPU waits for a busy chunk
+  uint64_t Stalls() const { return stalls_; }
+
+  //! Returns the number of chunks, added on pressure
+  uint64_t Grows() const { return grows_; }
+
+ private:
+  std::vector<Chunk> chunks_;   //!< Ring of chunks in the order of reuse
+  uint32_t max_chunks_;         //!< The maximum number of chunks the ring can grow to
+  uint32_t active_ = 0;         //!< The index of the current active chunk
+  uint64_t switches_ = 0;       //!< The number of chunk switches
+  uint64_t stalls_ = 0;         //!< The number of CPU waits for a busy chunk
+  uint64_t grows_ = 0;          //!< The number of chunks, added on pressure
+};
+
+}  // namespace amd::roc
@@ -38,6 +38,7 @@
 #include "hsa/amd_hsa_queue.h"
 #include "hsa/amd_hsa_signal.h"
 
+#include <algorithm>
 #include <fstream>
 #include <limits>
 #include <memory>
@@ -250,12 +251,11 @@ bool HsaAmdSignalHandler(hsa_signal_value_t value, void* arg) {
 // ================================================================================================
 bool VirtualGPU::MemoryDependency::create(size_t numMemObj) {
   if (numMemObj > 0) {
-    // Allocate the array of memory objects for dependency tracking
-    memObjectsInQueue_ = new MemoryState[numMemObj];
-    if (nullptr == memObjectsInQueue_) {
-      return false;
-    }
-    memset(memObjectsInQueue_, 0, sizeof(MemoryState) * numMemObj);
+    // Reserve the storage for dependency tracking, so the tracker doesn't allocate memory
+    // under the normal conditions
+    kernelMemObjects_.reserve(numMemObj);
+    busyRanges_.reserve(numMemObj);
+    writeRanges_.reserve(numMemObj);
     maxMemObjectsInQueue_ = numMemObj;
   }
 
@@ -263,96 +263,113 @@ bool VirtualGPU::MemoryDependency::create(size_t numMemObj) {
 }
 
 // ================================================================================================
-void VirtualGPU::MemoryDependency::validate(VirtualGPU& gpu, const Memory* memory, bool readOnly) {
-  bool flushL1Cache = false;
+bool VirtualGPU::MemoryDependency::overlaps(const RangeList& list, RangeList::const_iterator& pos,
+                                            uint64_t start, uint64_t end) {
+  // Find the first range, which ends after the start address. The ranges are disjoint,
+  // so all previous ranges end before the current one and can't overlap it
+  pos = std::upper_bound(pos, list.end(), start,
+      [](uint64_t address, const Range& range) { return address < range.end_; });
+  return (pos != list.end()) && (pos->start_ < end);
+}
 
-  if (maxMemObjectsInQueue_ == 0) {
-    // Sync AQL packets
-    gpu.setAqlHeader(gpu.dispatchPacketHeader_);
-    return;
+// ================================================================================================
+void VirtualGPU::MemoryDependency::insert(RangeList& list, uint64_t start, uint64_t end) {
+  // Find the first range, which either overlaps or touches the new one
+  auto first = std::lower_bound(list.begin(), list.end(), start,
+      [](const Range& range, uint64_t address) { return range.end_ < address; });
+  auto last = first;
+  while ((last != list.end()) && (last->start_ <= end)) {
+    start = std::min(start, last->start_);
+    end = std::max(end, last->end_);
+    ++last;
   }
 
-  uint64_t curStart = reinterpret_cast<uint64_t>(memory->getDeviceMemory());
-  uint64_t curEnd = curStart + memory->size();
-
-  // Loop through all memory objects in the queue and find dependency
-  // @note don't include objects from the current kernel
-  for (size_t j = 0; j < endMemObjectsInQueue_; ++j) {
-    // Check if the queue already contains this mem object and
-    // GPU operations aren't readonly
-    uint64_t busyStart = memObjectsInQueue_[j].start_;
-    uint64_t busyEnd = memObjectsInQueue_[j].end_;
-
-    // Check if the start inside the busy region
-    if ((((curStart >= busyStart) && (curStart < busyEnd)) ||
-         // Check if the end inside the busy region
-         ((curEnd > busyStart) && (curEnd <= busyEnd)) ||
-         // Check if the start/end cover the busy region
-         ((curStart <= busyStart) && (curEnd >= busyEnd))) &&
-        // If the buys region was written or the current one is for write
-        (!memObjectsInQueue_[j].readOnly_ || !readOnly)) {
-      flushL1Cache = true;
-      break;
+  if (first == last) {
+    list.insert(first, { start, end });
+  } else {
+    // Collapse all merged ranges into the first one
+    first->start_ = start;
+    first->end_ = end;
+    list.erase(first + 1, last);
+  }
+}
+
+// ================================================================================================
+void VirtualGPU::MemoryDependency::newKernel() {
+  // Objects from the previous kernel become busy in the queue
+  for (const auto& state : kernelMemObjects_) {
+    insert(busyRanges_, state.start_, state.end_);
+    if (!state.readOnly_) {
+      insert(writeRanges_, state.start_, state.end_);
     }
   }
+  numBusyMemObjects_ += kernelMemObjects_.size();
+  kernelMemObjects_.clear();
+}
 
-  // Did we reach the limit?
-  if (maxMemObjectsInQueue_ <= numMemObjectsInQueue_) {
-    flushL1Cache = true;
+// ================================================================================================
+void VirtualGPU::MemoryDependency::validate(const Memory* memory, bool readOnly) {
+  uint64_t start = reinterpret_cast<uint64_t>(memory->getDeviceMemory());
+  validate(start, start + memory->size(), readOnly);
+}
+
+// ================================================================================================
+bool VirtualGPU::MemoryDependency::validateKernel() {
+  if (kernelMemObjects_.empty()) {
+    return false;
   }
 
-  if (flushL1Cache) {
-    // Sync AQL packets
-    gpu.setAqlHeader(gpu.dispatchPacketHeader_);
+  // Without tracking every kernel with memory objects has to wait
+  if (maxMemObjectsInQueue_ == 0) {
+    return true;
+  }
 
-    // Clear memory dependency state
+  // Did we reach the limit?
+  bool wait = (maxMemObjectsInQueue_ < (numBusyMemObjects_ + kernelMemObjects_.size()));
+
+  if (!wait && !busyRanges_.empty()) {
+    // Sort the objects of the kernel, so the lookups in both lists only move forward and
+    // all arguments cost a single pass over the lists in the worst case.
+    // A read only access depends on the written ranges only, while a write depends on any access.
+    // @note objects from the current kernel aren't included, since they can alias
+    std::sort(kernelMemObjects_.begin(), kernelMemObjects_.end(),
+        [](const MemoryState& a, const MemoryState& b) { return a.start_ < b.start_; });
+    RangeList::const_iterator busy = busyRanges_.begin();
+    RangeList::const_iterator write = writeRanges_.begin();
+    for (const auto& state : kernelMemObjects_) {
+      if (state.readOnly_ ? overlaps(writeRanges_, write, state.start_, state.end_) :
+                            overlaps(busyRanges_, busy, state.start_, state.end_)) {
+        wait = true;
+        break;
+      }
+    }
+  }
+
+  if (wait) {
+    // Clear memory dependency state, but keep the current kernel in tracking
     const static bool All = true;
     clear(!All);
+
+    // note: The limit growth shouldn't occur under the normal conditions,
+    // but in a case when SVM path sends the amount of SVM ptrs over
+    // the max size of kernel arguments. Otherwise every following kernel will wait
+    while (maxMemObjectsInQueue_ <= kernelMemObjects_.size()) {
+      maxMemObjectsInQueue_ <<= 1;
+    }
   }
 
-  // Insert current memory object into the queue always,
-  // since runtime calls flush before kernel execution and it has to keep
-  // current kernel in tracking
-  memObjectsInQueue_[numMemObjectsInQueue_].start_ = curStart;
-  memObjectsInQueue_[numMemObjectsInQueue_].end_ = curEnd;
-  memObjectsInQueue_[numMemObjectsInQueue_].readOnly_ = readOnly;
-  numMemObjectsInQueue_++;
+  return wait;
 }
 
 // ================================================================================================
 void VirtualGPU::MemoryDependency::clear(bool all) {
-  if (numMemObjectsInQueue_ > 0) {
-    if (all) {
-      endMemObjectsInQueue_ = numMemObjectsInQueue_;
-    }
-
-    // If the current launch didn't start from the beginning, then move the data
-    if (0 != endMemObjectsInQueue_) {
-      // Preserve all objects from the current kernel
-      size_t i, j;
-      for (i = 0, j = endMemObjectsInQueue_; j < numMemObjectsInQueue_; i++, j++) {
-        memObjectsInQueue_[i].start_ = memObjectsInQueue_[j].start_;
-        memObjectsInQueue_[i].end_ = memObjectsInQueue_[j].end_;
-        memObjectsInQueue_[i].readOnly_ = memObjectsInQueue_[j].readOnly_;
-      }
-    } else if (numMemObjectsInQueue_ >= maxMemObjectsInQueue_) {
-      // note: The array growth shouldn't occur under the normal conditions,
-      // but in a case when SVM path sends the amount of SVM ptrs over
-      // the max size of kernel arguments
-      MemoryState* ptr  = new MemoryState[maxMemObjectsInQueue_ << 1];
-      if (nullptr == ptr) {
-        numMemObjectsInQueue_ = 0;
-        return;
-      }
-      maxMemObjectsInQueue_ <<= 1;
-      memcpy(ptr, memObjectsInQueue_, sizeof(MemoryState) * numMemObjectsInQueue_);
-      delete[] memObjectsInQueue_;
-      memObjectsInQueue_= ptr;
-    }
-
-    numMemObjectsInQueue_ -= endMemObjectsInQueue_;
-    endMemObjectsInQueue_ = 0;
+  // Preserve all objects from the current kernel, unless a full clear was requested
+  if (all) {
+    kernelMemObjects_.clear();
   }
+  busyRanges_.clear();
+  writeRanges_.clear();
+  numBusyMemObjects_ = 0;
 }
 
 // ================================================================================================
@@ -676,7 +693,7 @@ bool VirtualGPU::processMemObjects(const amd::Kernel& kernel, const_address para
 
         const static bool IsReadOnly = false;
         // Validate SVM passed in the non argument list
-        memoryDependency().validate(*this, rocMemory, IsReadOnly);
+        memoryDependency().validate(rocMemory, IsReadOnly);
       } else {
         return false;
       }
@@ -736,8 +753,8 @@ bool VirtualGPU::processMemObjects(const amd::Kernel& kernel, const_address para
              desc.name_.c_str(), globalAddress, gpuMem->getDeviceMemory(),
             reinterpret_cast<address>(gpuMem->getDeviceMemory()) + mem->getSize());
 
-          // Validate memory for a dependency in the queue
-          memoryDependency().validate(*this, gpuMem, (desc.info_.readOnly_ == 1));
+          // Track memory for the dependency validation of the kernel
+          memoryDependency().validate(gpuMem, (desc.info_.readOnly_ == 1));
 
           assert((desc.addressQualifier_ == CL_KERNEL_ARG_ADDRESS_GLOBAL ||
                   desc.addressQualifier_ == CL_KERNEL_ARG_ADDRESS_CONSTANT) &&
@@ -824,6 +841,12 @@ bool VirtualGPU::processMemObjects(const amd::Kernel& kernel, const_address para
     }
   }
 
+  // Validate all memory objects of the kernel for a dependency in the queue
+  if (memoryDependency().validateKernel()) {
+    // Sync AQL packets
+    setAqlHeader(dispatchPacketHeader_);
+  }
+
   if (hsaKernel.program()->hasGlobalStores()) {
     // Sync AQL packets
     setAqlHeader(dispatchPacketHeader_);
@@ -889,8 +912,10 @@ bool VirtualGPU::dispatchGenericAqlPacket(
     }
   }
 
-  // Make sure the slot is free for usage
+  // Make sure the slot is free for usage. The GPU can't free the slots of the packets,
+  // which wait for the doorbell
   while ((index - hsa_queue_load_read_index_scacquire(gpu_queue_)) >= sw_queue_size) {
+    flushDoorbell();
     amd::Os::yield();
   }
 
@@ -936,7 +961,15 @@ bool VirtualGPU::dispatchGenericAqlPacket(
           reinterpret_cast<hsa_kernel_dispatch_packet_t*>(packet)->reserved2, read,
           index);
 
-  hsa_signal_store_screlease(gpu_queue_->doorbell_signal, index);
+  if (deferDoorbell_ && !blocking) {
+    // The batch rings the doorbell once for all packets
+    doorbellIndex_ = index;
+    doorbellPending_ = true;
+  } else {
+    // The doorbell with a later index covers the pending packets of the batch
+    hsa_signal_store_screlease(gpu_queue_->doorbell_signal, index);
+    doorbellPending_ = false;
+  }
 
   // Mark the flag indicating if a dispatch is outstanding.
   // We are not waiting after every dispatch.
@@ -1014,7 +1047,9 @@ inline bool VirtualGPU::dispatchAqlPacket(
   // filling the AQL body.
   uint16_t packetHeader = packet->header;
   packet->header = (HSA_PACKET_TYPE_INVALID << HSA_PACKET_HEADER_TYPE);
+  deferDoorbell_ = packetBatch_;
   dispatchGenericAqlPacket(packet, packetHeader, packet->setup, false);
+  deferDoorbell_ = false;
   packet->header = packetHeader;
 
   profilingEnd(*vcmd);
@@ -1084,6 +1119,7 @@ void VirtualGPU::dispatchBarrierPacket(uint16_t packetHeader, bool skipSignal,
     fence_dirty_ = false;
   }
 
+  flushDoorbell();
   while ((index - hsa_queue_load_read_index_scacquire(gpu_queue_)) >= queueMask);
   hsa_barrier_and_packet_t* aql_loc =
     &(reinterpret_cast<hsa_barrier_and_packet_t*>(gpu_queue_->base_address))[index & queueMask];
@@ -1162,6 +1198,7 @@ void VirtualGPU::dispatchBarrierValuePacket(uint16_t packetHeader, bool resolveD
   }
 
   uint64_t index = hsa_queue_add_write_index_screlease(gpu_queue_, 1);
+  flushDoorbell();
   while ((index - hsa_queue_load_read_index_scacquire(gpu_queue_)) >= queueMask);
   hsa_amd_barrier_value_packet_t* aql_loc = &(reinterpret_cast<hsa_amd_barrier_value_packet_t*>(
       gpu_queue_->base_address))[index & queueMask];
@@ -1235,7 +1272,7 @@ VirtualGPU::VirtualGPU(Device& device, bool profiling, bool cooperative,
       schedulerSignal_({0}),
       barriers_(*this),
       kernarg_pool_signal_(KernelArgPoolNumSignal),
-      managed_buffer_(*this, ManagedBuffer::kPoolNumSignals * device.settings().stagedXferSize_),
+      managed_buffer_(*this, device.settings().stagedXferSize_),
       cuMask_(cuMask),
       priority_(priority),
       copy_command_type_(0),
@@ -1298,7 +1335,22 @@ VirtualGPU::~VirtualGPU() {
 
   destroyPool();
 
-  releasePinnedMem();
+  if ((pinnedMems_.Hits() + pinnedMems_.Misses()) != 0) {
+    ClPrint(amd::LOG_INFO, amd::LOG_COPY, "Pinned memory cache: %llu hits, %llu misses",
+            static_cast<unsigned long long>(pinnedMems_.Hits()),
+            static_cast<unsigned long long>(pinnedMems_.Misses()));
+  }
+  // The GPU is idle at this point
+  pinnedMems_.Clear([](amd::Memory* mem) { mem->release(); });
+
+  if (managed_buffer_.Switches() != 0) {
+    ClPrint(amd::LOG_INFO, amd::LOG_COPY,
+            "Staging buffer: %u chunks, %llu switches, %llu grows, %llu stalls",
+            managed_buffer_.NumChunks(),
+            static_cast<unsigned long long>(managed_buffer_.Switches()),
+            static_cast<unsigned long long>(managed_buffer_.Grows()),
+            static_cast<unsigned long long>(managed_buffer_.Stalls()));
+  }
 
   if (timestamp_ != nullptr) {
     timestamp_->release();
@@ -1397,64 +1449,76 @@ bool VirtualGPU::create() {
 
 // ================================================================================================
 VirtualGPU::ManagedBuffer::~ManagedBuffer() {
-  for (auto& it : pool_signal_) {
-    if (it.handle != 0) {
-      hsa_signal_destroy(it);
+  for (const auto& it : ring_.Chunks()) {
+    if (it.signal_.handle != 0) {
+      hsa_signal_destroy(it.signal_);
+    }
+    if (it.base_ != nullptr) {
+      gpu_.dev().hostFree(it.base_, chunk_size_);
     }
-  }
-  if (pool_base_ != nullptr) {
-    gpu_.dev().hostFree(pool_base_, pool_size_);
   }
 }
 
 // ================================================================================================
 bool VirtualGPU::ManagedBuffer::Create() {
-  pool_chunk_end_ = pool_size_ / kPoolNumSignals;
-  active_chunk_ = 0;
+  cur_offset_ = 0;
+  for (uint32_t i = 0; i < kPoolNumSignals; ++i) {
+    Chunk chunk = {};
+    if (!CreateChunk(chunk)) {
+      return false;
+    }
+    ring_.Append(chunk);
+  }
+  return true;
+}
+
+// ================================================================================================
+bool VirtualGPU::ManagedBuffer::CreateChunk(Chunk& chunk) {
   // Allocate memory for managed buffer
-  pool_base_ = reinterpret_cast<address>(
-    gpu_.dev().hostAlloc(pool_size_, 0, Device::MemorySegment::kNoAtomics));
-  if (pool_base_ == nullptr) {
+  chunk.base_ = reinterpret_cast<address>(
+    gpu_.dev().hostAlloc(chunk_size_, 0, Device::MemorySegment::kNoAtomics));
+  if (chunk.base_ == nullptr) {
     return false;
   }
   hsa_agent_t agent = gpu_.dev().getBackendDevice();
-  for (auto& it : pool_signal_) {
-    if (HSA_STATUS_SUCCESS != hsa_signal_create(0, 1, &agent, &it)) {
-      return false;
-    }
+  if (HSA_STATUS_SUCCESS != hsa_signal_create(0, 1, &agent, &chunk.signal_)) {
+    gpu_.dev().hostFree(chunk.base_, chunk_size_);
+    return false;
   }
   return true;
 }
 
 // ================================================================================================
 address VirtualGPU::ManagedBuffer::Acquire(uint32_t size) {
+  assert(size <= chunk_size_ && "Staging request can't exceed the chunk size!");
   auto alignment = amd::alignUp(256u, gpu_.dev().info().globalMemCacheLineSize_);
-  address result = nullptr;
-  result = amd::alignUp(pool_base_ + pool_cur_offset_, alignment);
-  const size_t pool_new_usage = (result + size) - pool_base_;
-  if (pool_new_usage <= pool_chunk_end_) {
-    pool_cur_offset_ = pool_new_usage;
+  address base = ring_.Active().base_;
+  address result = amd::alignUp(base + cur_offset_, alignment);
+  if ((result + size) <= (base + chunk_size_)) {
+    cur_offset_ = (result + size) - base;
     return result;
-  } else {
-    // Reset the signal for the barrier packet
-    hsa_signal_silent_store_relaxed(pool_signal_[active_chunk_], kInitSignalValueOne);
-    // Currently don't skip wait signal check, because SDMA engine cna be used in staging copy
-    constexpr bool kSkipSignal = false;
-    // Dispatch a barrier packet into the queue
-    gpu_.dispatchBarrierPacket(kBarrierPacketHeader, kSkipSignal, pool_signal_[active_chunk_]);
-    // Get the next chunk
-    active_chunk_ = ++active_chunk_ % kPoolNumSignals;
-    // Make sure the new active chunk is free
-    bool test = WaitForSignal(pool_signal_[active_chunk_], gpu_.ActiveWait());
-    assert(test && "Runtime can't fail a wait for chunk!");
-    // Make sure the current offset matches the new chunk to avoid possible overlaps
-    // between chunks and issues during recycle
-    pool_cur_offset_ = (active_chunk_ == 0) ? 0 : pool_chunk_end_;
-    pool_chunk_end_ = pool_cur_offset_ + pool_size_ / kPoolNumSignals;
-    result = amd::alignUp(pool_base_ + pool_cur_offset_, alignment);
-    pool_cur_offset_ = (result + size) - pool_base_;
   }
 
+  // Reset the signal for the barrier packet
+  hsa_signal_silent_store_relaxed(ring_.Active().signal_, kInitSignalValueOne);
+  // Currently don't skip wait signal check, because SDMA engine cna be used in staging copy
+  constexpr bool kSkipSignal = false;
+  // Dispatch a barrier packet into the queue
+  gpu_.dispatchBarrierPacket(kBarrierPacketHeader, kSkipSignal, ring_.Active().signal_);
+
+  // Get the next chunk. If the oldest chunk is still in use, then the ring grows instead of
+  // a submission stall
+  Chunk& next = ring_.Advance(
+      [](const Chunk& chunk) { return hsa_signal_load_relaxed(chunk.signal_) != 0; },
+      [this](Chunk& chunk) { return CreateChunk(chunk); },
+      [this](const Chunk& chunk) {
+        bool test = WaitForSignal(chunk.signal_, gpu_.ActiveWait());
+        assert(test && "Runtime can't fail a wait for chunk!");
+      });
+  base = next.base_;
+  result = amd::alignUp(base, alignment);
+  cur_offset_ = (result + size) - base;
+
   return result;
 }
 
@@ -3138,6 +3202,19 @@ static inline void nontemporalMemcpy(
 
 void VirtualGPU::HiddenHeapInit() { const_cast<Device&>(dev()).HiddenHeapInit(*this); }
 
+// ================================================================================================
+void VirtualGPU::beginPacketBatch() {
+  amd::ScopedLock lock(execution());
+  packetBatch_ = true;
+}
+
+// ================================================================================================
+void VirtualGPU::endPacketBatch() {
+  amd::ScopedLock lock(execution());
+  packetBatch_ = false;
+  flushDoorbell();
+}
+
 // ================================================================================================
 bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
     const amd::Kernel& kernel, const_address parameters, void* event_handle,
@@ -3413,7 +3490,8 @@ bool VirtualGPU::submitKernelInternal(const amd::NDRangeContainer& sizes,
       // Allocate buffer to hold kernel arguments
       if (isGraphCapture) {
         argBuffer = currCmd_->getKernArgOffset(gpuKernel.KernargSegmentByteSize(),
-                                               gpuKernel.KernargSegmentAlignment());
+                                               gpuKernel.KernargSegmentAlignment(),
+                                               parameters, argSize);
         currCmd_->SetKernelName(gpuKernel.name());
       } else {
         ClPrint(amd::LOG_INFO, amd::LOG_KERN, "KernargSegmentByteSize = %lu "
@@ -3704,46 +3782,47 @@ void VirtualGPU::flush(amd::Command* list, bool wait) {
   releaseGpuMemoryFence();
   updateCommandsState(list);
 
-  // Release all pinned memory
-  releasePinnedMem();
+  // The cache is keyed by the host address only. If the application frees host memory and
+  // allocates a new buffer at the same address, a cached pin would be stale, hence drop it
+  if (!ROC_PINNED_MEMORY_CACHE_PERSISTENT) {
+    releasePinnedMem();
+  }
 }
 
 // ================================================================================================
 void VirtualGPU::addPinnedMem(amd::Memory* mem) {
   //! @note: ROCr backend doesn't have per resource busy tracking, hence runtime has to wait
-  //!        unconditionally, before it can release pinned memory
-  releaseGpuMemoryFence();
-  if (!AMD_DIRECT_DISPATCH) {
-    if (nullptr == findPinnedMem(mem->getHostMem(), mem->getSize())) {
-      if (pinnedMems_.size() > 7) {
-        pinnedMems_.front()->release();
-        pinnedMems_.erase(pinnedMems_.begin());
-      }
-
-      // Delay destruction
-      pinnedMems_.push_back(mem);
-    }
-  } else {
+  //!        unconditionally, before it can release pinned memory. The cache waits only once,
+  //!        when it evicts the least recently used ranges
+  if (AMD_DIRECT_DISPATCH && !ROC_PINNED_MEMORY_CACHE_PERSISTENT) {
+    releaseGpuMemoryFence();
     mem->release();
+    return;
   }
+
+  bool fence = false;
+  pinnedMems_.Add(mem, reinterpret_cast<uintptr_t>(mem->getHostMem()), mem->getSize(),
+                  [this, &fence](amd::Memory* evicted) {
+    if (!fence) {
+      releaseGpuMemoryFence();
+      fence = true;
+    }
+    evicted->release();
+  });
 }
 
 // ================================================================================================
 void VirtualGPU::releasePinnedMem() {
-  for (auto& amdMemory : pinnedMems_) {
-    amdMemory->release();
+  if (pinnedMems_.NumRanges() == 0) {
+    return;
   }
-  pinnedMems_.resize(0);
+  releaseGpuMemoryFence();
+  pinnedMems_.Clear([](amd::Memory* mem) { mem->release(); });
 }
 
 // ================================================================================================
 amd::Memory* VirtualGPU::findPinnedMem(void* addr, size_t size) {
-  for (auto& amdMemory : pinnedMems_) {
-    if ((amdMemory->getHostMem() == addr) && (size <= amdMemory->getSize())) {
-      return amdMemory;
-    }
-  }
-  return nullptr;
+  return pinnedMems_.Find(reinterpret_cast<uintptr_t>(addr), size);
 }
 
 // ================================================================================================
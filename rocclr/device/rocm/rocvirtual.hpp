@@ -30,6 +30,8 @@
 #include "rocprintf.hpp"
 #include "hsa/hsa_ven_amd_aqlprofile.h"
 #include "rocsched.hpp"
+#include "rocring.hpp"
+#include "rocpinnedcache.hpp"
 #include "device/device.hpp"
 
 namespace amd::roc {
@@ -188,12 +190,14 @@ class VirtualGPU : public device::VirtualDevice {
  public:
   class ManagedBuffer : public amd::EmbeddedObject {
   public:
-    //! The number of chunks the arg pool will be divided
+    //! The initial number of chunks in the ring
     static constexpr uint32_t kPoolNumSignals = 4;
-    ManagedBuffer(VirtualGPU& gpu, uint32_t pool_size)
+    //! The maximum number of chunks the ring can grow to under pressure
+    static constexpr uint32_t kPoolMaxChunks = 16;
+    ManagedBuffer(VirtualGPU& gpu, uint32_t chunk_size)
       : gpu_(gpu)
-      , pool_size_(pool_size)
-      , pool_signal_(kPoolNumSignals) {}
+      , chunk_size_(chunk_size)
+      , ring_(kPoolMaxChunks) {}
     ~ManagedBuffer();
 
     //! Allocates all necessary resources to manage memory
@@ -202,31 +206,54 @@ class VirtualGPU : public device::VirtualDevice {
     //! Acquires memory for use on the gpu
     address Acquire(uint32_t size);
 
+    //! Returns the number of chunks in the ring
+    uint32_t NumChunks() const { return ring_.NumChunks(); }
+
+    //! Returns the number of chunk switches
+    uint64_t Switches() const { return ring_.Switches(); }
+
+    //! Returns the number of CPU waits for a busy chunk
+    uint64_t Stalls() const { return ring_.Stalls(); }
+
+    //! Returns the number of chunks, added on pressure
+    uint64_t Grows() const { return ring_.Grows(); }
+
   private:
+    struct Chunk {
+      address base_;          //!< Chunk base address
+      hsa_signal_t signal_;   //!< HSA signal, which tracks GPU usage of the chunk
+    };
+
+    //! Allocates the memory and the signal of a new chunk
+    bool CreateChunk(Chunk& chunk);
+
     VirtualGPU& gpu_;                 //!< Queue object for ROCm device
-    address   pool_base_ = nullptr;   //!< Memory pool base address
-    uint32_t  pool_size_;             //!< Memory pool base size
-    uint32_t  pool_chunk_end_ = 0;    //!< The end offset of the current chunk
-    uint32_t  active_chunk_ = 0;      //!< The index of the current active chunk
-    uint32_t  pool_cur_offset_ = 0;   //!< Current active offset for update
-    std::vector<hsa_signal_t> pool_signal_; //!< Pool of HSA signals to manage multiple chunks
+    uint32_t  chunk_size_;            //!< The size of a single chunk
+    uint32_t  cur_offset_ = 0;        //!< Current active offset in the active chunk
+    ChunkRing<Chunk> ring_;           //!< Ring of chunks in the order of reuse
   };
   class MemoryDependency : public amd::EmbeddedObject {
    public:
     //! Default constructor
-    MemoryDependency()
-        : memObjectsInQueue_(nullptr), numMemObjectsInQueue_(0), maxMemObjectsInQueue_(0) {}
-
-    ~MemoryDependency() { delete[] memObjectsInQueue_; }
+    MemoryDependency() : numBusyMemObjects_(0), maxMemObjectsInQueue_(0) {}
 
     //! Creates memory dependecy structure
     bool create(size_t numMemObj);
 
     //! Notify the tracker about new kernel
-    void newKernel() { endMemObjectsInQueue_ = numMemObjectsInQueue_; }
+    void newKernel();
+
+    //! Adds a memory object of the current kernel for the dependency validation
+    void validate(const Memory* memory, bool readOnly);
+
+    //! Adds an address range of the current kernel for the dependency validation
+    void validate(uint64_t start, uint64_t end, bool readOnly) {
+      kernelMemObjects_.push_back({ start, end, readOnly });
+    }
 
-    //! Validates memory object on dependency
-    void validate(VirtualGPU& gpu, const Memory* memory, bool readOnly);
+    //! Validates all memory objects of the current kernel on dependency in one pass.
+    //! Returns true if the kernel has to wait for the previous kernels in the queue
+    bool validateKernel();
 
     //! Clear memory dependency
     void clear(bool all = true);
@@ -241,10 +268,29 @@ class VirtualGPU : public device::VirtualDevice {
       bool readOnly_;   //! Current GPU state in the queue
     };
 
-    MemoryState* memObjectsInQueue_;  //!< Memory object state in the queue
-    size_t endMemObjectsInQueue_;     //!< End of mem objects in the queue
-    size_t numMemObjectsInQueue_;     //!< Number of mem objects in the queue
-    size_t maxMemObjectsInQueue_;     //!< Maximum number of mem objects in the queue
+    //! Busy address range [start_, end_)
+    struct Range {
+      uint64_t start_;  //! Range start address
+      uint64_t end_;    //! Range end address
+    };
+
+    //! Sorted list of disjoint ranges. Both start and end addresses are ascending,
+    //! hence the overlap check is a binary search
+    typedef std::vector<Range> RangeList;
+
+    //! Returns true if [start, end) overlaps any range in the list. The search starts from
+    //! the specified position, which is updated, so ascending lookups never move back
+    static bool overlaps(const RangeList& list, RangeList::const_iterator& pos,
+                         uint64_t start, uint64_t end);
+
+    //! Adds [start, end) to the list, merging all overlapped and adjacent ranges
+    static void insert(RangeList& list, uint64_t start, uint64_t end);
+
+    std::vector<MemoryState> kernelMemObjects_; //!< Mem objects of the current kernel
+    RangeList busyRanges_;        //!< Ranges accessed by the previous kernels in the queue
+    RangeList writeRanges_;       //!< Ranges written by the previous kernels in the queue
+    size_t numBusyMemObjects_;    //!< Number of mem objects from the previous kernels
+    size_t maxMemObjectsInQueue_; //!< Maximum number of mem objects in the queue
   };
 
   class HwQueueTracker : public amd::EmbeddedObject {
@@ -412,10 +458,10 @@ class VirtualGPU : public device::VirtualDevice {
   //! Adds a pinned memory object into a map
   void addPinnedMem(amd::Memory* mem);
 
-  //! Release pinned memory objects
+  //! Waits for the GPU and releases all cached pinned memory objects
   void releasePinnedMem();
 
-  //! Finds if pinned memory is cached
+  //! Finds cached pinned memory, which contains the host range [addr, addr + size)
   amd::Memory* findPinnedMem(void* addr, size_t size);
 
   void enableSyncBlit() const;
@@ -435,6 +481,8 @@ class VirtualGPU : public device::VirtualDevice {
   void* allocKernArg(size_t size, size_t alignment);
   bool isFenceDirty() const { return fence_dirty_; }
   void HiddenHeapInit();
+  void beginPacketBatch();
+  void endPacketBatch();
 
   void setLastUsedSdmaEngine(uint32_t mask) { lastUsedSdmaEngineMask_ = mask; }
   uint32_t getLastUsedSdmaEngine() const { return lastUsedSdmaEngineMask_.load(); }
@@ -445,6 +493,14 @@ class VirtualGPU : public device::VirtualDevice {
   //! Dispatches a barrier with blocking HSA signals
   void dispatchBlockingWait();
 
+  //! Rings the doorbell for the packets of the batch, which wait for it
+  void flushDoorbell() {
+    if (doorbellPending_) {
+      hsa_signal_store_screlease(gpu_queue_->doorbell_signal, doorbellIndex_);
+      doorbellPending_ = false;
+    }
+  }
+
   inline bool dispatchAqlPacket(uint8_t* aqlpacket, const std::string& kernelName,
                                 amd::AccumulateCommand* vcmd = nullptr);
   bool dispatchAqlPacket(hsa_kernel_dispatch_packet_t* packet, uint16_t header, uint16_t rest,
@@ -518,7 +574,9 @@ class VirtualGPU : public device::VirtualDevice {
   //! Resets the current queue state. Note: should be called after AQL queue becomes idle
   void ResetQueueStates();
 
-  std::vector<amd::Memory*> pinnedMems_;   //!< Pinned memory list
+  //! Pinned host memory, cached for the later transfers until the next flush or
+  //! across the flushes with ROC_PINNED_MEMORY_CACHE_PERSISTENT
+  PinnedCache<amd::Memory> pinnedMems_{ROC_PINNED_MEMORY_CACHE_SIZE * Mi};
 
   //! Queue state flags
   union {
@@ -591,6 +649,11 @@ class VirtualGPU : public device::VirtualDevice {
                                         //!< kUnknown/kFlushedToDevice/kFlushedToSystem
   bool fence_dirty_;                    //!< Fence modified flag
 
+  bool packetBatch_ = false;            //!< Captured packets ring the doorbell at the batch end
+  bool deferDoorbell_ = false;          //!< The current packet doesn't ring the doorbell
+  bool doorbellPending_ = false;        //!< Packets of the batch wait for the doorbell
+  uint64_t doorbellIndex_ = 0;          //!< The last packet index of the batch
+
   std::atomic<uint> lastUsedSdmaEngineMask_;     //!< Last Used SDMA Engine mask
 
   using KernelArgImpl = device::Settings::KernelArgImpl;
@@ -24,6 +24,7 @@
 #include "top.hpp"
 #include "utils/util.hpp"
 
+#include <atomic>
 #include <vector>
 #include <string>
 
@@ -131,6 +132,9 @@ class Os : AllStatic {
   // Given a valid mmaped ptr with correct size, unmaps the ptr from memory
   static bool MemoryUnmapFile(const void* mmap_ptr, size_t mmap_size);
 
+  // Hints the OS to read ahead the pages of the mapped range, which will be accessed soon
+  static bool MemoryPrefetchFile(const void* ptr, size_t size);
+
   // Given a valid filename create system memory that can be shared between processes
   static void* CreateIpcMemory(const char* fname, size_t size, FileDesc* desc);
 
@@ -206,6 +210,11 @@ class Os : AllStatic {
   static void yield();
   //! Execute a pause instruction (for spin loops).
   static void spinPause();
+  //! Block the calling thread while the value at the address is equal to \a expected.
+  //! The wait can end spuriously, so the caller must recheck its condition
+  static void waitOnAddress(std::atomic<uint32_t>* address, uint32_t expected);
+  //! Wake one or all threads, blocked in waitOnAddress() on the address
+  static void wakeOnAddress(std::atomic<uint32_t>* address, bool all);
 
   // Memory routines:
   //
@@ -41,6 +41,8 @@
 #include <signal.h>
 
 #include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 #include <link.h>
 #include <time.h>
@@ -428,6 +430,16 @@ bool Os::setThreadAffinityToMainThread() {
 
 void Os::yield() { ::sched_yield(); }
 
+void Os::waitOnAddress(std::atomic<uint32_t>* address, uint32_t expected) {
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), FUTEX_WAIT_PRIVATE, expected,
+            nullptr, nullptr, 0);
+}
+
+void Os::wakeOnAddress(std::atomic<uint32_t>* address, bool all) {
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), FUTEX_WAKE_PRIVATE,
+            all ? INT_MAX : 1, nullptr, nullptr, 0);
+}
+
 uint64_t Os::timeNanos() {
   struct timespec tp;
   ::clock_gettime(CLOCK_MONOTONIC, &tp);
@@ -862,6 +874,17 @@ bool Os::MemoryUnmapFile(const void* mmap_ptr, size_t mmap_size) {
   return true;
 }
 
+bool Os::MemoryPrefetchFile(const void* ptr, size_t size) {
+  // madvise() requires a page aligned start address
+  const uintptr_t start = alignDown(reinterpret_cast<uintptr_t>(ptr), pageSize());
+  const size_t length = size + (reinterpret_cast<uintptr_t>(ptr) - start);
+  if (madvise(reinterpret_cast<void*>(start), length, MADV_WILLNEED) != 0) {
+    return false;
+  }
+
+  return true;
+}
+
 bool Os::MemoryMapFile(const char* fname, const void** mmap_ptr, size_t* mmap_size) {
   if ((mmap_ptr == nullptr) || (mmap_size == nullptr)) {
     return false;
@@ -28,6 +28,9 @@
 #include <tchar.h>
 #include <time.h>
 #include <intrin.h>
+#include <synchapi.h>
+
+#pragma comment(lib, "Synchronization.lib")
 
 #include <atomic>
 #include <vector>
@@ -348,6 +351,19 @@ bool Os::setThreadAffinityToMainThread() {
 }
 void Os::yield() { ::SwitchToThread(); }
 
+void Os::waitOnAddress(std::atomic<uint32_t>* address, uint32_t expected) {
+  ::WaitOnAddress(reinterpret_cast<volatile VOID*>(address), &expected, sizeof(expected),
+                  INFINITE);
+}
+
+void Os::wakeOnAddress(std::atomic<uint32_t>* address, bool all) {
+  if (all) {
+    ::WakeByAddressAll(reinterpret_cast<PVOID>(address));
+  } else {
+    ::WakeByAddressSingle(reinterpret_cast<PVOID>(address));
+  }
+}
+
 uint64_t Os::timeNanos() {
   LARGE_INTEGER current;
   QueryPerformanceCounter(&current);
@@ -632,6 +648,11 @@ bool Os::MemoryUnmapFile(const void* mmap_ptr, size_t mmap_size) {
   return true;
 }
 
+bool Os::MemoryPrefetchFile(const void* ptr, size_t size) {
+  // The read ahead is only a hint, the pages are faulted in on the first access
+  return true;
+}
+
 bool Os::MemoryMapFile(const char* fname, const void** mmap_ptr, size_t* mmap_size) {
   if ((mmap_ptr == nullptr) || (mmap_size == nullptr)) {
     return false;
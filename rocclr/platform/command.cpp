@@ -318,23 +318,17 @@ Command::Command(HostQueue& queue, cl_command_type type, const EventWaitList& ev
   }
 }
 
-SysmemPool<ComputeCommand>* Command::command_pool_ = new SysmemPool<ComputeCommand>;
+std::atomic<SysmemPool*> SysmemPool::active_ = new SysmemPool;
+std::atomic<SysmemPool::Hazard*> SysmemPool::hazards_{nullptr};
+thread_local SysmemPool::ThreadCache SysmemPool::cache_;
 // ================================================================================================
 void Command::operator delete(void* ptr) {
-  if (DEBUG_CLR_SYSMEM_POOL) {
-    command_pool_->Free(ptr);
-  } else {
-    ::operator delete (ptr);
-  }
+  SysmemPool::Release(ptr);
 }
 
 // ================================================================================================
 void* Command::operator new(size_t size) {
-  if (DEBUG_CLR_SYSMEM_POOL) {
-    return command_pool_->Alloc(size);
-  } else {
-    return ::operator new (size);
-  }
+  return SysmemPool::Allocate(size);
 }
 
 // ================================================================================================
@@ -250,6 +250,12 @@ union CopyMetadata {
 class GraphKernelArgManager {
  public:
   virtual address AllocKernArg(size_t size, size_t alignment) = 0;
+  //! Allocates kernel args for the given contents. The manager can return the args of
+  //! an earlier allocation with the same contents
+  virtual address AllocKernArg(size_t size, size_t alignment, const void* args,
+                               size_t args_size) {
+    return AllocKernArg(size, alignment);
+  }
 };
 
 /*! \brief An operation that is submitted to a command queue.
@@ -261,7 +267,6 @@ class GraphKernelArgManager {
  */
 class Command : public Event {
  private:
-  static SysmemPool<ComputeCommand> *command_pool_;  //!< Pool of active commands
   HostQueue* queue_;               //!< The command queue this command is enqueue into
   Command* next_;                  //!< Next GPU command in the queue list
   Command* batch_head_ = nullptr;  //!< The head of the batch commands
@@ -310,13 +315,8 @@ class Command : public Event {
   }
 
  public:
-  //! Returns AQL buffer state
-  static void ReleaseSysmemPool() {
-    if (command_pool_ != nullptr) {
-      delete command_pool_;
-      command_pool_ = nullptr;
-    }
-  }
+  //! Releases the memory pool of commands and events
+  static void ReleaseSysmemPool() { SysmemPool::Destroy(); }
   bool getPktCapturingState() const { return packetCapturing_; }
 
   //! Sets AQL capture state, aql packet to capture and where to copy kernArgs
@@ -343,8 +343,11 @@ class Command : public Event {
     return packet;
   }
 
-  address getKernArgOffset(int size, int alignment) {
-    return graphKernArgMgr_->AllocKernArg(size, alignment);
+  address getKernArgOffset(int size, int alignment, const void* args = nullptr,
+                           size_t args_size = 0) {
+    return (args != nullptr) ?
+        graphKernArgMgr_->AllocKernArg(size, alignment, args, args_size) :
+        graphKernArgMgr_->AllocKernArg(size, alignment);
   }
 
   //! Overload new/delete for fast commands allocation/destruction
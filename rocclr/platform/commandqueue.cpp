@@ -34,9 +34,15 @@
 namespace amd {
 
 HostQueue::HostQueue(Context& context, Device& device, cl_command_queue_properties props,
-                     uint queueRTCUs, Priority priority, const std::vector<uint32_t>& cuMask)
+                     uint queueRTCUs, Priority priority, const std::vector<uint32_t>& cuMask,
+                     size_t ringSize)
     : CommandQueue(context, device, props, device.info().queueProperties_, queueRTCUs,
                    priority, cuMask),
+      ringQueue_(nullptr),
+      parked_(false),
+      wakeSequence_(0),
+      waitingProducers_(0),
+      spaceSequence_(0),
       lastEnqueueCommand_(nullptr),
       head_(nullptr),
       tail_(nullptr),
@@ -44,6 +50,10 @@ HostQueue::HostQueue(Context& context, Device& device, cl_command_queue_properti
   if (GPU_FORCE_QUEUE_PROFILING) {
     properties().set(CL_QUEUE_PROFILING_ENABLE);
   }
+  if (!AMD_DIRECT_DISPATCH && (ringSize != 0)) {
+    // The bounded queue is used by the worker thread only
+    ringQueue_ = new ConcurrentRingQueue<Command*>(ringSize);
+  }
   if (AMD_DIRECT_DISPATCH) {
     // Initialize the queue
     thread_.Init(this);
@@ -90,14 +100,14 @@ bool HostQueue::terminate() {
     if (Os::isThreadAlive(thread_)) {
       Command* marker = nullptr;
       // Send a finish if the queue is still accepting commands.
-      if (lastEnqueueCommand_ != nullptr || !amd::IS_HIP) {
-        ScopedLock sl(queueLock_);
-        if (thread_.acceptingCommands_) {
-          marker = new Marker(*this, false);
-          if (marker != nullptr) {
-            append(*marker);
-            queueLock_.notify();
-          }
+      // @note append() may wait for space in the bounded queue, so it can't be called
+      // under queueLock_. If the worker exits before it takes the marker, then the wait
+      // below stops on the thread termination
+      if ((lastEnqueueCommand_ != nullptr || !amd::IS_HIP) && thread_.acceptingCommands_) {
+        marker = new Marker(*this, false);
+        if (marker != nullptr) {
+          append(*marker);
+          flush();
         }
       }
       if (marker != nullptr) {
@@ -110,11 +120,9 @@ bool HostQueue::terminate() {
       }
 
       // Wake-up the command loop, so it can exit
-      {
-        ScopedLock sl(queueLock_);
-        thread_.acceptingCommands_ = false;
-        queueLock_.notify();
-      }
+      thread_.acceptingCommands_ = false;
+      wakeSequence_.fetch_add(1, std::memory_order_release);
+      Os::wakeOnAddress(&wakeSequence_, false);
 
       // FIXME_lmoriche: fix termination handshake
       while (thread_.state() < Thread::FINISHED && Os::isThreadAlive(thread_)) {
@@ -193,71 +201,128 @@ void HostQueue::loop(device::VirtualDevice* virtualDevice) {
   // Create a command batch with all the commands present in the queue.
   Command* head = NULL;
   Command* tail = NULL;
+  Command* commands[kMaxDequeueBatch];
   while (true) {
-    // Get one command from the queue
-    Command* command = queue_.dequeue();
-    if (command == NULL) {
-      ScopedLock sl(queueLock_);
-      while ((command = queue_.dequeue()) == NULL) {
+    // Get the available commands from the queue
+    size_t count = dequeue(commands, kMaxDequeueBatch);
+    if (count == 0) {
+      // Let producers know the worker needs a notification
+      parked_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (true) {
+        // Read the wake sequence before the last check of the queue. If a producer adds
+        // a command after the check, then it changes the sequence and the wait returns
+        uint32_t sequence = wakeSequence_.load(std::memory_order_acquire);
+        if ((count = dequeue(commands, kMaxDequeueBatch)) != 0) {
+          break;
+        }
         if (!thread_.acceptingCommands_) {
+          parked_.store(false, std::memory_order_relaxed);
           return;
         }
-        queueLock_.wait();
+        Os::waitOnAddress(&wakeSequence_, sequence);
+      }
+      parked_.store(false, std::memory_order_relaxed);
+    }
+    // Wake up the producers, which wait for the free cells in the bounded queue.
+    // @note The fence pairs with the one in enqueueRing()
+    if (ringQueue_ != nullptr) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (waitingProducers_.load(std::memory_order_relaxed) != 0) {
+        spaceSequence_.fetch_add(1, std::memory_order_release);
+        Os::wakeOnAddress(&spaceSequence_, true);
       }
     }
 
-    command->retain();
-
-    // Process the command's event wait list.
-    const Command::EventWaitList& events = command->eventWaitList();
-    bool dependencyFailed = false;
-    ClPrint(LOG_DEBUG, LOG_CMD, "Command (%s) processing: %p ,events.size(): %d",
-            amd::activity_prof::getOclCommandKindString(command->type()), command, events.size());
-    for (const auto& it : events) {
-      // Only wait if the command is enqueued into another queue.
-      if (it->command().queue() != this) {
-        // Runtime has to flush the current batch only if the dependent wait is blocking
-        if (it->command().status() != CL_COMPLETE) {
-          ClPrint(LOG_DEBUG, LOG_CMD, "Command (%s) %p awaiting event: %p",
-                  amd::activity_prof::getOclCommandKindString(command->type()),
-                  command, it);
-          virtualDevice->flush(head, true);
-          tail = head = NULL;
-          dependencyFailed |= !it->awaitCompletion();
+    for (size_t i = 0; i < count; ++i) {
+      Command* command = commands[i];
+      command->retain();
+
+      // Process the command's event wait list.
+      const Command::EventWaitList& events = command->eventWaitList();
+      bool dependencyFailed = false;
+      ClPrint(LOG_DEBUG, LOG_CMD, "Command (%s) processing: %p ,events.size(): %d",
+              amd::activity_prof::getOclCommandKindString(command->type()), command, events.size());
+      for (const auto& it : events) {
+        // Only wait if the command is enqueued into another queue.
+        if (it->command().queue() != this) {
+          // Runtime has to flush the current batch only if the dependent wait is blocking
+          if (it->command().status() != CL_COMPLETE) {
+            ClPrint(LOG_DEBUG, LOG_CMD, "Command (%s) %p awaiting event: %p",
+                    amd::activity_prof::getOclCommandKindString(command->type()),
+                    command, it);
+            virtualDevice->flush(head, true);
+            tail = head = NULL;
+            dependencyFailed |= !it->awaitCompletion();
+          }
         }
       }
-    }
 
-    // Insert the command to the linked list.
-    if (NULL == head) {  // if the list is empty
-      head = tail = command;
-    } else {
-      tail->setNext(command);
-      tail = command;
-    }
+      // Insert the command to the linked list.
+      if (NULL == head) {  // if the list is empty
+        head = tail = command;
+      } else {
+        tail->setNext(command);
+        tail = command;
+      }
 
-    if (dependencyFailed) {
-      command->setStatus(CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST);
-      continue;
-    }
+      if (dependencyFailed) {
+        command->setStatus(CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST);
+        continue;
+      }
 
-    ClPrint(LOG_DEBUG, LOG_CMD, "Command (%s) submitted: %p",
-            amd::activity_prof::getOclCommandKindString(command->type()),
-            command);
+      ClPrint(LOG_DEBUG, LOG_CMD, "Command (%s) submitted: %p",
+              amd::activity_prof::getOclCommandKindString(command->type()),
+              command);
 
-    command->setStatus(CL_SUBMITTED);
+      command->setStatus(CL_SUBMITTED);
 
-    // Submit to the device queue.
-    command->submit(*virtualDevice);
+      // Submit to the device queue.
+      command->submit(*virtualDevice);
 
-    // if this is a user invisible marker command, then flush
-    if (0 == command->type()) {
-      virtualDevice->flush(head);
-      tail = head = NULL;
-    }
+      // if this is a user invisible marker command, then flush
+      if (0 == command->type()) {
+        virtualDevice->flush(head);
+        tail = head = NULL;
+      }
+    }  // for (size_t i = 0; i < count; ++i) {
   }  // while (true) {
 }
 
+size_t HostQueue::dequeue(Command** commands, size_t count) {
+  if (ringQueue_ != nullptr) {
+    return ringQueue_->dequeue(commands, count);
+  }
+  size_t i = 0;
+  for (; i < count; ++i) {
+    commands[i] = queue_.dequeue();
+    if (commands[i] == NULL) {
+      break;
+    }
+  }
+  return i;
+}
+
+void HostQueue::enqueueRing(Command* command) {
+  if (ringQueue_->enqueue(command)) {
+    return;
+  }
+  // Park until the worker thread takes commands from the full queue. Either the worker
+  // observes the waiting producer after the dequeue, or the producer observes the free cell
+  waitingProducers_.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  while (true) {
+    uint32_t sequence = spaceSequence_.load(std::memory_order_acquire);
+    if (ringQueue_->enqueue(command)) {
+      break;
+    }
+    // The commands in the queue may be not flushed yet
+    flush();
+    Os::waitOnAddress(&spaceSequence_, sequence);
+  }
+  waitingProducers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
 void HostQueue::append(Command& command) {
   // We retain the command here. It will be released when its status
   // changes to CL_COMPLETE
@@ -266,7 +331,11 @@ void HostQueue::append(Command& command) {
   }
   command.retain();
   command.setStatus(CL_QUEUED);
-  queue_.enqueue(&command);
+  if (ringQueue_ != nullptr) {
+    enqueueRing(&command);
+  } else {
+    queue_.enqueue(&command);
+  }
   if (!IS_HIP) {
     return;
   }
@@ -297,7 +366,7 @@ void HostQueue::append(Command& command) {
 
 bool HostQueue::isEmpty() {
   // Get a snapshot of queue size
-  return queue_.empty();
+  return (ringQueue_ != nullptr) ? ringQueue_->empty() : queue_.empty();
 }
 
 Command* HostQueue::getLastQueuedCommand(bool retain) {
@@ -128,8 +128,8 @@ class CommandQueue : public RuntimeObject {
       : properties_(propMask, properties),
         rtCUs_(rtCUs),
         priority_(priority),
-        queueLock_("CommandQueue::queueLock"),
-        lastCmdLock_("LastQueuedCommand"),
+        queueLock_("CommandQueue::queueLock", true),
+        lastCmdLock_("LastQueuedCommand", true),
         device_(device),
         context_(context),
         cuMask_(cuMask) {}
@@ -173,7 +173,9 @@ class HostQueue : public CommandQueue {
         Release();
       } else {
         acceptingCommands_ = false;
-        queue->flush();
+        // Wake up the queue constructor, which waits for the thread start
+        ScopedLock sl(queue->lock());
+        queue->lock().notify();
       }
     }
 
@@ -195,13 +197,27 @@ class HostQueue : public CommandQueue {
   } thread_;  //!< The command queue thread instance.
 
  private:
+  //! The max number of commands the worker thread takes from the queue at once
+  static constexpr size_t kMaxDequeueBatch = 32;
+
   ConcurrentLinkedQueue<Command*> queue_;  //!< The queue.
+  ConcurrentRingQueue<Command*>* ringQueue_;  //!< Bounded queue, replaces queue_ if valid
+  std::atomic<bool> parked_;     //!< True if the worker thread waits for new commands
+  std::atomic<uint32_t> wakeSequence_;  //!< Changes on every wake up of the parked worker
+  std::atomic<uint32_t> waitingProducers_;  //!< The number of producers, parked on a full ring
+  std::atomic<uint32_t> spaceSequence_;     //!< Changes, when the worker frees the ring cells
 
   Command* lastEnqueueCommand_;  //!< The last submitted command
 
   //! Await commands and execute them as they become ready.
   void loop(device::VirtualDevice* virtualDevice);
 
+  //! Takes up to \a count commands from the queue. Returns the number of commands
+  size_t dequeue(Command** commands, size_t count);
+
+  //! Adds the command to the bounded queue, parks the caller while the queue is full
+  void enqueueRing(Command* command);
+
  protected:
   virtual bool terminate();
 
@@ -209,11 +225,16 @@ class HostQueue : public CommandQueue {
   /*! \brief Construct a new host queue.
    *
    * \note A new virtual device instance will be created from the
-   * given device.
+   * given device. \a ringSize selects the bounded command ring of the worker thread,
+   * 0 - the unbounded linked queue.
    */
   HostQueue(Context& context, Device& device, cl_command_queue_properties properties,
             uint queueRTCUs = 0, Priority priority = Priority::Normal,
-            const std::vector<uint32_t>& cuMask = {});
+            const std::vector<uint32_t>& cuMask = {},
+            size_t ringSize = DEBUG_CLR_HOST_QUEUE_RING_SIZE);
+
+  //! Destroy the host queue
+  virtual ~HostQueue() { delete ringQueue_; }
 
   //! Returns TRUE if this command queue can accept commands.
   virtual bool create() { return thread_.acceptingCommands_; }
@@ -226,8 +247,15 @@ class HostQueue : public CommandQueue {
 
   //! Signal to start processing the commands in the queue.
   void flush() {
-    ScopedLock sl(queueLock_);
-    queueLock_.notify();
+    // The worker thread parks on the wake sequence only when the queue is empty, hence
+    // producers skip the notification while the worker is busy with the queued commands.
+    // @note The fence pairs with the one in loop(): either the producer observes
+    // the parked worker, or the worker observes the new command before it waits.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked_.load(std::memory_order_relaxed)) {
+      wakeSequence_.fetch_add(1, std::memory_order_release);
+      Os::wakeOnAddress(&wakeSequence_, false);
+    }
   }
 
   //! Finish all queued commands
@@ -25,6 +25,8 @@
 #include "platform/commandqueue.hpp"
 #include "platform/sampler.hpp"
 
+#include <algorithm>
+
 namespace amd {
 
 Kernel::Kernel(Program& program, const Symbol& symbol, const std::string& name)
@@ -105,65 +107,66 @@ address KernelParameters::alloc(device::VirtualDevice& vDev) {
 
 // =================================================================================================
 bool KernelParameters::captureAndSet(void** kernelParams, address kernArgs, address mem) {
+  if (signature_.numSamplers() != 0) {
+    LogError("Cannot handle Sampler now");
+    return false;
+  }
+  if (signature_.numQueues() != 0) {
+    LogError("Cannot handle Queue now");
+    return false;
+  }
 
-  for (size_t idx = 0; idx < signature_.numParameters(); ++idx) {
-    KernelParameterDescriptor& desc = signature_.params()[idx];
-    void* value = nullptr;
-    if (kernelParams != nullptr) {
-      value = kernelParams[idx];
+  const KernelArgPackPlan& plan = signature_.packPlan();
+  if (kernelParams != nullptr) {
+    for (const auto& copy : plan.copies_) {
+      const void* value = kernelParams[copy.index_];
+      void* param = mem + copy.offset_;
+      switch (copy.size_) {
+        case sizeof(uint32_t):
+          *static_cast<uint32_t*>(param) = *static_cast<const uint32_t*>(value);
+          break;
+        case sizeof(uint64_t):
+          *static_cast<uint64_t*>(param) = *static_cast<const uint64_t*>(value);
+          break;
+        default:
+          ::memcpy(param, value, copy.size_);
+          break;
+      }
+    }
+  } else {
+    for (const auto& run : plan.runs_) {
+      ::memcpy(mem + run.offset_, kernArgs + run.offset_, run.size_);
+    }
+  }
+
+  for (const auto& local : plan.locals_) {
+    if (local.size_ == sizeof(uint32_t)) {
+      *reinterpret_cast<uint32_t*>(mem + local.offset_) = local.size_;
     } else {
-      value = kernArgs + desc.offset_;
+      *reinterpret_cast<uint64_t*>(mem + local.offset_) = local.size_;
     }
-    void* param = mem + desc.offset_;
-    uint32_t uint32_value = 0;
-    uint64_t uint64_value = 0;
+  }
+
+  // Without the memory dependency tracking the memory objects of the raw pointers are only
+  // used for the image SRDs, hence the lookup in the global map can be skipped
+  const bool lookupMemObjs = !(IS_HIP && DEBUG_CLR_KERNARG_SKIP_MEMOBJ_LOOKUP &&
+                               (GPU_NUM_MEM_DEPENDENCY == 0));
+  amd::Memory** memories = reinterpret_cast<amd::Memory**>(mem + memoryObjOffset());
+  for (const auto& pointer : plan.pointers_) {
     Memory* memArg = nullptr;
-    amd::Memory** memories = reinterpret_cast<amd::Memory**>(mem + memoryObjOffset());
-    if (desc.type_ == T_POINTER && (desc.addressQualifier_ != CL_KERNEL_ARG_ADDRESS_LOCAL)) {
-      LP64_SWITCH(uint32_value, uint64_value) = *(LP64_SWITCH(uint32_t*, uint64_t*))value;
-      memArg = amd::MemObjMap::FindMemObj(*reinterpret_cast<const void* const*>(value));
-      memories[desc.info_.arrayIndex_] = memArg;
+    if (lookupMemObjs || pointer.image_) {
+      memArg = amd::MemObjMap::FindMemObj(*reinterpret_cast<const void* const*>(
+          mem + pointer.offset_));
       if (memArg != nullptr) {
         memArg->retain();
       }
-      desc.info_.rawPointer_ = true;
-    } else if (desc.type_ == T_SAMPLER) {
-      LogError("Cannot handle Sampler now");
-      return false;
-    } else if (desc.type_ == T_QUEUE) {
-      LogError("Cannot handle Queue now");
-      return false;
-    } else {
-      switch (desc.size_) {
-        case 4:
-          if (desc.addressQualifier_ == CL_KERNEL_ARG_ADDRESS_LOCAL) {
-            uint32_value = desc.size_;
-          } else {
-            uint32_value = *(static_cast<const uint32_t*>(value));
-          }
-          break;
-        case 8:
-          if (desc.addressQualifier_ == CL_KERNEL_ARG_ADDRESS_LOCAL) {
-            uint64_value = desc.size_;
-          } else {
-            uint64_value = *(static_cast<const uint64_t*>(value));
-          }
-          break;
-      }
     }
+    memories[pointer.memIndex_] = memArg;
+    signature_.params()[pointer.index_].info_.rawPointer_ = true;
+  }
 
-    switch (desc.size_) {
-      case sizeof(uint32_t):
-        *static_cast<uint32_t*>(param) = uint32_value;
-        break;
-      case sizeof(uint64_t):
-        *static_cast<uint64_t*>(param) = uint64_value;
-        break;
-      default:
-        ::memcpy(param, value, desc.size_);
-        break;
-    }
-    desc.info_.defined_ = true;
+  for (size_t idx = 0; idx < signature_.numParameters(); ++idx) {
+    signature_.params()[idx].info_.defined_ = true;
   }
 
   execInfoOffset_ = totalSize_;
@@ -431,5 +434,65 @@ KernelSignature::KernelSignature(const std::vector<KernelParameterDescriptor>& p
     // 16 bytes is the current HW alignment for the arguments
     paramsSize_ = alignUp(paramsSize_, 16);
   }
+
+  buildPackPlan();
+}
+
+// =================================================================================================
+void KernelSignature::buildPackPlan() {
+  struct Entry {
+    uint32_t offset_;
+    uint32_t size_;
+    bool local_;
+  };
+  std::vector<Entry> entries;
+  entries.reserve(numParameters_);
+
+  for (uint32_t i = 0; i < numParameters_; ++i) {
+    const KernelParameterDescriptor& desc = params_[i];
+    const uint32_t offset = static_cast<uint32_t>(desc.offset_);
+    const uint32_t size = static_cast<uint32_t>(desc.size_);
+    const bool local = (desc.addressQualifier_ == CL_KERNEL_ARG_ADDRESS_LOCAL);
+    // Samplers and queues are rejected at capture time
+    if (desc.type_ == T_SAMPLER || desc.type_ == T_QUEUE) {
+      continue;
+    }
+    if (local && (size == sizeof(uint32_t) || size == sizeof(uint64_t))) {
+      packPlan_.locals_.push_back({offset, size});
+      entries.push_back({offset, size, true});
+      continue;
+    }
+    if (desc.type_ == T_POINTER && !local) {
+      packPlan_.pointers_.push_back({i, offset, desc.info_.arrayIndex_,
+          desc.info_.oclObject_ == KernelParameterDescriptor::ImageObject});
+    }
+    if (size != 0) {
+      packPlan_.copies_.push_back({i, offset, size});
+      entries.push_back({offset, size, false});
+    }
+  }
+
+  // Merge the copies into contiguous runs. The padding between the arguments is copied as well,
+  // but the local memory arguments break the runs, since their values are generated
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.offset_ < b.offset_; });
+  KernelArgPackPlan::Run run = {0, 0};
+  for (const auto& entry : entries) {
+    if (entry.local_) {
+      if (run.size_ != 0) {
+        packPlan_.runs_.push_back(run);
+        run = {0, 0};
+      }
+      continue;
+    }
+    if (run.size_ == 0) {
+      run = {entry.offset_, entry.size_};
+    } else {
+      run.size_ = std::max(run.size_, entry.offset_ + entry.size_ - run.offset_);
+    }
+  }
+  if (run.size_ != 0) {
+    packPlan_.runs_.push_back(run);
+  }
 }
 }  // namespace amd
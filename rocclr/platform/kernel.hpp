@@ -49,10 +49,43 @@ class Program;
  *  @{
  */
 
+//! Packing plan of the explicit kernel arguments, computed once per signature
+struct KernelArgPackPlan {
+  //! Copy of a single by-value or pointer argument
+  struct Copy {
+    uint32_t index_;    //!< Index of the argument in the signature
+    uint32_t offset_;   //!< Offset of the argument in the kernel arguments
+    uint32_t size_;     //!< Size of the argument in bytes
+  };
+  //! Contiguous byte range of the arguments, which can be copied with a single memcpy
+  struct Run {
+    uint32_t offset_;   //!< Offset of the first byte in the kernel arguments
+    uint32_t size_;     //!< Size of the range in bytes, including the padding between args
+  };
+  //! Global or constant pointer argument, which may reference a memory object
+  struct Pointer {
+    uint32_t index_;    //!< Index of the argument in the signature
+    uint32_t offset_;   //!< Offset of the pointer in the kernel arguments
+    uint32_t memIndex_; //!< Slot in the captured memory objects array
+    bool image_;        //!< The argument is an image object and requires the lookup
+  };
+  //! Local memory argument, which is written with its size
+  struct Local {
+    uint32_t offset_;   //!< Offset of the argument in the kernel arguments
+    uint32_t size_;     //!< Size of the argument, 4 or 8 bytes
+  };
+
+  std::vector<Copy> copies_;        //!< Per argument copies for the array of pointers
+  std::vector<Run> runs_;           //!< Merged copies for the contiguous arguments buffer
+  std::vector<Pointer> pointers_;   //!< Pointer arguments
+  std::vector<Local> locals_;       //!< Local memory arguments
+};
+
 class KernelSignature : public HeapObject {
  private:
   std::vector<KernelParameterDescriptor> params_;
   std::string attributes_;  //!< The kernel attributes
+  KernelArgPackPlan packPlan_;  //!< The packing plan of the explicit arguments
 
   uint32_t  numParameters_; //!< Number of OCL arguments in the kernel
   uint32_t  paramsSize_;    //!< The size of all arguments
@@ -113,6 +146,13 @@ class KernelSignature : public HeapObject {
 
   const std::vector<KernelParameterDescriptor>& parameters() const
     { return params_; }
+
+  //! Return the packing plan of the explicit arguments
+  const KernelArgPackPlan& packPlan() const { return packPlan_; }
+
+ private:
+  //! Build the packing plan of the explicit arguments
+  void buildPackPlan();
 };
 
 // @todo: look into a copy-on-write model instead of copy-on-read.
@@ -22,6 +22,7 @@
 #define OBJECT_HPP_
 
 #include <set>
+#include <vector>
 
 #include "top.hpp"
 #include "os/alloc.hpp"
@@ -192,122 +193,299 @@ struct Coord3D {
   }
 };
 
-template <class T>
+/*! \brief Thread caching allocator for the runtime objects with a high allocation rate.
+ *
+ *  Allocations are grouped in size classes. Every thread keeps a magazine of free slots
+ *  per size class, so allocation and release don't touch any shared state in the common case.
+ *  Magazines exchange slots with the shared depot in batches, which also collects slots
+ *  released by other threads. Allocations bigger than the largest class go to the system heap.
+ */
 class SysmemPool {
-public:
-  SysmemPool(): chunk_access_(true) /* Sysmem Pool Lock */ {}
+ public:
+  SysmemPool() : depot_access_(true) /* Sysmem Pool Lock */ {}
+
+  //! Releases all chunks. Slots, which are still in use, become invalid
   ~SysmemPool() {
-    if (free_chunk_num_ != max_chunk_idx_) {
-      for (int i = 0; i < kActiveAllocSize; ++i) {
-        // Free any active chunks
-        if (active_allocs_[i] != nullptr) {
-          auto chunk = active_allocs_[i]->base_;
-          // Check if this chunk contains unreleased memory objects
-          if ((chunk->busy_ + chunk->free_) != kAllocChunkSize) {
-            LogPrintfError("Unreleased slots in sysmem pool %ld",
-              kAllocChunkSize - (chunk->busy_ + chunk->free_));
-          }
-          delete chunk;
-          free_chunk_num_++;
-        }
+    for (auto chunk : chunks_) {
+      AlignedMemory::deallocate(chunk);
+    }
+  }
+
+  //! Allocates memory for a runtime object from the global pool, if the pool is enabled
+  static void* Allocate(size_t size) {
+    if (!DEBUG_CLR_SYSMEM_POOL) {
+      return ::operator new(size);
+    }
+    ThreadCache& cache = cache_;
+    SysmemPool* pool = cache.Pin();
+    if (pool != nullptr) {
+      void* ptr = pool->Alloc(size);
+      if (SizeClass(size) != kLargeClass) {
+        cache.CountLive(1);
       }
-      // Validate if sysmempool released all memory
-      if (free_chunk_num_ != max_chunk_idx_) {
-        LogPrintfError("Unreleased chunk in sysmem pool %ld",  max_chunk_idx_ - free_chunk_num_);
+      cache.Unpin();
+      return ptr;
+    }
+    // The global pool doesn't exist after the teardown, hence use the system heap
+    Header* header = reinterpret_cast<Header*>(::operator new(size + sizeof(Header)));
+    header->size_class_ = kLargeClass;
+    return header + 1;
+  }
+
+  //! Releases memory, allocated with Allocate()
+  static void Release(void* ptr) {
+    if (!DEBUG_CLR_SYSMEM_POOL) {
+      ::operator delete(ptr);
+      return;
+    }
+    Header* header = reinterpret_cast<Header*>(ptr) - 1;
+    if (header->size_class_ == kLargeClass) {
+      ::operator delete(header);
+      return;
+    }
+    // The slots of the global pool were released with its chunks on the teardown
+    ThreadCache& cache = cache_;
+    SysmemPool* pool = cache.Pin();
+    if (pool != nullptr) {
+      pool->Free(ptr);
+      cache.CountLive(-1);
+      cache.Unpin();
+    }
+  }
+
+  //! Destroys the global pool. Waits for the threads, which are still inside the pool, so a
+  //! late Allocate() or Release() can't touch freed memory. The memory goes back to the system
+  //! only if all slots were released, otherwise the pool is leaked, since a slot released
+  //! later still reads its header.
+  //! @note The runtime calls it on the teardown, when the devices and queues are destroyed
+  static void Destroy() {
+    SysmemPool* pool = active_.exchange(nullptr);
+    if (pool == nullptr) {
+      return;
+    }
+    int64_t live = 0;
+    for (Hazard* hazard = hazards_.load(); hazard != nullptr; hazard = hazard->next_) {
+      while (hazard->pool_.load() == pool) {
+        Os::yield();
       }
+      live += hazard->live_.load(std::memory_order_relaxed);
+    }
+    if (live == 0) {
+      delete pool;
     }
   }
+
   void* Alloc(size_t size) {
-    guarantee(size <= sizeof(T), "Bigger size than pool allows!");
-    size_t current = current_alloc_++;
-    auto idx = current / kAllocChunkSize;
-    while (idx >= max_chunk_idx_) {
-      ScopedLock lock(chunk_access_);
-      // Second check in a case of multiple waiters
-      if (idx == max_chunk_idx_) {
-        auto allocs = new MemoryObject[kAllocChunkSize];
-        // Save the base in the first slot of all allocations
-        allocs[0].base_ = new AllocChunk(allocs);
-        // Check if the overwritten chunk has still empty slots
-        if (active_allocs_[idx % kActiveAllocSize] != nullptr) {
-          auto stale = active_allocs_[idx % kActiveAllocSize]->base_;
-          if (stale->busy_ != kAllocChunkSize) {
-            // The pool contains the stale slots, hence make sure it's marked as free
-            auto freed = stale->free_ - stale->busy_;
-            if (freed == 0) {
-              delete stale;
-              free_chunk_num_++;
-            }
-          }
-        }
-        // Keep the chunk in the list of active chunks
-        active_allocs_[idx % kActiveAllocSize] = allocs;
-        max_chunk_idx_++;
-      } else if ((idx < max_chunk_idx_) && ((max_chunk_idx_ - idx) >= kActiveAllocSize)) {
-        // If a wait was very long, then drop the old slot and find a more recent one
-        current = current_alloc_++;
-        idx = current / kAllocChunkSize;
+    uint32_t size_class = SizeClass(size);
+    Header* header = nullptr;
+    if (size_class == kLargeClass) {
+      header = reinterpret_cast<Header*>(::operator new(size + sizeof(Header)));
+    } else {
+      Magazine& magazine = Cache().magazines_[size_class];
+      if (magazine.count_ == 0) {
+        Refill(size_class, magazine);
       }
+      header = reinterpret_cast<Header*>(magazine.slots_[--magazine.count_]);
     }
-
-    // Find a slot in the active pool of allocations
-    auto chunk_idx = idx % kActiveAllocSize;
-    MemoryObject* obj = &active_allocs_[chunk_idx][current % kAllocChunkSize];
-    // Save the chunk allocation
-    obj->base_ = active_allocs_[chunk_idx]->base_;
-    obj->base_->busy_++;
-    return &obj->object_;
+    header->size_class_ = size_class;
+    return header + 1;
   }
 
   void Free(void* ptr) {
-#if IS_WINDOWS
-    auto obj = reinterpret_cast<MemoryObject*>(
-      reinterpret_cast<address>(ptr) - offsetof(MemoryObject, object_));
-#else
-    auto obj = reinterpret_cast<MemoryObject*>(
-      reinterpret_cast<address>(ptr) - sizeof(AllocChunk*));
-#endif
-    auto freed = --obj->base_->free_;
-    // If it's the last slot in the chunk, then release memory
-    if (freed == 0) {
-      auto base = obj->base_;
-      {
-        // Make sure active chunks don't have a stale pointer
-        ScopedLock lock(chunk_access_);
-        for (int i = 0; i < kActiveAllocSize; ++i) {
-          if (base->allocs_ == active_allocs_[i]) {
-            active_allocs_[i] = nullptr;
-            break;
-          }
-        }
-      }
-      delete base;
-      free_chunk_num_++;
+    Header* header = reinterpret_cast<Header*>(ptr) - 1;
+    uint32_t size_class = header->size_class_;
+    if (size_class == kLargeClass) {
+      ::operator delete(header);
+      return;
     }
+    // The slot goes to the current thread, even if another thread allocated it
+    Magazine& magazine = Cache().magazines_[size_class];
+    if (magazine.count_ == kMagazineSize) {
+      Drain(size_class, magazine, kMagazineSize / 2);
+    }
+    magazine.slots_[magazine.count_++] = header;
   }
 
-private:
-  static constexpr size_t kAllocChunkSize = 2048;  //!< The total number of allocations in a chunk
-  static constexpr size_t kActiveAllocSize = 32;   //!< The number of active chunks
-  struct AllocChunk;
-  struct MemoryObject {
-    AllocChunk* base_;      //!< The chunk information for this memory object
-    T   object_;            //!< Allocated user object
-    MemoryObject() {}
+ private:
+  static constexpr size_t kGranularity = 64;    //!< Slot size granularity of the size classes
+  static constexpr uint32_t kNumClasses = 32;   //!< The number of size classes, up to 2KB slots
+  static constexpr uint32_t kLargeClass = kNumClasses;  //!< Allocations from the system heap
+  static constexpr uint32_t kMagazineSize = 32; //!< The number of slots in a thread magazine
+  static constexpr size_t kChunkSize = 64 * Ki; //!< The size of the depot refill allocation
+
+  //! Allocation header, which keeps the size class of the slot
+  struct alignas(16) Header {
+    uint32_t size_class_;   //!< The size class of the allocation
+  };
+
+  //! Thread local free slots of a size class
+  struct Magazine {
+    uint32_t count_ = 0;            //!< The number of valid slots
+    void* slots_[kMagazineSize];    //!< Free slots
   };
-  struct AllocChunk {
-    MemoryObject* allocs_;        //! Array of allocations
-    std::atomic<uint32_t> busy_;  //! The number of commands still available for usage
-    std::atomic<uint32_t> free_;  //! The number of commands still available for usage
-    AllocChunk(MemoryObject* alloc): allocs_(alloc), busy_(0), free_(kAllocChunkSize) {}
-    ~AllocChunk() { delete [] allocs_; }
+
+  //! Pins the global pool for one thread. Destroy() waits until no hazard holds the pool.
+  //! The records are never freed, a thread releases its record on exit for the reuse.
+  struct Hazard {
+    std::atomic<SysmemPool*> pool_{nullptr};  //!< The pinned pool
+    std::atomic<int64_t> live_{0};            //!< Allocated minus released slots of the owners
+    std::atomic<bool> used_{true};            //!< The record belongs to a live thread
+    Hazard* next_ = nullptr;                  //!< The next record in the global list
+  };
+
+  //! Per thread cache of free slots for all size classes
+  struct ThreadCache {
+    SysmemPool* pool_ = nullptr;            //!< The pool, which owns the cached slots
+    Hazard* hazard_ = nullptr;              //!< The hazard record of the thread
+    Magazine magazines_[kNumClasses];       //!< Magazines for all size classes
+
+    //! Pins the global pool, returns nullptr after the teardown
+    SysmemPool* Pin() {
+      if (hazard_ == nullptr) {
+        hazard_ = AcquireHazard();
+      }
+      SysmemPool* pool = active_.load();
+      while (pool != nullptr) {
+        hazard_->pool_.store(pool);
+        // Destroy() may have cleared the pool before it saw the hazard
+        SysmemPool* current = active_.load();
+        if (current == pool) {
+          break;
+        }
+        pool = current;
+      }
+      if (pool == nullptr) {
+        hazard_->pool_.store(nullptr, std::memory_order_release);
+      }
+      return pool;
+    }
+
+    //! Unpins the global pool after Pin() returned it
+    void Unpin() { hazard_->pool_.store(nullptr, std::memory_order_release); }
+
+    //! Counts allocated or released slots. Only the owner thread writes the record
+    void CountLive(int64_t count) {
+      hazard_->live_.store(hazard_->live_.load(std::memory_order_relaxed) + count,
+                           std::memory_order_relaxed);
+    }
+
+    //! Returns all cached slots to the pool on the thread exit. The slots are pushed
+    //! without the depot lock, since the runtime thread object may be gone already
+    ~ThreadCache() {
+      if (pool_ == nullptr) {
+        return;
+      }
+      if (Pin() == pool_) {
+        for (uint32_t i = 0; i < kNumClasses; ++i) {
+          pool_->PushReturned(i, magazines_[i]);
+        }
+      }
+      Unpin();
+      hazard_->used_.store(false, std::memory_order_release);
+    }
   };
 
-  std::atomic<uint64_t> current_alloc_ = 0; //!< Current allocation, global index
-  std::atomic<size_t> max_chunk_idx_ = 0;   //!< Current max chunk index
-  size_t  free_chunk_num_ = 0;              //!< The number of freed chunks
-  amd::Monitor  chunk_access_;              //!< Lock for the chunk list access
-  MemoryObject* active_allocs_[kActiveAllocSize] = {}; //!< Active chunks for fast access
+  //! Returns the size class for the specified object size
+  static uint32_t SizeClass(size_t size) {
+    size_t size_class = (size + sizeof(Header) - 1) / kGranularity;
+    return (size_class < kNumClasses) ? static_cast<uint32_t>(size_class) : kLargeClass;
+  }
+
+  //! Returns the cache of the current thread
+  ThreadCache& Cache() {
+    ThreadCache& cache = cache_;
+    if (cache.pool_ != this) {
+      // The slots from a destroyed pool are invalid
+      for (auto& magazine : cache.magazines_) {
+        magazine.count_ = 0;
+      }
+      cache.pool_ = this;
+    }
+    return cache;
+  }
+
+  //! Moves half of a magazine from the depot into the thread magazine
+  void Refill(uint32_t size_class, Magazine& magazine) {
+    ScopedLock lock(depot_access_);
+    auto& depot = depot_[size_class];
+    // Collect the slots of the exited threads first
+    if (returned_[size_class].load(std::memory_order_relaxed) != nullptr) {
+      void* slot = returned_[size_class].exchange(nullptr, std::memory_order_acquire);
+      while (slot != nullptr) {
+        depot.push_back(slot);
+        slot = *reinterpret_cast<void**>(slot);
+      }
+    }
+    if (depot.empty()) {
+      // Carve a new chunk into the slots of the current size class
+      size_t slot_size = (size_class + 1) * kGranularity;
+      address chunk = reinterpret_cast<address>(AlignedMemory::allocate(kChunkSize, kGranularity));
+      guarantee(chunk != nullptr, "Sysmem pool can't allocate a new chunk!");
+      chunks_.push_back(chunk);
+      for (size_t offset = 0; offset + slot_size <= kChunkSize; offset += slot_size) {
+        depot.push_back(chunk + offset);
+      }
+    }
+    while (!depot.empty() && (magazine.count_ < kMagazineSize / 2)) {
+      magazine.slots_[magazine.count_++] = depot.back();
+      depot.pop_back();
+    }
+  }
+
+  //! Moves \a count slots from the thread magazine into the depot
+  void Drain(uint32_t size_class, Magazine& magazine, uint32_t count) {
+    ScopedLock lock(depot_access_);
+    auto& depot = depot_[size_class];
+    for (uint32_t i = 0; i < count; ++i) {
+      depot.push_back(magazine.slots_[--magazine.count_]);
+    }
+  }
+
+  //! Pushes all slots of the thread magazine into the returned list without the depot lock
+  void PushReturned(uint32_t size_class, Magazine& magazine) {
+    if (magazine.count_ == 0) {
+      return;
+    }
+    // Link the slots through their first word, then publish the chain with one exchange
+    void* first = magazine.slots_[0];
+    void* last = first;
+    for (uint32_t i = 1; i < magazine.count_; ++i) {
+      *reinterpret_cast<void**>(last) = magazine.slots_[i];
+      last = magazine.slots_[i];
+    }
+    magazine.count_ = 0;
+    void* head = returned_[size_class].load(std::memory_order_relaxed);
+    do {
+      *reinterpret_cast<void**>(last) = head;
+    } while (!returned_[size_class].compare_exchange_weak(head, first, std::memory_order_release,
+                                                          std::memory_order_relaxed));
+  }
+
+  //! Returns a free hazard record or adds a new one to the global list
+  static Hazard* AcquireHazard() {
+    for (Hazard* hazard = hazards_.load(std::memory_order_acquire); hazard != nullptr;
+         hazard = hazard->next_) {
+      bool used = false;
+      if (hazard->used_.compare_exchange_strong(used, true, std::memory_order_acquire)) {
+        return hazard;
+      }
+    }
+    Hazard* hazard = new Hazard;
+    hazard->next_ = hazards_.load(std::memory_order_relaxed);
+    while (!hazards_.compare_exchange_weak(hazard->next_, hazard, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+    }
+    return hazard;
+  }
+
+  std::vector<void*> depot_[kNumClasses];  //!< Free slots shared between threads
+  std::vector<void*> chunks_;              //!< All allocated chunks
+  amd::Monitor  depot_access_;             //!< Lock for the depot access
+  std::atomic<void*> returned_[kNumClasses] = {};  //!< Slots of the exited threads
+
+  static std::atomic<SysmemPool*> active_;    //!< The global pool instance
+  static std::atomic<Hazard*> hazards_;       //!< Hazard records of all threads
+  static thread_local ThreadCache cache_;     //!< Slots cache of the current thread
 };
 
 }  // namespace amd
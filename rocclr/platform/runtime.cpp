@@ -90,6 +90,9 @@ void Runtime::tearDown() {
     return;
   }
 
+  if (DEBUG_CLR_MONITOR_STATS) {
+    Monitor::PrintStats();
+  }
   Agent::tearDown();
   Device::tearDown();
   option::teardown();
@@ -104,7 +107,7 @@ void Runtime::tearDown() {
 // ~RuntimeTearDown() will reference listenerLock.
 // listenerLock will be constructed ealier and destructed later than
 // runtime_tear_down.
-amd::Monitor listenerLock("Hostcall listener lock");
+amd::Monitor listenerLock("Hostcall listener lock", true);
 std::vector<ReferenceCountedObject*> RuntimeTearDown::external_;
 
 RuntimeTearDown::~RuntimeTearDown() {
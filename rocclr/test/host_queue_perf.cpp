@@ -0,0 +1,234 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Enqueue->dequeue throughput and latency of the amd::HostQueue worker queues: many producer
+// threads and a single consumer, which parks only when the queue is empty. It compares the
+// linked queue with the monitor notification on every flush (the original worker loop), the
+// linked queue with parking on a wait address, and the bounded ring with batched dequeue.
+// The producers park on a wait address too, while the ring is full.
+
+#include <os/os.hpp>
+#include <thread/monitor.hpp>
+#include <thread/thread.hpp>
+#include <utils/concurrent.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+static constexpr size_t MaxDequeueBatch = 32;
+
+struct Item {
+  uint64_t enqueueTime_;  //!< The time, when the producer added the item
+};
+
+// amd::Monitor requires a runtime thread object for the calling thread
+static void AttachThread() {
+  if (amd::Thread::current() == nullptr) {
+    new amd::HostThread();
+  }
+}
+
+enum class Mode { LinkedMonitor, LinkedWaitAddress, RingWaitAddress };
+
+static const char* ModeName(Mode mode) {
+  switch (mode) {
+    case Mode::LinkedMonitor:     return "linked queue, monitor notify ";
+    case Mode::LinkedWaitAddress: return "linked queue, address parking";
+    default:                      return "ring queue,   address parking";
+  }
+}
+
+// The queue with the same parking protocol as HostQueue::loop(), HostQueue::flush() and
+// HostQueue::enqueueRing()
+class WorkQueue {
+ public:
+  WorkQueue(Mode mode, size_t ringSize)
+      : mode_(mode), ring_(ringSize), lock_("WorkQueue", true) {}
+
+  void enqueue(Item* item) {
+    if (mode_ == Mode::RingWaitAddress) {
+      if (!ring_.enqueue(item)) {
+        waitingProducers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (true) {
+          uint32_t sequence = spaceSequence_.load(std::memory_order_acquire);
+          if (ring_.enqueue(item)) {
+            break;
+          }
+          flush();
+          amd::Os::waitOnAddress(&spaceSequence_, sequence);
+        }
+        waitingProducers_.fetch_sub(1, std::memory_order_relaxed);
+      }
+    } else {
+      linked_.enqueue(item);
+    }
+    flush();
+  }
+
+  void flush() {
+    if (mode_ == Mode::LinkedMonitor) {
+      amd::ScopedLock sl(lock_);
+      lock_.notify();
+      return;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked_.load(std::memory_order_relaxed)) {
+      wakeSequence_.fetch_add(1, std::memory_order_release);
+      amd::Os::wakeOnAddress(&wakeSequence_, false);
+    }
+  }
+
+  // Returns the number of dequeued items, 0 if the queue is empty and the producers are done
+  size_t dequeue(Item** items) {
+    size_t count = tryDequeue(items);
+    if (count != 0) {
+      return count;
+    }
+    if (mode_ == Mode::LinkedMonitor) {
+      amd::ScopedLock sl(lock_);
+      while ((count = tryDequeue(items)) == 0 && !done_) {
+        lock_.wait();
+      }
+      return count;
+    }
+    parked_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (true) {
+      uint32_t sequence = wakeSequence_.load(std::memory_order_acquire);
+      if ((count = tryDequeue(items)) != 0 || done_) {
+        break;
+      }
+      amd::Os::waitOnAddress(&wakeSequence_, sequence);
+    }
+    parked_.store(false, std::memory_order_relaxed);
+    return count;
+  }
+
+  void finish() {
+    {
+      amd::ScopedLock sl(lock_);
+      done_ = true;
+      lock_.notify();
+    }
+    wakeSequence_.fetch_add(1, std::memory_order_release);
+    amd::Os::wakeOnAddress(&wakeSequence_, true);
+  }
+
+ private:
+  size_t tryDequeue(Item** items) {
+    if (mode_ == Mode::RingWaitAddress) {
+      size_t count = ring_.dequeue(items, MaxDequeueBatch);
+      if (count != 0) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waitingProducers_.load(std::memory_order_relaxed) != 0) {
+          spaceSequence_.fetch_add(1, std::memory_order_release);
+          amd::Os::wakeOnAddress(&spaceSequence_, true);
+        }
+      }
+      return count;
+    }
+    items[0] = linked_.dequeue();
+    return (items[0] != nullptr) ? 1 : 0;
+  }
+
+  const Mode mode_;
+  amd::ConcurrentLinkedQueue<Item*> linked_;
+  amd::ConcurrentRingQueue<Item*> ring_;
+  amd::Monitor lock_;
+  std::atomic<bool> parked_ = false;
+  std::atomic<uint32_t> wakeSequence_ = 0;
+  std::atomic<uint32_t> waitingProducers_ = 0;
+  std::atomic<uint32_t> spaceSequence_ = 0;
+  std::atomic<bool> done_ = false;
+};
+
+static void Run(Mode mode, size_t numProducers, size_t itemsPerProducer, size_t ringSize) {
+  WorkQueue queue(mode, ringSize);
+  std::vector<Item> items(numProducers * itemsPerProducer);
+  std::vector<uint64_t> latencies;
+  latencies.reserve(items.size());
+  std::atomic<size_t> consumed = 0;
+
+  std::thread consumer([&]() {
+    AttachThread();
+    Item* batch[MaxDequeueBatch];
+    size_t count;
+    while ((count = queue.dequeue(batch)) != 0) {
+      uint64_t now = amd::Os::timeNanos();
+      for (size_t i = 0; i < count; ++i) {
+        latencies.push_back(now - batch[i]->enqueueTime_);
+      }
+      consumed.fetch_add(count, std::memory_order_relaxed);
+    }
+  });
+
+  uint64_t start = amd::Os::timeNanos();
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < numProducers; ++p) {
+    producers.emplace_back([&, p]() {
+      AttachThread();
+      for (size_t i = 0; i < itemsPerProducer; ++i) {
+        Item* item = &items[p * itemsPerProducer + i];
+        item->enqueueTime_ = amd::Os::timeNanos();
+        queue.enqueue(item);
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  // Wait for the consumer to drain the queue
+  while (consumed.load(std::memory_order_relaxed) < items.size()) {
+    amd::Os::yield();
+  }
+  uint64_t end = amd::Os::timeNanos();
+  queue.finish();
+  consumer.join();
+
+  std::sort(latencies.begin(), latencies.end());
+  double sec = (end - start) * 1e-9;
+  printf("%s %2zu producers: %7.2f Mitems/s, latency p50 %7.2f us, p99 %8.2f us\n",
+         ModeName(mode), numProducers, items.size() / sec / 1e6,
+         latencies[latencies.size() / 2] * 1e-3, latencies[latencies.size() * 99 / 100] * 1e-3);
+}
+
+int main(int argc, char** argv) {
+  size_t maxProducers = (argc > 1) ? strtoull(argv[1], nullptr, 0)
+                                   : std::max(1u, std::thread::hardware_concurrency() / 2);
+  size_t itemsPerProducer = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 200000;
+  size_t ringSize = (argc > 3) ? strtoull(argv[3], nullptr, 0) : 1024;
+  if ((maxProducers == 0) || (itemsPerProducer == 0) || (ringSize == 0)) {
+    printf("Usage: %s [max producers] [items per producer] [ring size]\n", argv[0]);
+    return 1;
+  }
+
+  AttachThread();
+  for (size_t producers = 1; producers <= maxProducers; producers *= 2) {
+    for (Mode mode : { Mode::LinkedMonitor, Mode::LinkedWaitAddress, Mode::RingWaitAddress }) {
+      Run(mode, producers, itemsPerProducer, ringSize);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,247 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Cost of amd::KernelParameters::captureAndSet, which packs the kernel arguments of every
+// launch with the packing plan of the signature. The signatures are synthetic mixes of
+// pointers, ints, longs and structs, so no program or device is required. The pointers
+// reference buffers in amd::MemObjMap, which are never allocated on a device. Every mode is
+// compared with the per argument loop, which packed the arguments before the plans, for both
+// the array of pointers and the packed arguments buffer. The last mode skips the memory object
+// lookup with DEBUG_CLR_KERNARG_SKIP_MEMOBJ_LOOKUP.
+
+#include <device/device.hpp>
+#include <platform/context.hpp>
+#include <platform/kernel.hpp>
+#include <platform/memory.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static constexpr uintptr_t BaseAddress = 0x100000000000ull;
+static constexpr size_t BufferSize = 64 * 1024;
+static constexpr size_t NumBuffers = 1024;
+static constexpr size_t StructSize = 24;
+
+// Kernel arguments of one signature, the array of pointers references the packed buffer
+struct Arguments {
+  amd::KernelSignature* signature_;
+  amd::KernelParameters* parameters_;
+  std::vector<uint8_t> kernArgs_;
+  std::vector<void*> kernelParams_;
+  size_t size_;  // Size of the captured arguments and memory objects
+};
+
+// Pointer, int, long and struct arguments in a rotation, aligned like the HW ABI
+static Arguments Build(uint32_t numArgs) {
+  std::vector<amd::KernelParameterDescriptor> params(numArgs);
+  size_t offset = 0;
+  for (uint32_t i = 0; i < numArgs; ++i) {
+    auto& desc = params[i];
+    switch (i % 4) {
+      case 0:
+        desc.type_ = T_POINTER;
+        desc.size_ = sizeof(void*);
+        desc.addressQualifier_ = CL_KERNEL_ARG_ADDRESS_GLOBAL;
+        desc.info_.oclObject_ = amd::KernelParameterDescriptor::MemoryObject;
+        break;
+      case 1:
+        desc.type_ = T_INT;
+        desc.size_ = sizeof(int32_t);
+        break;
+      case 2:
+        desc.type_ = T_LONG;
+        desc.size_ = sizeof(int64_t);
+        break;
+      default:
+        desc.type_ = T_VOID;
+        desc.size_ = StructSize;
+        desc.info_.oclObject_ = amd::KernelParameterDescriptor::ValueObject;
+        break;
+    }
+    offset = amd::alignUp(offset, std::min<size_t>(desc.size_, sizeof(uint64_t)));
+    desc.offset_ = offset;
+    offset += desc.size_;
+  }
+
+  Arguments args;
+  args.signature_ = new amd::KernelSignature(params, "", numArgs,
+                                             amd::KernelSignature::ABIVersion_2);
+  args.parameters_ = new (*args.signature_) amd::KernelParameters(*args.signature_);
+  args.size_ = args.signature_->paramsSize() + args.signature_->numMemories() * sizeof(void*);
+  args.kernArgs_.resize(args.signature_->paramsSize());
+  for (uint32_t i = 0; i < numArgs; ++i) {
+    const auto& desc = args.signature_->params()[i];
+    uint8_t* value = &args.kernArgs_[desc.offset_];
+    if (desc.type_ == T_POINTER) {
+      uintptr_t ptr = BaseAddress + (i * 7 % NumBuffers) * BufferSize + i * 16;
+      ::memcpy(value, &ptr, sizeof(ptr));
+    } else {
+      for (size_t b = 0; b < desc.size_; ++b) {
+        value[b] = static_cast<uint8_t>(i * 31 + b);
+      }
+    }
+    args.kernelParams_.push_back(value);
+  }
+  return args;
+}
+
+// The per argument loop, which classified every argument on every launch
+static void LoopCapture(const amd::KernelSignature& signature, void** kernelParams,
+                        address kernArgs, address mem) {
+  amd::Memory** memories = reinterpret_cast<amd::Memory**>(mem + signature.paramsSize());
+  for (size_t idx = 0; idx < signature.numParameters(); ++idx) {
+    const amd::KernelParameterDescriptor& desc = signature.at(idx);
+    const void* value = (kernelParams != nullptr) ? kernelParams[idx] : kernArgs + desc.offset_;
+    void* param = mem + desc.offset_;
+    if (desc.type_ == T_POINTER && (desc.addressQualifier_ != CL_KERNEL_ARG_ADDRESS_LOCAL)) {
+      amd::Memory* memArg =
+          amd::MemObjMap::FindMemObj(*reinterpret_cast<const void* const*>(value));
+      memories[desc.info_.arrayIndex_] = memArg;
+      if (memArg != nullptr) {
+        memArg->retain();
+      }
+    }
+    switch (desc.size_) {
+      case sizeof(uint32_t):
+        *static_cast<uint32_t*>(param) = *static_cast<const uint32_t*>(value);
+        break;
+      case sizeof(uint64_t):
+        *static_cast<uint64_t*>(param) = *static_cast<const uint64_t*>(value);
+        break;
+      default:
+        ::memcpy(param, value, desc.size_);
+        break;
+    }
+  }
+}
+
+// Releases the memory objects, retained by the capture
+static void Release(const amd::KernelSignature& signature, address mem) {
+  amd::Memory** memories = reinterpret_cast<amd::Memory**>(mem + signature.paramsSize());
+  for (uint32_t i = 0; i < signature.numMemories(); ++i) {
+    if (memories[i] != nullptr) {
+      memories[i]->release();
+    }
+  }
+}
+
+struct Mode {
+  const char* name_;
+  bool plan_;
+  bool buffer_;
+  bool skipLookup_;
+};
+
+// Returns the time per launch in ns and the captured arguments of the last launch
+static double Run(Arguments& args, const Mode& mode, size_t launches,
+                  std::vector<uint64_t>& captured) {
+  DEBUG_CLR_KERNARG_SKIP_MEMOBJ_LOOKUP = mode.skipLookup_;
+  captured.assign(amd::alignUp(args.size_, sizeof(uint64_t)) / sizeof(uint64_t), 0);
+  address mem = reinterpret_cast<address>(captured.data());
+  void** kernelParams = mode.buffer_ ? nullptr : args.kernelParams_.data();
+  address kernArgs = mode.buffer_ ? args.kernArgs_.data() : nullptr;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < launches; ++i) {
+    if (mode.plan_) {
+      args.parameters_->captureAndSet(kernelParams, kernArgs, mem);
+    } else {
+      LoopCapture(*args.signature_, kernelParams, kernArgs, mem);
+    }
+    if (i + 1 < launches) {
+      Release(*args.signature_, mem);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  Release(*args.signature_, mem);
+  return std::chrono::duration<double, std::nano>(end - start).count() / launches;
+}
+
+int main(int argc, char** argv) {
+  size_t launches = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 1000000;
+  if (launches == 0) {
+    printf("Usage: %s [launches per signature]\n", argv[0]);
+    return 1;
+  }
+
+  // The lookup skip applies to HIP without the memory dependency tracking
+  amd::IS_HIP = true;
+  GPU_NUM_MEM_DEPENDENCY = 0;
+
+  amd::Context::Info info = {};
+  amd::Context* context = new amd::Context(std::vector<amd::Device*>(), info);
+  std::vector<amd::Memory*> buffers;
+  for (size_t i = 0; i < NumBuffers; ++i) {
+    amd::Memory* mem = new (*context) amd::Buffer(*context, 0, BufferSize);
+    amd::MemObjMap::AddMemObj(reinterpret_cast<const void*>(BaseAddress + i * BufferSize), mem);
+    buffers.push_back(mem);
+  }
+
+  const Mode modes[] = {
+    {"loop, params", false, false, false},
+    {"plan, params", true, false, false},
+    {"loop, buffer", false, true, false},
+    {"plan, buffer", true, true, false},
+    {"plan, buffer, skip", true, true, true},
+  };
+
+  size_t errors = 0;
+  printf("Kernel argument packing: %zu launches per signature, ns per launch\n", launches);
+  printf("%-5s", "args");
+  for (const auto& mode : modes) {
+    printf(" %19s", mode.name_);
+  }
+  printf("\n");
+  for (uint32_t numArgs : {1, 4, 12, 32}) {
+    Arguments args = Build(numArgs);
+    std::vector<uint64_t> reference;
+    Run(args, modes[0], 1, reference);
+    printf("%-5u", numArgs);
+    for (const auto& mode : modes) {
+      std::vector<uint64_t> captured;
+      printf(" %19.1f", Run(args, mode, launches, captured));
+      // The skipped lookup leaves the memory objects empty, the arguments must match
+      size_t compare = mode.skipLookup_ ? args.signature_->paramsSize() : args.size_;
+      if (::memcmp(captured.data(), reference.data(), compare) != 0) {
+        errors++;
+      }
+    }
+    printf("\n");
+    delete args.parameters_;
+    delete args.signature_;
+  }
+
+  for (size_t i = 0; i < NumBuffers; ++i) {
+    amd::MemObjMap::RemoveMemObj(reinterpret_cast<const void*>(BaseAddress + i * BufferSize));
+    buffers[i]->release();
+  }
+  context->release();
+
+  if (errors != 0) {
+    printf("FAILED: %zu captures differ from the per argument loop\n", errors);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
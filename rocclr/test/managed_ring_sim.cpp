@@ -0,0 +1,160 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Host simulation of the staging ring of ManagedBuffer. The ring is the same ChunkRing, which
+// the queue uses, but the chunk signals are replaced with a simulated GPU timeline: the GPU
+// executes the staged copies in order and releases a chunk when it reaches the barrier behind
+// the chunk. The simulation checks that a chunk is never handed out while the GPU uses it and
+// that the chunks are reused in the order of their barriers, then compares the CPU stall time
+// of a fixed ring against the growing one.
+
+#include <device/rocm/rocring.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+static constexpr uint32_t ChunkSize = 1024 * 1024;   // Staging chunk, 1MB
+static constexpr uint32_t Alignment = 256;
+static constexpr uint32_t InitialChunks = 4;
+
+struct SimChunk {
+  uint32_t id_;
+  double busyUntil_;    // GPU time in us, when the barrier behind the chunk completes
+  uint64_t barrier_;    // Sequence number of the last barrier behind the chunk
+};
+
+struct Workload {
+  const char* name_;
+  uint32_t maxCopy_;    // Maximum size of a staged copy in bytes
+  double cpuUs_;        // CPU time between two staged copies
+  double gpuGBs_;       // GPU copy throughput
+  double gpuLatencyUs_; // Fixed GPU cost per copy
+  uint32_t burst_;      // Copies per burst, 0 - a steady stream of copies
+  double pauseUs_;      // CPU time between the bursts
+};
+
+struct Result {
+  uint64_t switches_;
+  uint64_t grows_;
+  uint64_t stalls_;
+  uint32_t chunks_;
+  double stallUs_;
+  double totalUs_;
+};
+
+static Result Run(const Workload& work, uint32_t maxChunks, size_t copies, size_t& errors) {
+  amd::roc::ChunkRing<SimChunk> ring(maxChunks);
+  uint32_t ids = 0;
+  for (uint32_t i = 0; i < InitialChunks; ++i) {
+    ring.Append({ids++, 0.0, 0});
+  }
+
+  std::mt19937_64 rng(42);
+  double cpuTime = 0.0;     // Submission time of the next copy
+  double gpuTime = 0.0;     // Completion time of the last submitted copy
+  double stallUs = 0.0;
+  uint64_t barriers = 0;
+  uint32_t offset = 0;
+  for (size_t i = 0; i < copies; ++i) {
+    cpuTime += work.cpuUs_;
+    if ((work.burst_ != 0) && (i % work.burst_) == 0) {
+      cpuTime += work.pauseUs_;
+    }
+    uint32_t size = 1 + static_cast<uint32_t>(rng() % work.maxCopy_);
+    uint32_t start = (offset + Alignment - 1) & ~(Alignment - 1);
+    if (start + size > ChunkSize) {
+      // The barrier behind the active chunk completes after all copies, submitted so far
+      SimChunk& active = ring.Active();
+      active.busyUntil_ = std::max(gpuTime, cpuTime);
+      active.barrier_ = ++barriers;
+
+      // The next chunk must carry the oldest barrier in the ring
+      uint64_t oldest = UINT64_MAX;
+      for (const auto& chunk : ring.Chunks()) {
+        if (&chunk != &active) {
+          oldest = std::min(oldest, chunk.barrier_);
+        }
+      }
+      SimChunk& next = ring.Advance(
+          [&](const SimChunk& chunk) { return chunk.busyUntil_ > cpuTime; },
+          [&](SimChunk& chunk) {
+            chunk = {ids++, 0.0, 0};
+            return true;
+          },
+          [&](const SimChunk& chunk) {
+            stallUs += chunk.busyUntil_ - cpuTime;
+            cpuTime = chunk.busyUntil_;
+          });
+      if (next.busyUntil_ > cpuTime) {
+        errors++;
+      }
+      if ((next.barrier_ != 0) && (next.barrier_ != oldest)) {
+        errors++;
+      }
+      start = 0;
+    }
+    offset = start + size;
+    // The GPU executes the copy after the submission and the previous copies
+    gpuTime = std::max(gpuTime, cpuTime) + work.gpuLatencyUs_ + size / (work.gpuGBs_ * 1e3);
+  }
+  return {ring.Switches(), ring.Grows(), ring.Stalls(), ring.NumChunks(), stallUs,
+          std::max(cpuTime, gpuTime)};
+}
+
+int main(int argc, char** argv) {
+  size_t copies = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 1000000;
+  uint32_t maxChunks = (argc > 2) ? strtoul(argv[2], nullptr, 0) : 16;
+  if ((copies == 0) || (maxChunks < InitialChunks)) {
+    printf("Usage: %s [copies] [max chunks, >= %u]\n", argv[0], InitialChunks);
+    return 1;
+  }
+
+  const Workload workloads[] = {
+    {"steady tiny copies", 4 * 1024, 0.5, 20.0, 2.0, 0, 0.0},
+    {"steady large copies", 512 * 1024, 5.0, 10.0, 2.0, 0, 0.0},
+    {"bursts of tiny copies", 4 * 1024, 0.5, 20.0, 2.0, 2000, 10000.0},
+    {"bursts of medium copies", 64 * 1024, 2.0, 20.0, 2.0, 200, 5000.0},
+    {"idle GPU", 64 * 1024, 20.0, 20.0, 2.0, 0, 0.0},
+  };
+
+  size_t errors = 0;
+  printf("ManagedBuffer ring: %zu staged copies, %uKB chunks, %u initial chunks\n", copies,
+         ChunkSize / 1024, InitialChunks);
+  for (const auto& work : workloads) {
+    for (uint32_t max : {InitialChunks, maxChunks}) {
+      Result res = Run(work, max, copies, errors);
+      printf("%-24s max %2u: %2u chunks, %8llu switches, %4llu grows, %8llu stalls, "
+             "stall %5.1f%% of %.0f ms\n", work.name_, max, res.chunks_,
+             static_cast<unsigned long long>(res.switches_),
+             static_cast<unsigned long long>(res.grows_),
+             static_cast<unsigned long long>(res.stalls_),
+             100.0 * res.stallUs_ / res.totalUs_, res.totalUs_ / 1e3);
+    }
+  }
+
+  if (errors != 0) {
+    printf("FAILED: %zu chunks were handed out busy or out of order\n", errors);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,159 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Cost of the kernel argument dependency tracking in roc::VirtualGPU::MemoryDependency.
+// The tracker works with address ranges only, so the benchmark runs without a GPU. Every
+// kernel decision is compared with a linear scan over all busy objects, which is how the
+// dependencies were tracked before the range lists.
+
+#include <device/rocm/rocvirtual.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static constexpr uint64_t BaseAddress = 0x7f0000000000ull;
+static constexpr size_t NumBuffers = 4096;
+static constexpr size_t NumKernels = 100000;
+
+struct Argument {
+  uint64_t start_;
+  uint64_t end_;
+  bool readOnly_;
+};
+
+// The reference tracker: a flat array of all objects in the queue with a linear lookup
+class LinearDependency {
+ public:
+  explicit LinearDependency(size_t max) : max_(max) { objects_.reserve(max); }
+
+  void newKernel() { end_ = objects_.size(); }
+
+  // Returns true if the argument forces a wait for the previous kernels
+  bool validate(const Argument& arg) {
+    bool wait = false;
+    for (size_t j = 0; j < end_; ++j) {
+      if ((arg.start_ < objects_[j].end_) && (objects_[j].start_ < arg.end_) &&
+          (!objects_[j].readOnly_ || !arg.readOnly_)) {
+        wait = true;
+        break;
+      }
+    }
+    if (max_ <= objects_.size()) {
+      wait = true;
+    }
+    if (wait) {
+      // Keep the objects of the current kernel only
+      objects_.erase(objects_.begin(), objects_.begin() + end_);
+      end_ = 0;
+    }
+    objects_.push_back(arg);
+    return wait;
+  }
+
+ private:
+  std::vector<Argument> objects_;
+  size_t end_ = 0;
+  size_t max_;
+};
+
+// Generates kernels with the specified number of arguments. Every argument is a random
+// buffer, which is read only with the specified probability
+static std::vector<std::vector<Argument>> GenerateKernels(size_t numArgs, double readOnly) {
+  std::mt19937_64 rng(numArgs);
+  std::bernoulli_distribution ro(readOnly);
+  std::vector<Argument> buffers(NumBuffers);
+  uint64_t address = BaseAddress;
+  for (auto& buffer : buffers) {
+    uint64_t size = 256ull << (rng() % 13);
+    buffer = { address, address + size, false };
+    address += size + 4096 * (rng() % 4);
+  }
+
+  std::vector<std::vector<Argument>> kernels(NumKernels);
+  for (auto& kernel : kernels) {
+    for (size_t a = 0; a < numArgs; ++a) {
+      Argument arg = buffers[rng() % NumBuffers];
+      arg.readOnly_ = ro(rng);
+      kernel.push_back(arg);
+    }
+  }
+  return kernels;
+}
+
+int main(int argc, char** argv) {
+  size_t maxObjects = (argc > 1) ? strtoull(argv[1], nullptr, 0) : GPU_NUM_MEM_DEPENDENCY;
+  double readOnly = (argc > 2) ? strtod(argv[2], nullptr) : 0.9;
+  if (maxObjects == 0) {
+    printf("Usage: %s [max tracked objects] [read only probability]\n", argv[0]);
+    return 1;
+  }
+
+  size_t mismatches = 0;
+  printf("Dependency tracking of %zu kernels, %zu tracked objects, %.0f%% read only arguments\n",
+         NumKernels, maxObjects, readOnly * 100);
+  for (size_t numArgs : { 1, 4, 8, 16, 32, 64 }) {
+    // The limit growth for kernels with too many arguments isn't modelled by the reference
+    if (numArgs >= maxObjects) {
+      continue;
+    }
+    auto kernels = GenerateKernels(numArgs, readOnly);
+
+    roc::VirtualGPU::MemoryDependency tracker;
+    tracker.create(maxObjects);
+    std::vector<bool> waits(kernels.size());
+    auto start = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < kernels.size(); ++k) {
+      tracker.newKernel();
+      for (const auto& arg : kernels[k]) {
+        tracker.validate(arg.start_, arg.end_, arg.readOnly_);
+      }
+      waits[k] = tracker.validateKernel();
+    }
+    double ranges = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    LinearDependency reference(maxObjects);
+    size_t numWaits = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < kernels.size(); ++k) {
+      reference.newKernel();
+      bool wait = false;
+      for (const auto& arg : kernels[k]) {
+        wait |= reference.validate(arg);
+      }
+      numWaits += wait ? 1 : 0;
+      mismatches += (wait != waits[k]) ? 1 : 0;
+    }
+    double linear = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%2zu args: range lists %8.1f ns/kernel, linear scan %8.1f ns/kernel, "
+           "%5.1f%% kernels wait\n", numArgs, ranges * 1e9 / kernels.size(),
+           linear * 1e9 / kernels.size(), numWaits * 100.0 / kernels.size());
+  }
+
+  if (mismatches != 0) {
+    printf("FAILED: %zu kernels have a different wait decision\n", mismatches);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
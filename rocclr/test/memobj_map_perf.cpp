@@ -0,0 +1,191 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Lookup throughput of amd::MemObjMap. The map is filled with buffer objects, which are never
+// allocated on a device, so the benchmark runs without a GPU.
+
+#include <device/device.hpp>
+#include <platform/context.hpp>
+#include <platform/memory.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+static constexpr uintptr_t BaseAddress = 0x100000000000ull;
+static constexpr size_t AddressStride = 2 * 1024 * 1024;  // Largest allocation + a gap
+static constexpr size_t HotRepeats = 64;                  // Lookups per allocation in hot mode
+static constexpr size_t MixedLookups = 8;                 // Lookups per update in mixed mode
+
+struct Allocation {
+  uintptr_t start_;
+  size_t size_;
+  amd::Memory* mem_;
+};
+
+static std::vector<Allocation> allocations_;
+static std::atomic<size_t> errors_ = 0;
+
+// Looks up random addresses inside the allocations. In hot mode every thread keeps accessing
+// the same allocation, like a sequence of copies to one buffer, in cold mode every lookup goes
+// to a random allocation. In mixed mode the thread also adds and removes an own allocation
+// between the lookups, like a loop of temporary allocations next to a long lived buffer
+static void LookupThread(uint32_t seed, size_t lookups, bool hot, amd::Memory* mixed) {
+  std::mt19937_64 rng(seed);
+  uintptr_t own = BaseAddress + (allocations_.size() + seed) * AddressStride;
+  size_t index = 0;
+  for (size_t i = 0; i < lookups; ++i) {
+    if (!hot || (i % HotRepeats) == 0) {
+      index = rng() % allocations_.size();
+    }
+    if ((mixed != nullptr) && (i % MixedLookups) == 0) {
+      amd::MemObjMap::AddMemObj(reinterpret_cast<const void*>(own), mixed);
+      amd::MemObjMap::RemoveMemObj(reinterpret_cast<const void*>(own));
+    }
+    const Allocation& alloc = allocations_[index];
+    size_t expected = rng() % alloc.size_;
+    size_t offset = 0;
+    amd::Memory* mem =
+        amd::MemObjMap::FindMemObj(reinterpret_cast<const void*>(alloc.start_ + expected),
+                                   &offset);
+    if ((mem != alloc.mem_) || (offset != expected)) {
+      errors_++;
+    }
+  }
+}
+
+// Adds and removes one allocation behind the last one in a loop, so the lookup threads compete
+// with the updates for the map lock
+static void UpdateThread(amd::Context& context, std::atomic<bool>& done, size_t& updates) {
+  uintptr_t start = BaseAddress + allocations_.size() * AddressStride;
+  amd::Memory* mem = new (context) amd::Buffer(context, 0, AddressStride / 2);
+  while (!done.load(std::memory_order_relaxed)) {
+    amd::MemObjMap::AddMemObj(reinterpret_cast<const void*>(start), mem);
+    amd::MemObjMap::RemoveMemObj(reinterpret_cast<const void*>(start));
+    updates++;
+  }
+  mem->release();
+}
+
+static void Run(amd::Context& context, size_t numThreads, size_t lookups, bool hot,
+                bool update, bool mixed) {
+  std::atomic<bool> done = false;
+  size_t updates = 0;
+  std::thread updater;
+  if (update) {
+    updater = std::thread(UpdateThread, std::ref(context), std::ref(done), std::ref(updates));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  std::vector<amd::Memory*> own(numThreads, nullptr);
+  for (size_t t = 0; t < numThreads; ++t) {
+    if (mixed) {
+      own[t] = new (context) amd::Buffer(context, 0, AddressStride / 2);
+    }
+    threads.emplace_back(LookupThread, static_cast<uint32_t>(t + 1), lookups, hot, own[t]);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto end = std::chrono::steady_clock::now();
+  for (auto mem : own) {
+    if (mem != nullptr) {
+      mem->release();
+    }
+  }
+
+  done = true;
+  if (update) {
+    updater.join();
+  }
+
+  double sec = std::chrono::duration<double>(end - start).count();
+  double rate = static_cast<double>(numThreads * lookups) / sec / 1e6;
+  printf("%-6s %2zu threads, updates %-5s: %8.2f Mlookups/s, %6.1f ns/lookup/thread",
+         hot ? "hot" : "random", numThreads, mixed ? "mixed" : (update ? "on" : "off"), rate,
+         sec * 1e9 / lookups);
+  if (update) {
+    printf(", %zu map updates", updates);
+  }
+  printf("\n");
+}
+
+int main(int argc, char** argv) {
+  size_t numAllocations = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 200000;
+  size_t maxThreads = (argc > 2) ? strtoull(argv[2], nullptr, 0)
+                                 : std::thread::hardware_concurrency();
+  size_t lookups = (argc > 3) ? strtoull(argv[3], nullptr, 0) : 2000000;
+  if ((numAllocations == 0) || (maxThreads == 0)) {
+    printf("Usage: %s [allocations] [threads] [lookups per thread]\n", argv[0]);
+    return 1;
+  }
+
+  amd::Context::Info info = {};
+  amd::Context* context = new amd::Context(std::vector<amd::Device*>(), info);
+
+  // Allocation sizes from 4KB to 1MB, the ranges never overlap
+  std::mt19937_64 rng(0);
+  allocations_.reserve(numAllocations);
+  for (size_t i = 0; i < numAllocations; ++i) {
+    size_t size = (4 * 1024) << (rng() % 9);
+    uintptr_t start = BaseAddress + i * AddressStride;
+    amd::Memory* mem = new (*context) amd::Buffer(*context, 0, size);
+    amd::MemObjMap::AddMemObj(reinterpret_cast<const void*>(start), mem);
+    allocations_.push_back({start, size, mem});
+  }
+  printf("MemObjMap lookups with %zu live allocations\n", numAllocations);
+
+  for (bool update : {false, true}) {
+    for (bool hot : {true, false}) {
+      for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        Run(*context, threads, lookups, hot, update, false);
+      }
+    }
+  }
+  // The own updates of a thread must not invalidate the cached lookups of other ranges
+  for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+    Run(*context, threads, lookups, true, false, true);
+  }
+
+  // Addresses outside of any allocation must not be found
+  if ((amd::MemObjMap::FindMemObj(reinterpret_cast<const void*>(BaseAddress - 1)) != nullptr) ||
+      (amd::MemObjMap::FindMemObj(reinterpret_cast<const void*>(
+           allocations_[0].start_ + allocations_[0].size_)) != nullptr)) {
+    errors_++;
+  }
+
+  for (const auto& alloc : allocations_) {
+    amd::MemObjMap::RemoveMemObj(reinterpret_cast<const void*>(alloc.start_));
+    alloc.mem_->release();
+  }
+  context->release();
+
+  if (errors_ != 0) {
+    printf("FAILED: %zu lookups returned a wrong memory object or offset\n", errors_.load());
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
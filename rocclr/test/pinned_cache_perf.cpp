@@ -0,0 +1,218 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Cost of the pinned host memory cache of the queue per transfer. The cache is the same
+// PinnedCache, which the queue uses, but the pinned memory objects are replaced with the host
+// ranges only, so no device is required. The transfers are random subranges of synthetic host
+// buffers with a hot set, pinned with the page alignment of the blit manager, so the cached
+// ranges overlap and a bigger range may replace a cached one at the same address. Every budget
+// is compared with the stamp cache, which the queue used before PinnedCache: the lookup walked
+// back over all ranges on a miss and the eviction scanned all LRU stamps. The hits, the misses
+// and the eviction order must match.
+
+#include <device/rocm/rocpinnedcache.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+static constexpr uintptr_t BaseAddress = 0x100000000000ull;
+static constexpr size_t BufferStride = 64 * 1024 * 1024;
+static constexpr size_t PageSize = 4096;
+static constexpr size_t HotBuffers = 64;
+
+// Pinned memory object of the simulation
+struct SimMemory {
+  uintptr_t host_;
+  size_t size_;
+  uint32_t id_;
+};
+
+// The stamp cache, which the queue used before PinnedCache
+class StampCache {
+ public:
+  explicit StampCache(size_t budget) : budget_(budget) {}
+
+  SimMemory* Find(uintptr_t start, size_t size) {
+    auto it = ranges_.upper_bound(start);
+    while (it != ranges_.begin()) {
+      --it;
+      if ((start + size) <= (it->first + it->second.memory_->size_)) {
+        it->second.lastUse_ = ++stamp_;
+        return it->second.memory_;
+      }
+    }
+    return nullptr;
+  }
+
+  template <typename Evict> void Add(SimMemory* memory, Evict evict) {
+    auto it = ranges_.find(memory->host_);
+    if (it != ranges_.end()) {
+      if (it->second.memory_ == memory) {
+        return;
+      }
+      size_ -= it->second.memory_->size_;
+      evict(it->second.memory_);
+      ranges_.erase(it);
+    }
+    ranges_[memory->host_] = {memory, ++stamp_};
+    size_ += memory->size_;
+    while ((size_ > budget_) && (ranges_.size() > 1)) {
+      auto lru = ranges_.begin();
+      for (auto cur = ranges_.begin(); cur != ranges_.end(); ++cur) {
+        if (cur->second.lastUse_ < lru->second.lastUse_) {
+          lru = cur;
+        }
+      }
+      size_ -= lru->second.memory_->size_;
+      evict(lru->second.memory_);
+      ranges_.erase(lru);
+    }
+  }
+
+  size_t NumRanges() const { return ranges_.size(); }
+
+ private:
+  struct Entry {
+    SimMemory* memory_;
+    uint64_t lastUse_;
+  };
+  std::map<uintptr_t, Entry> ranges_;
+  size_t budget_;
+  size_t size_ = 0;
+  uint64_t stamp_ = 0;
+};
+
+// Pinned host range of one transfer
+struct Transfer {
+  uintptr_t start_;
+  size_t size_;
+};
+
+// Random subranges of the buffers, the hot buffers get most of the transfers
+static std::vector<Transfer> Workload(size_t transfers, size_t buffers, size_t maxTransfer) {
+  std::mt19937_64 rng(1234);
+  std::uniform_int_distribution<size_t> hot(0, std::min(HotBuffers, buffers) - 1);
+  std::uniform_int_distribution<size_t> any(0, buffers - 1);
+  std::uniform_int_distribution<size_t> length(1, maxTransfer);
+  std::uniform_int_distribution<size_t> percent(0, 99);
+  std::vector<Transfer> workload(transfers);
+  for (auto& transfer : workload) {
+    size_t buffer = (percent(rng) < 80) ? hot(rng) : any(rng);
+    size_t size = length(rng);
+    // A few distinct offsets per buffer, so the transfers reuse and extend the pinned ranges
+    size_t offset = (percent(rng) % 4) * (maxTransfer / 2) + (percent(rng) % 2) * 100;
+    uintptr_t start = BaseAddress + buffer * BufferStride + offset;
+    uintptr_t end = start + size;
+    start &= ~(PageSize - 1);
+    end = (end + PageSize - 1) & ~(PageSize - 1);
+    transfer = {start, end - start};
+  }
+  return workload;
+}
+
+struct Result {
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  size_t ranges_ = 0;
+  std::vector<uint32_t> evicted_;
+  double ns_ = 0.0;
+};
+
+// Looks up every transfer and pins the range on a miss, like the blit manager
+template <typename Cache, typename AddFn>
+static Result Run(Cache& cache, const std::vector<Transfer>& workload, AddFn add) {
+  Result result;
+  std::vector<SimMemory*> memories;
+  memories.reserve(workload.size());
+  auto evict = [&result](SimMemory* memory) { result.evicted_.push_back(memory->id_); };
+
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& transfer : workload) {
+    SimMemory* memory = cache.Find(transfer.start_, transfer.size_);
+    if (memory == nullptr) {
+      memory = new SimMemory{transfer.start_, transfer.size_,
+                             static_cast<uint32_t>(memories.size())};
+      memories.push_back(memory);
+      result.misses_++;
+    } else {
+      result.hits_++;
+    }
+    add(memory, evict);
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  result.ranges_ = cache.NumRanges();
+  result.ns_ = std::chrono::duration<double, std::nano>(end - start).count() / workload.size();
+  for (auto memory : memories) {
+    delete memory;
+  }
+  return result;
+}
+
+int main(int argc, char** argv) {
+  size_t transfers = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 200000;
+  size_t buffers = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 16384;
+  if ((transfers == 0) || (buffers == 0)) {
+    printf("Usage: %s [transfers] [host buffers]\n", argv[0]);
+    return 1;
+  }
+
+  size_t errors = 0;
+  printf("Pinned memory cache: %zu transfers over %zu host buffers, ns per transfer\n",
+         transfers, buffers);
+  printf("%-10s %-10s %8s %8s %12s %12s\n", "budget MB", "max KB", "ranges", "hit %",
+         "stamp scan", "LRU list");
+  for (size_t budget : {64, 256, 1024}) {
+    for (size_t maxTransfer : {64 * 1024, 1024 * 1024}) {
+      std::vector<Transfer> workload = Workload(transfers, buffers, maxTransfer);
+
+      StampCache stamp(budget * 1024 * 1024);
+      Result reference = Run(stamp, workload, [&stamp](SimMemory* memory, auto& evict) {
+        stamp.Add(memory, evict);
+      });
+
+      amd::roc::PinnedCache<SimMemory> lru(budget * 1024 * 1024);
+      Result result = Run(lru, workload, [&lru](SimMemory* memory, auto& evict) {
+        lru.Add(memory, memory->host_, memory->size_, evict);
+      });
+
+      if ((result.hits_ != reference.hits_) || (result.misses_ != reference.misses_) ||
+          (result.evicted_ != reference.evicted_) || (result.ranges_ != reference.ranges_) ||
+          (lru.Hits() != result.hits_) || (lru.Misses() != result.misses_)) {
+        errors++;
+      }
+      printf("%-10zu %-10zu %8zu %8.1f %12.1f %12.1f\n", budget, maxTransfer / 1024,
+             result.ranges_, 100.0 * result.hits_ / transfers, reference.ns_, result.ns_);
+    }
+  }
+
+  if (errors != 0) {
+    printf("FAILED: %zu runs differ from the stamp scan\n", errors);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,159 @@
+/* Copyright (c) 2026 Advanced Micro Devices, Inc. All Rights Reserved.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE. */
+
+// Allocation and release cost of amd::SysmemPool, which backs the runtime commands and HIP
+// events, against the system heap. The sizes follow the most common command classes. Objects
+// are released either by the allocating thread or by another thread, like commands, which
+// are created by the application thread and destroyed on completion by the runtime.
+
+#include <platform/command.hpp>
+#include <thread/thread.hpp>
+#include <utils/concurrent.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+static const size_t Sizes[] = {
+    sizeof(amd::Marker), sizeof(amd::NDRangeKernelCommand), sizeof(amd::CopyMemoryCommand),
+    sizeof(amd::WriteMemoryCommand), sizeof(amd::FillMemoryCommand),
+    sizeof(amd::SvmCopyMemoryCommand)};
+static constexpr size_t NumSizes = sizeof(Sizes) / sizeof(Sizes[0]);
+static constexpr size_t Batch = 64;  // Objects in flight per thread
+
+// amd::Monitor requires a runtime thread object for the calling thread
+static void AttachThread() {
+  if (amd::Thread::current() == nullptr) {
+    new amd::HostThread();
+  }
+}
+
+class Heap {
+ public:
+  virtual ~Heap() {}
+  virtual void* Alloc(size_t size) = 0;
+  virtual void Free(void* ptr) = 0;
+};
+
+class SystemHeap : public Heap {
+ public:
+  void* Alloc(size_t size) override { return ::operator new(size); }
+  void Free(void* ptr) override { ::operator delete(ptr); }
+};
+
+class PoolHeap : public Heap {
+ public:
+  void* Alloc(size_t size) override { return pool_.Alloc(size); }
+  void Free(void* ptr) override { pool_.Free(ptr); }
+
+ private:
+  amd::SysmemPool pool_;
+};
+
+// Every thread allocates a batch of objects and releases them in the allocation order
+static void LocalThread(Heap& heap, size_t iterations, size_t seed) {
+  AttachThread();
+  void* objects[Batch];
+  for (size_t i = 0; i < iterations; ++i) {
+    for (size_t b = 0; b < Batch; ++b) {
+      objects[b] = heap.Alloc(Sizes[(seed + i + b) % NumSizes]);
+      *reinterpret_cast<uint64_t*>(objects[b]) = b;
+    }
+    for (size_t b = 0; b < Batch; ++b) {
+      heap.Free(objects[b]);
+    }
+  }
+}
+
+// The producer allocates objects and passes them to the consumer thread, which releases them
+static void CrossThread(Heap& heap, size_t count, size_t seed,
+                        amd::ConcurrentRingQueue<void*>& queue, bool producer) {
+  AttachThread();
+  for (size_t i = 0; i < count; ++i) {
+    if (producer) {
+      void* ptr = heap.Alloc(Sizes[(seed + i) % NumSizes]);
+      *reinterpret_cast<uint64_t*>(ptr) = i;
+      while (!queue.enqueue(ptr)) {
+        std::this_thread::yield();
+      }
+    } else {
+      void* ptr;
+      while ((ptr = queue.dequeue()) == nullptr) {
+        std::this_thread::yield();
+      }
+      heap.Free(ptr);
+    }
+  }
+}
+
+static double Run(Heap& heap, size_t numThreads, size_t count, bool cross) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  std::vector<amd::ConcurrentRingQueue<void*>*> queues;
+  for (size_t t = 0; t < numThreads; ++t) {
+    if (cross) {
+      auto queue = new amd::ConcurrentRingQueue<void*>(Batch);
+      queues.push_back(queue);
+      threads.emplace_back(CrossThread, std::ref(heap), count, t, std::ref(*queue), true);
+      threads.emplace_back(CrossThread, std::ref(heap), count, t, std::ref(*queue), false);
+    } else {
+      threads.emplace_back(LocalThread, std::ref(heap), count / Batch, t);
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto queue : queues) {
+    delete queue;
+  }
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  // Time per allocation and release pair in a thread
+  return sec * 1e9 / count;
+}
+
+int main(int argc, char** argv) {
+  size_t maxThreads = (argc > 1) ? strtoull(argv[1], nullptr, 0)
+                                 : std::thread::hardware_concurrency();
+  size_t count = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 4000000;
+  if ((maxThreads == 0) || (count < Batch)) {
+    printf("Usage: %s [max threads] [allocations per thread]\n", argv[0]);
+    return 1;
+  }
+
+  printf("Object sizes:");
+  for (size_t size : Sizes) {
+    printf(" %zu", size);
+  }
+  printf("\n");
+  for (bool cross : { false, true }) {
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+      SystemHeap system;
+      PoolHeap pool;
+      double systemNs = Run(system, threads, count, cross);
+      double poolNs = Run(pool, threads, count, cross);
+      printf("%-12s %2zu %s: system heap %6.1f ns, sysmem pool %6.1f ns per alloc/free\n",
+             cross ? "cross-thread" : "same thread", threads, cross ? "pairs  " : "threads",
+             systemNs, poolNs);
+    }
+  }
+  return 0;
+}
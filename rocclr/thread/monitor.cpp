@@ -22,12 +22,18 @@
 #include "thread/semaphore.hpp"
 #include "thread/thread.hpp"
 #include "utils/util.hpp"
+#include "utils/debug.hpp"
+#include "os/os.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
+#include <map>
+#include <string>
 #include <tuple>
 #include <utility>
 
+
 namespace amd {
 MonitorBase::~MonitorBase() {}
 
@@ -395,4 +401,208 @@ void Monitor::unlock() {
   finishUnlock();
 }
 } // namespace legacy_monitor
+
+#if defined(__linux__)
+namespace futex_monitor {
+
+// The registry isn't destroyed, since static monitors may outlive it
+static std::mutex& statsLock() {
+  static std::mutex* lock = new std::mutex();
+  return *lock;
+}
+
+static std::map<std::string, Stats*>& statsRegistry() {
+  static auto* registry = new std::map<std::string, Stats*>();
+  return *registry;
+}
+
+Stats* Stats::get(const char* name) {
+  std::lock_guard<std::mutex> lock(statsLock());
+  Stats*& stats = statsRegistry()[name];
+  if (stats == nullptr) {
+    stats = new Stats();
+  }
+  return stats;
+}
+
+void Stats::print() {
+  std::lock_guard<std::mutex> lock(statsLock());
+  for (const auto& it : statsRegistry()) {
+    const Stats& stats = *it.second;
+    ClPrint(amd::LOG_INFO, amd::LOG_LOCK,
+            "Monitor \"%s\": acquisitions %llu, contended %llu, wait time %llu us",
+            it.first.c_str(), static_cast<unsigned long long>(stats.acquisitions_.load()),
+            static_cast<unsigned long long>(stats.contended_.load()),
+            static_cast<unsigned long long>(stats.waitTimeNs_.load() / 1000));
+  }
+}
+
+bool Stats::snapshot(const char* name, MonitorStats* stats) {
+  if (name == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(statsLock());
+  const auto it = statsRegistry().find(name);
+  if (it == statsRegistry().end()) {
+    return false;
+  }
+  *stats = { it->first, it->second->acquisitions_.load(), it->second->contended_.load(),
+             it->second->waitTimeNs_.load() };
+  return true;
+}
+
+void Stats::snapshot(std::vector<MonitorStats>& stats) {
+  std::lock_guard<std::mutex> lock(statsLock());
+  for (const auto& it : statsRegistry()) {
+    stats.push_back({ it.first, it.second->acquisitions_.load(), it.second->contended_.load(),
+                      it.second->waitTimeNs_.load() });
+  }
+}
+
+void Stats::reset() {
+  std::lock_guard<std::mutex> lock(statsLock());
+  for (const auto& it : statsRegistry()) {
+    it.second->acquisitions_ = 0;
+    it.second->contended_ = 0;
+    it.second->waitTimeNs_ = 0;
+  }
+}
+
+Monitor::Monitor(bool recursive, const char* name)
+    : state_(kUnlocked), waitSeq_(0), waiters_(0), spinIter_(kMinSpinIter), owner_(nullptr),
+      lockCount_(0), recursive_(recursive),
+      stats_((DEBUG_CLR_MONITOR_STATS && (name != nullptr)) ? Stats::get(name) : nullptr) {}
+
+bool Monitor::tryLock() {
+  Thread* thread = nullptr;
+  if (recursive_) {
+    thread = Thread::current();
+    if (owner_ == thread) {
+      // Recursive lock: increment the lock count and return.
+      ++lockCount_;
+      return true;
+    }
+  }
+
+  uint32_t state = kUnlocked;
+  if (unlikely(!state_.compare_exchange_strong(state, kLocked, std::memory_order_acquire,
+                                               std::memory_order_relaxed))) {
+    return false;
+  }
+
+  owner_ = thread;
+  lockCount_ = 1;
+  if (stats_ != nullptr) {
+    stats_->acquisitions_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+void Monitor::lock() {
+  if (unlikely(!tryLock())) {
+    // The lock is contended.
+    finishLock();
+  }
+}
+
+void Monitor::finishLock() {
+  uint64_t start = (stats_ != nullptr) ? Os::timeNanos() : 0;
+
+  // Spin for a while, since the owner may release the lock soon. Allow twice the recent
+  // average, so the estimate can grow if the hold times become longer
+  int32_t average = spinIter_.load(std::memory_order_relaxed);
+  int32_t maxSpin = std::min(kMaxSpinIter, 2 * average + kMinSpinIter);
+  int32_t spin = 0;
+  bool locked = false;
+  for (; spin < maxSpin; ++spin) {
+    Os::spinPause();
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    if ((state == kUnlocked) &&
+        state_.compare_exchange_weak(state, kLocked, std::memory_order_acquire,
+                                     std::memory_order_relaxed)) {
+      locked = true;
+      break;
+    }
+  }
+  // Update the estimate. If spinning didn't help, then move it towards the minimum,
+  // because the lock is held longer than a spin window
+  int32_t target = locked ? spin : kMinSpinIter;
+  spinIter_.store(average + (target - average) / 8, std::memory_order_relaxed);
+
+  if (!locked) {
+    // Mark the lock as contended and sleep until the owner releases it
+    uint32_t state = state_.exchange(kContended, std::memory_order_acquire);
+    while (state != kUnlocked) {
+      Os::waitOnAddress(&state_, kContended);
+      state = state_.exchange(kContended, std::memory_order_acquire);
+    }
+  }
+
+  owner_ = recursive_ ? Thread::current() : nullptr;
+  lockCount_ = 1;
+  if (stats_ != nullptr) {
+    stats_->acquisitions_.fetch_add(1, std::memory_order_relaxed);
+    stats_->contended_.fetch_add(1, std::memory_order_relaxed);
+    stats_->waitTimeNs_.fetch_add(Os::timeNanos() - start, std::memory_order_relaxed);
+  }
+}
+
+void Monitor::unlock() {
+  assert(state_.load(std::memory_order_relaxed) != kUnlocked && "invariant");
+
+  if (recursive_ && --lockCount_ > 0) {
+    // was a recursive lock case, simply return.
+    return;
+  }
+
+  owner_ = nullptr;
+  if (state_.exchange(kUnlocked, std::memory_order_release) == kContended) {
+    // Somebody may sleep on the lock
+    Os::wakeOnAddress(&state_, false);
+  }
+}
+
+void Monitor::wait() {
+  assert(state_.load(std::memory_order_relaxed) != kUnlocked && "just checking");
+
+  // The sequence is read under the lock, so a notify() can't be missed
+  uint32_t seq = waitSeq_.load(std::memory_order_relaxed);
+  waiters_.fetch_add(1, std::memory_order_relaxed);
+
+  // Preserve the lock count (for recursive mutexes)
+  uint32_t lockCount = lockCount_;
+  lockCount_ = 1;
+
+  // Release the lock and go to sleep.
+  unlock();
+  while (waitSeq_.load(std::memory_order_acquire) == seq) {
+    Os::waitOnAddress(&waitSeq_, seq);
+  }
+
+  lock();
+  waiters_.fetch_sub(1, std::memory_order_relaxed);
+
+  // Restore the lock count (for recursive mutexes)
+  lockCount_ = lockCount;
+}
+
+void Monitor::notify() {
+  assert(state_.load(std::memory_order_relaxed) != kUnlocked && "just checking");
+  // Skip the system call if nobody waits
+  if (waiters_.load(std::memory_order_relaxed) != 0) {
+    waitSeq_.fetch_add(1, std::memory_order_release);
+    Os::wakeOnAddress(&waitSeq_, false);
+  }
+}
+
+void Monitor::notifyAll() {
+  assert(state_.load(std::memory_order_relaxed) != kUnlocked && "just checking");
+  if (waiters_.load(std::memory_order_relaxed) != 0) {
+    waitSeq_.fetch_add(1, std::memory_order_release);
+    Os::wakeOnAddress(&waitSeq_, true);
+  }
+}
+
+} // namespace futex_monitor
+#endif // defined(__linux__)
 }  // namespace amd
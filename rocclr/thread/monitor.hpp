@@ -28,8 +28,10 @@
 #include <condition_variable>
 #include <mutex>
 #include <atomic>
+#include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace amd {
 
@@ -239,10 +241,114 @@ class Monitor final: public HeapObject, public MonitorBase {
 };
 } // namespace mutex_monitor
 
+//! Contention statistics snapshot of all monitors with the same name
+struct MonitorStats {
+  std::string name_;        //!< The monitor name
+  uint64_t acquisitions_;   //!< Total number of lock acquisitions
+  uint64_t contended_;      //!< Acquisitions, which didn't succeed immediately
+  uint64_t waitTimeNs_;     //!< Total time spent in contended acquisitions
+};
+
+#if defined(__linux__)
+namespace futex_monitor {
+//! Contention statistics, accumulated for all monitors with the same name
+struct Stats {
+  std::atomic<uint64_t> acquisitions_{0};  //!< Total number of lock acquisitions
+  std::atomic<uint64_t> contended_{0};     //!< Acquisitions, which didn't succeed immediately
+  std::atomic<uint64_t> waitTimeNs_{0};    //!< Total time spent in contended acquisitions
+
+  //! Returns the statistics record for the named monitor
+  static Stats* get(const char* name);
+
+  //! Prints statistics of all named monitors into the log
+  static void print();
+
+  //! Returns a snapshot of statistics of the named monitor, false if it isn't registered
+  static bool snapshot(const char* name, MonitorStats* stats);
+
+  //! Returns a snapshot of statistics of all named monitors
+  static void snapshot(std::vector<MonitorStats>& stats);
+
+  //! Resets statistics of all named monitors
+  static void reset();
+};
+
+class Monitor final: public HeapObject, public MonitorBase {
+ private:
+  static constexpr uint32_t kUnlocked = 0;   //!< The lock is free
+  static constexpr uint32_t kLocked = 1;     //!< The lock is owned, no sleeping contenders
+  static constexpr uint32_t kContended = 2;  //!< The lock is owned, contenders may sleep
+
+  static constexpr int32_t kMinSpinIter = 16;    //!< Min spin iterations before sleep
+  static constexpr int32_t kMaxSpinIter = 2048;  //!< Max spin iterations before sleep
+
+  std::atomic<uint32_t> state_;     //!< The lock word, used as the futex for lock()
+  std::atomic<uint32_t> waitSeq_;   //!< The wait sequence, used as the futex for wait()
+  std::atomic<uint32_t> waiters_;   //!< The number of threads in wait()
+  //! Running average of spin iterations, which were required to get the lock.
+  //! It follows the recent hold times of the lock, so short critical sections spin longer
+  //! before the thread goes to sleep and long critical sections sleep almost immediately.
+  std::atomic<int32_t> spinIter_;
+  Thread* volatile owner_;          //!< Thread owning this monitor (recursive mode only)
+  uint32_t lockCount_;              //!< The amount of times this monitor was acquired by the owner
+  const bool recursive_;            //!< True if this is a recursive mutex, false otherwise
+  Stats* stats_;                    //!< Contention statistics, if enabled
+
+  //! Finish locking the mutex (contended case).
+  void finishLock();
+
+ public:
+  explicit Monitor(bool recursive = false, const char* name = nullptr);
+  ~Monitor() {}
+
+  //! Try to acquire the lock, return true if successful.
+  bool tryLock();
+
+  //! Acquire the lock or suspend the calling thread.
+  void lock();
+
+  //! Release the lock and wake a single waiting thread if any.
+  void unlock();
+
+  /*! \brief Give up the lock and go to sleep.
+   *
+   *  Calling wait() causes the current thread to go to sleep until
+   *  another thread calls notify()/notifyAll().
+   *
+   *  \note The monitor must be owned before calling wait().
+   */
+  void wait();
+
+  /*! \brief Wake up a single thread waiting on this monitor.
+   *
+   *  \note The monitor must be owned before calling notify().
+   */
+  void notify();
+
+  /*! \brief Wake up all threads that are waiting on this monitor.
+   *
+   *  \note The monitor must be owned before calling notifyAll().
+   */
+  void notifyAll();
+};
+} // namespace futex_monitor
+#endif // defined(__linux__)
+
 // Monitor API wrapper to user
 class Monitor {
 public:
-  explicit Monitor(bool recursive = false) {
+  explicit Monitor(bool recursive = false) : Monitor(nullptr, recursive) {}
+
+  //! Named monitor. The name identifies the monitor in the contention statistics.
+  //! @note The recursive mode has no default, since a string literal alone converts to
+  //! Monitor(bool) and silently creates a recursive monitor
+  Monitor(const char* name, bool recursive) {
+#if defined(__linux__)
+    if (DEBUG_CLR_USE_FUTEX_IN_AMD_MONITOR) {
+      monitor_ = new futex_monitor::Monitor(recursive, name);
+      return;
+    }
+#endif // defined(__linux__)
     if (DEBUG_CLR_USE_STDMUTEX_IN_AMD_MONITOR) {
       monitor_ = new mutex_monitor::Monitor(recursive);
     }
@@ -250,6 +356,7 @@ public:
       monitor_ = new legacy_monitor::Monitor(recursive);
     }
   }
+  Monitor(const char* name) = delete;
   inline ~Monitor() { delete monitor_; };
   inline bool tryLock() { return monitor_->tryLock(); }
   inline void lock() { monitor_->lock(); }
@@ -258,6 +365,41 @@ public:
   inline void notify() { monitor_->notify(); }
   inline void notifyAll() { monitor_->notifyAll(); }
 
+  //! Prints contention statistics of the named monitors into the log
+  static void PrintStats() {
+#if defined(__linux__)
+    futex_monitor::Stats::print();
+#endif // defined(__linux__)
+  }
+
+  //! Returns contention statistics of the monitors with the name, collected since the start
+  //! or the last reset. Returns false if no such monitor was created with
+  //! DEBUG_CLR_MONITOR_STATS and DEBUG_CLR_USE_FUTEX_IN_AMD_MONITOR enabled
+  static bool GetStats(const char* name, MonitorStats* stats) {
+#if defined(__linux__)
+    return futex_monitor::Stats::snapshot(name, stats);
+#else
+    return false;
+#endif // defined(__linux__)
+  }
+
+  //! Returns contention statistics of all named monitors, the list is empty if
+  //! DEBUG_CLR_MONITOR_STATS is disabled
+  static void GetStats(std::vector<MonitorStats>& stats) {
+    stats.clear();
+#if defined(__linux__)
+    futex_monitor::Stats::snapshot(stats);
+#endif // defined(__linux__)
+  }
+
+  //! Resets contention statistics of the named monitors, so the following queries
+  //! report a specific part of the application only
+  static void ResetStats() {
+#if defined(__linux__)
+    futex_monitor::Stats::reset();
+#endif // defined(__linux__)
+  }
+
 private:
   MonitorBase* monitor_;
 };
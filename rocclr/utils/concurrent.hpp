@@ -23,7 +23,9 @@
 
 #include "top.hpp"
 #include "os/alloc.hpp"
+#include "utils/util.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <new>
 
@@ -111,6 +113,51 @@ template <typename T, int N = 5> class ConcurrentLinkedQueue : public HeapObject
   inline bool empty();
 };
 
+/*! \brief A bounded thread-safe queue.
+ *
+ * Multi-producer/multi-consumer ring buffer, which orders elements first-in-first-out.
+ * It is based on the bounded MPMC queue by Dmitry Vyukov: every cell carries a sequence
+ * number, so producers and consumers synchronize on the cell only and never on a shared node.
+ * The head and tail counters live on separate cache lines to avoid false sharing between
+ * producers and the consumer.
+ */
+template <typename T> class ConcurrentRingQueue : public HeapObject {
+  static constexpr size_t kCacheLineSize = 64;
+
+  //! A ring buffer cell
+  struct Cell {
+    std::atomic<size_t> sequence_;  //!< Cell sequence number
+    T value_;                       //!< The value stored in that cell
+  };
+
+  Cell* buffer_;          //!< The ring buffer
+  const size_t mask_;     //!< Capacity - 1 for the index wrap around
+  alignas(kCacheLineSize) std::atomic<size_t> tail_;  //!< Enqueue position
+  alignas(kCacheLineSize) std::atomic<size_t> head_;  //!< Dequeue position
+
+ public:
+  //! \brief Initialize a new ring queue. The capacity is rounded up to the power of 2.
+  explicit ConcurrentRingQueue(size_t capacity);
+
+  //! \brief Destroy this ring queue.
+  ~ConcurrentRingQueue();
+
+  //! \brief Enqueue an element to this queue. Returns false if the queue is full.
+  inline bool enqueue(T elem);
+
+  //! \brief Dequeue an element from this queue. Returns NULL if the queue is empty.
+  inline T dequeue();
+
+  //! \brief Dequeue up to \a count elements into \a elems. Returns the number of elements.
+  inline size_t dequeue(T* elems, size_t count);
+
+  //! \brief Check if queue is empty
+  inline bool empty() const;
+
+  //! \brief Return the queue capacity
+  size_t capacity() const { return mask_ + 1; }
+};
+
 /*@}*/
 
 template <typename T, int N> inline ConcurrentLinkedQueue<T, N>::ConcurrentLinkedQueue() {
@@ -204,6 +251,107 @@ template <typename T, int N> inline bool ConcurrentLinkedQueue<T, N>::empty() {
   }
 }
 
+template <typename T>
+inline ConcurrentRingQueue<T>::ConcurrentRingQueue(size_t capacity)
+    : mask_(nextPowerOfTwo(std::max(capacity, static_cast<size_t>(2))) - 1),
+      tail_(0), head_(0) {
+  buffer_ = reinterpret_cast<Cell*>(
+      AlignedMemory::allocate(sizeof(Cell) * (mask_ + 1), kCacheLineSize));
+  for (size_t i = 0; i <= mask_; ++i) {
+    new (&buffer_[i]) Cell();
+    buffer_[i].sequence_.store(i, std::memory_order_relaxed);
+  }
+
+  // Make sure the instance is fully initialized before it becomes
+  // globally visible.
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+template <typename T> inline ConcurrentRingQueue<T>::~ConcurrentRingQueue() {
+  for (size_t i = 0; i <= mask_; ++i) {
+    buffer_[i].~Cell();
+  }
+  AlignedMemory::deallocate(buffer_);
+}
+
+template <typename T> inline bool ConcurrentRingQueue<T>::enqueue(T elem) {
+  size_t pos = tail_.load(std::memory_order_relaxed);
+  for (;;) {
+    Cell* cell = &buffer_[pos & mask_];
+    size_t seq = cell->sequence_.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      // The cell is free, try to claim it
+      if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        cell->value_ = elem;
+        cell->sequence_.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // The consumer didn't release the cell yet, hence the queue is full
+      return false;
+    } else {
+      pos = tail_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename T> inline T ConcurrentRingQueue<T>::dequeue() {
+  size_t pos = head_.load(std::memory_order_relaxed);
+  for (;;) {
+    Cell* cell = &buffer_[pos & mask_];
+    size_t seq = cell->sequence_.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+    if (diff == 0) {
+      // The cell is filled, try to claim it
+      if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        T value = cell->value_;
+        // Release the cell for the producers of the next round
+        cell->sequence_.store(pos + mask_ + 1, std::memory_order_release);
+        return value;
+      }
+    } else if (diff < 0) {
+      // The producer didn't fill the cell yet, hence the queue is empty
+      return NULL;
+    } else {
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename T> inline size_t ConcurrentRingQueue<T>::dequeue(T* elems, size_t count) {
+  size_t pos = head_.load(std::memory_order_relaxed);
+  for (;;) {
+    // Find the number of consecutive filled cells, starting from the current position
+    size_t ready = 0;
+    while (ready < count) {
+      const Cell& cell = buffer_[(pos + ready) & mask_];
+      if (cell.sequence_.load(std::memory_order_acquire) != (pos + ready + 1)) {
+        break;
+      }
+      ++ready;
+    }
+    if (ready == 0) {
+      return 0;
+    }
+    // Claim all filled cells at once
+    if (head_.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+      for (size_t i = 0; i < ready; ++i) {
+        Cell* cell = &buffer_[(pos + i) & mask_];
+        elems[i] = cell->value_;
+        cell->sequence_.store(pos + i + mask_ + 1, std::memory_order_release);
+      }
+      return ready;
+    }
+  }
+}
+
+template <typename T> inline bool ConcurrentRingQueue<T>::empty() const {
+  size_t pos = head_.load(std::memory_order_acquire);
+  const Cell& cell = buffer_[pos & mask_];
+  return cell.sequence_.load(std::memory_order_acquire) != (pos + 1);
+}
+
 }  // namespace amd
 
 #endif /*CONCURRENT_HPP_*/
@@ -202,6 +202,18 @@ release(bool, HIP_MEM_POOL_SUPPORT, true,                                     \
         "Enables memory pool support in HIP")                                 \
 release(bool, HIP_MEM_POOL_USE_VM, true,                                      \
         "Enables memory pool support in HIP")                                 \
+release(size_t, HIP_MEM_POOL_CHUNK_SIZE, 0,                                   \
+        "Chunk size for suballocation of small pool allocations. Off by"      \
+        " default. When set, ReservedMemCurrent and maxSize count whole"      \
+        " chunks, and MemObjMap tracks only the carved allocations")          \
+release(uint, HIP_MEM_POOL_TRIM_MODE, 0,                                      \
+        "Release of freed pool memory on sync: 0 - inline, 1 - background"    \
+        " worker, 2 - inline with the worker watermarks (deterministic)")     \
+release(size_t, HIP_MEM_POOL_TRIM_STEP, 64,                                   \
+        "Size in MBytes released per trim step. Also the distance from the"   \
+        " release threshold (low watermark) to the high watermark")           \
+release(uint, HIP_MEM_POOL_TRIM_INTERVAL, 2,                                  \
+        "Delay in ms between the trim steps of the background worker")        \
 release(bool, PAL_HIP_IPC_FLAG, true,                                         \
         "Enable interprocess flag for device allocation in PAL HIP")          \
 release(uint, PAL_FORCE_ASIC_REVISION, 0,                                     \
@@ -223,6 +235,11 @@ release(uint, ROC_AQL_QUEUE_SIZE, 16384,                                      \
         "AQL queue size in AQL packets")                                      \
 release(uint, ROC_SIGNAL_POOL_SIZE, 64,                                       \
         "Initial size of HSA signal pool")                                    \
+release(size_t, ROC_PINNED_MEMORY_CACHE_SIZE, 256,                            \
+        "Size in MBytes of the pinned host memory cache per queue")           \
+release(bool, ROC_PINNED_MEMORY_CACHE_PERSISTENT, false,                      \
+        "Keep the pinned host memory cache across flushes. Unsafe, if the "   \
+        "app frees host memory and reuses the address while the queue lives")\
 release(uint, DEBUG_CLR_LIMIT_BLIT_WG, 16,                                    \
         "Limit the number of workgroups in blit operations")                  \
 release(bool, DEBUG_CLR_BLIT_KERNARG_OPT, false,                              \
@@ -255,20 +272,51 @@ release(bool, DEBUG_HIP_FORCE_ASYNC_QUEUE, false,                             \
         "Forces grpahs into async queue mode. DEBUG_HIP_FORCE_GRAPH_QUEUES must be 1") \
 release(uint, DEBUG_HIP_FORCE_GRAPH_QUEUES, 4,                                \
         "Forces the number of streams for the graph parallel execution")      \
+release(bool, DEBUG_HIP_GRAPH_CRITICAL_PATH_SCHEDULE, false,                  \
+        "Schedules graph nodes on the streams by their critical path")        \
+release(bool, DEBUG_HIP_GRAPH_LAUNCH_FAST_PATH, false,                        \
+        "Tracks graph launches by their last command, not by host callbacks") \
+release(uint, DEBUG_HIP_GRAPH_OPT_PASSES, 0,                                  \
+        "Mask of graph optimizations at instantiate: 0x1 - empty nodes, "     \
+        "0x2 - memsets, 0x4 - copies, 0x8 - edges, 0x10 - host nodes. "       \
+        "Merged memsets and copies reject exec updates")                      \
 release(bool, HIP_ALWAYS_USE_NEW_COMGR_UNBUNDLING_ACTION, false,              \
         "Force to always use new comgr unbundling action")                    \
+release(bool, DEBUG_HIP_ZERO_COPY_UNBUNDLING, false,                          \
+        "Reference the code objects of uncompressed bundles in place, without"\
+        " the COMGR lookup, and prefetch their pages")                        \
+release(bool, DEBUG_HIP_LAZY_CODE_OBJECT_LOADING, false,                      \
+        "Extracts the code objects of a static fat binary on the first use "  \
+        "of its kernels or variables, instead of during the runtime init")    \
+release(uint, DEBUG_HIP_CODE_OBJECT_LOAD_THREADS, 1,                          \
+        "Number of threads extracting the fat binaries and building their"    \
+        " code objects for all devices with HIP_ENABLE_DEFERRED_LOADING=0,"   \
+        " 0 - up to the CPU count, 1 - serial on the calling thread")         \
 release(uint, DEBUG_HIP_BLOCK_SYNC, 50,                                       \
         "Blocks synchronization on CPU until the callback processing is done")\
 release(uint, DEBUG_CLR_MAX_BATCH_SIZE, 1000,                                 \
         "Forces the callback to clean-up CPU submission queue")               \
 release(bool, DEBUG_CLR_SYSMEM_POOL, false,                                   \
-        "Use sysmem pool implementation in runtime for amd commands")         \
+        "Use sysmem pool implementation in runtime for amd commands and "     \
+        "HIP events")                                                         \
 release(bool, DEBUG_HIP_KERNARG_COPY_OPT, true,                               \
         "Enable/Disable multiple kern arg copies")                            \
 release(bool, DEBUG_CLR_USE_STDMUTEX_IN_AMD_MONITOR, false,                   \
         "Use std::mutex in amd::monitor")                                     \
+release(bool, DEBUG_CLR_USE_FUTEX_IN_AMD_MONITOR, false,                      \
+        "Use futex based amd::monitor with adaptive spinning, Linux only")    \
+release(bool, DEBUG_CLR_MONITOR_STATS, false,                                 \
+        "Collect contention statistics of the named futex monitors, "         \
+        "printed with AMD_LOG_MASK=0x40 on shutdown or queried with "         \
+        "amd::Monitor::GetStats() at any time")                               \
+release(uint, DEBUG_CLR_HOST_QUEUE_RING_SIZE, 0,                              \
+        "Size of the bounded command ring in the host queue worker thread,"   \
+        " 0 - unbounded linked queue")                                        \
 release(bool, DEBUG_CLR_KERNARG_HDP_FLUSH_WA, false,                          \
         "Toggle kernel arg copy workaround")                                  \
+release(bool, DEBUG_CLR_KERNARG_SKIP_MEMOBJ_LOOKUP, false,                    \
+        "Skip the memory object lookup and retain of raw pointer kernel args,"\
+        " only applied when GPU_NUM_MEM_DEPENDENCY is 0")                     \
 release(uint, DEBUG_HIP_7_PREVIEW, 0,                                         \
         "Enables specific backward incompatible changes support before 7.0,"  \
         "using the mask. By default the changes are disabled and is set to 0")\